@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace my {
+
+/// @brief Bump allocator: hands out memory from big blocks and frees everything at once.
+///
+/// deallocate is a no-op, memory comes back only with release() or the arena destructor.
+/// Good for short lived containers that are built and thrown away together (e.g. per request).
+/// Optionally starts from a caller owned buffer (e.g. on the stack) before touching the heap.
+class monotonic_arena {
+ private:
+  struct Block {
+    Block* prev;
+    size_t size;
+  };
+
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
+  Block* blocks_ = nullptr;
+  std::byte* cur_ = nullptr;
+  std::byte* end_ = nullptr;
+  std::byte* initial_buffer_ = nullptr;
+  size_t initial_size_ = 0;
+  size_t initial_block_size_ = DEFAULT_BLOCK_SIZE;
+  size_t next_block_size_ = DEFAULT_BLOCK_SIZE;
+  size_t allocated_ = 0;
+
+  static std::byte* align_up(std::byte* p, size_t alignment) noexcept {
+    const auto addr = reinterpret_cast<uintptr_t>(p);
+    return p + ((alignment - addr % alignment) % alignment);
+  }
+
+  void grow(size_t bytes, size_t alignment) {
+    size_t size = next_block_size_;
+    while (size < sizeof(Block) + bytes + alignment) {
+      size *= 2;
+    }
+    auto* block = static_cast<Block*>(::operator new(size));
+    block->prev = blocks_;
+    block->size = size;
+    blocks_ = block;
+    cur_ = reinterpret_cast<std::byte*>(block + 1);
+    end_ = reinterpret_cast<std::byte*>(block) + size;
+    next_block_size_ = size * 2;
+  }
+
+ public:
+  explicit monotonic_arena(size_t initial_block_size = DEFAULT_BLOCK_SIZE) noexcept
+      : initial_block_size_(initial_block_size ? initial_block_size : DEFAULT_BLOCK_SIZE),
+        next_block_size_(initial_block_size_) {}
+
+  /// @brief The arena serves allocations from buffer first, the buffer must outlive the arena.
+  monotonic_arena(void* buffer, size_t size, size_t initial_block_size = DEFAULT_BLOCK_SIZE) noexcept
+      : cur_(static_cast<std::byte*>(buffer)),
+        end_(static_cast<std::byte*>(buffer) + size),
+        initial_buffer_(static_cast<std::byte*>(buffer)),
+        initial_size_(size),
+        initial_block_size_(initial_block_size ? initial_block_size : DEFAULT_BLOCK_SIZE),
+        next_block_size_(initial_block_size_) {}
+
+  monotonic_arena(const monotonic_arena&) = delete;
+  monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+  ~monotonic_arena() { release(); }
+
+  [[nodiscard]] void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    std::byte* p = align_up(cur_, alignment);
+    if (!cur_ || p + bytes > end_) {
+      grow(bytes, alignment);
+      p = align_up(cur_, alignment);
+    }
+    cur_ = p + bytes;
+    allocated_ += bytes;
+    return p;
+  }
+
+  void deallocate(void*, size_t) noexcept {}
+
+  /// @brief Frees all blocks at once, the arena can be reused afterwards.
+  void release() noexcept {
+    while (blocks_) {
+      Block* prev = blocks_->prev;
+      ::operator delete(blocks_);
+      blocks_ = prev;
+    }
+    cur_ = initial_buffer_;
+    end_ = initial_buffer_ ? initial_buffer_ + initial_size_ : nullptr;
+    next_block_size_ = initial_block_size_;
+    allocated_ = 0;
+  }
+
+  /// @return bytes handed out since construction or the last release()
+  size_t bytes_allocated() const noexcept { return allocated_; }
+};
+
+/// @brief Allocator adapter for my::monotonic_arena, all copies and rebinds share one arena.
+template <typename T>
+class arena_allocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+ private:
+  monotonic_arena* arena_;
+
+ public:
+  arena_allocator(monotonic_arena& arena) noexcept : arena_(&arena) {}
+
+  template <typename U>
+  arena_allocator(const arena_allocator<U>& other) noexcept : arena_(other.arena()) {}
+
+  [[nodiscard]] T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+
+  void deallocate(T*, size_t) noexcept {}
+
+  monotonic_arena* arena() const noexcept { return arena_; }
+
+  template <typename U>
+  friend bool operator==(const arena_allocator& lhs, const arena_allocator<U>& rhs) noexcept {
+    return lhs.arena() == rhs.arena();
+  }
+};
+namespace detail {
+
+/// @brief The pools behind a pool_allocator and all of its copies and rebinds: one free list of chunks per
+/// (size, alignment), so that list<T>, its nodes and any other rebind allocate from the same resource.
+template <size_t ChunksPerBlock>
+class chunk_pools {
+ public:
+  /// @brief Free list of chunks of one size, carved out of blocks of ChunksPerBlock chunks. A block starts with
+  /// the pointer to the previous block, a free chunk with the pointer to the next free one.
+  class pool {
+    friend class chunk_pools;
+
+    size_t size_;
+    size_t align_;
+    pool* next_pool_;
+    void* blocks_ = nullptr;
+    void* free_ = nullptr;
+    size_t in_use_ = 0;
+
+    static size_t round_up(size_t n, size_t align) noexcept { return (n + align - 1) / align * align; }
+
+    static void*& link(void* p) noexcept { return *static_cast<void**>(p); }
+
+    pool(size_t size, size_t align, pool* next) noexcept
+        : size_(round_up(std::max(size, sizeof(void*)), std::max(align, alignof(void*)))),
+          align_(std::max(align, alignof(void*))),
+          next_pool_(next) {}
+
+   public:
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
+
+    ~pool() {
+      while (blocks_) {
+        void* prev = link(blocks_);
+        ::operator delete(blocks_, std::align_val_t{align_});
+        blocks_ = prev;
+      }
+    }
+
+    void* get() {
+      if (!free_) {
+        const size_t header = round_up(sizeof(void*), align_);
+        void* raw = ::operator new(header + size_ * ChunksPerBlock, std::align_val_t{align_});
+        auto* block = static_cast<std::byte*>(raw);
+        link(block) = blocks_;
+        blocks_ = block;
+        for (size_t i = ChunksPerBlock; i > 0; --i) {
+          void* chunk = block + header + (i - 1) * size_;
+          link(chunk) = free_;
+          free_ = chunk;
+        }
+      }
+      void* chunk = free_;
+      free_ = link(chunk);
+      ++in_use_;
+      return chunk;
+    }
+
+    void put(void* p) noexcept {
+      link(p) = free_;
+      free_ = p;
+      --in_use_;
+    }
+
+    size_t in_use() const noexcept { return in_use_; }
+  };
+
+ private:
+  pool* pools_ = nullptr;  // a handful at most (T and the node types of one container), searched linearly
+
+ public:
+  chunk_pools() = default;
+  chunk_pools(const chunk_pools&) = delete;
+  chunk_pools& operator=(const chunk_pools&) = delete;
+
+  ~chunk_pools() {
+    while (pools_) {
+      pool* next = pools_->next_pool_;
+      delete pools_;
+      pools_ = next;
+    }
+  }
+
+  /// @return the pool for chunks of size bytes aligned to align, created on first use
+  pool& of(size_t size, size_t align) {
+    const pool wanted(size, align, nullptr);
+    for (pool* p = pools_; p; p = p->next_pool_) {
+      if (p->size_ == wanted.size_ && p->align_ == wanted.align_) return *p;
+    }
+    pools_ = new pool(size, align, pools_);
+    return *pools_;
+  }
+};
+
+}  // namespace detail
+
+/// @brief Fixed size chunk allocator for node based containers.
+///
+/// Single object allocations (n == 1) come from a free list carved out of blocks of ChunksPerBlock chunks,
+/// so erase-then-insert churn never reaches malloc. Array allocations (n > 1) go to operator new.
+/// Copies and rebinds share one set of pools, one per chunk size and alignment, and compare equal: a container
+/// that rebinds its allocator to its node type still hands back an allocator equal to the one it was given.
+/// The memory of the pools is returned when the last allocator sharing them is destroyed.
+template <typename T, size_t ChunksPerBlock = 256>
+class pool_allocator {
+  static_assert(ChunksPerBlock > 0, "ChunksPerBlock must be > 0");
+
+  template <typename, size_t>
+  friend class pool_allocator;
+
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = pool_allocator<U, ChunksPerBlock>;
+  };
+
+ private:
+  using pools = detail::chunk_pools<ChunksPerBlock>;
+
+  std::shared_ptr<pools> pools_;
+  typename pools::pool* pool_;  // the one for T in pools_
+
+  template <typename U>
+  bool shares_pools(const pool_allocator<U, ChunksPerBlock>& other) const noexcept {
+    return pools_ == other.pools_;
+  }
+
+ public:
+  pool_allocator() : pools_(std::make_shared<pools>()), pool_(&pools_->of(sizeof(T), alignof(T))) {}
+
+  pool_allocator(const pool_allocator&) noexcept = default;
+  pool_allocator& operator=(const pool_allocator&) noexcept = default;
+
+  /// moves copy: the source keeps sharing the pools and stays equal to the destination
+  pool_allocator(pool_allocator&& other) noexcept : pool_allocator(std::as_const(other)) {}
+  pool_allocator& operator=(pool_allocator&& other) noexcept { return *this = std::as_const(other); }
+
+  template <typename U>
+  pool_allocator(const pool_allocator<U, ChunksPerBlock>& other) noexcept
+      : pools_(other.pools_), pool_(&pools_->of(sizeof(T), alignof(T))) {}
+
+  [[nodiscard]] T* allocate(size_t n) {
+    if (n == 1) return static_cast<T*>(pool_->get());
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+  }
+
+  void deallocate(T* p, size_t n) noexcept {
+    if (n == 1) return pool_->put(p);
+    ::operator delete(p, std::align_val_t{alignof(T)});
+  }
+
+  /// @return number of chunks of T's pool handed out and not yet returned
+  size_t chunks_in_use() const noexcept { return pool_->in_use(); }
+
+  template <typename U>
+  friend bool operator==(const pool_allocator& lhs, const pool_allocator<U, ChunksPerBlock>& rhs) noexcept {
+    return lhs.shares_pools(rhs);
+  }
+};
+
+}  // namespace my
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <initializer_list>
 #include <ostream>
 #include <stdexcept>
 #include <type_traits>
 
+#include "mystd/simd.hpp"
+
 namespace my {
 
 template <typename T, size_t N>
@@ -89,42 +92,48 @@ class array {
 // non-memers functions
 
 template <typename T, size_t N>
-constexpr bool operator==(const array<T, N> lhs, const array<T, N> rhs) {
-  return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+constexpr bool operator==(const array<T, N>& lhs, const array<T, N>& rhs) {
+  if (std::is_constant_evaluated()) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+  return simd::equal(lhs.data(), rhs.data(), N);
 }
 
 template <typename T, size_t N>
-constexpr bool operator!=(const array<T, N> lhs, const array<T, N> rhs) {
+constexpr bool operator!=(const array<T, N>& lhs, const array<T, N>& rhs) {
   return !(lhs == rhs);
 }
 
 template <typename T, size_t N>
-constexpr bool operator<(const array<T, N> lhs, const array<T, N> rhs) {
-  return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+constexpr bool operator<(const array<T, N>& lhs, const array<T, N>& rhs) {
+  if (std::is_constant_evaluated()) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+  return simd::compare(lhs.data(), N, rhs.data(), N) < 0;
 }
 
 template <typename T, size_t N>
-constexpr bool operator>(const array<T, N> lhs, const array<T, N> rhs) {
+constexpr bool operator>(const array<T, N>& lhs, const array<T, N>& rhs) {
   return rhs < lhs;
 }
 
 template <typename T, size_t N>
-constexpr bool operator<=(const array<T, N> lhs, const array<T, N> rhs) {
+constexpr bool operator<=(const array<T, N>& lhs, const array<T, N>& rhs) {
   return !(rhs < lhs);
 }
 
 template <typename T, size_t N>
-constexpr bool operator>=(const array<T, N> lhs, const array<T, N> rhs) {
+constexpr bool operator>=(const array<T, N>& lhs, const array<T, N>& rhs) {
   return !(lhs < rhs);
 }
 
 template <typename T, size_t N>
-constexpr void swap(const array<T, N> lhs, const array<T, N> rhs) {
+constexpr void swap(array<T, N>& lhs, array<T, N>& rhs) {
   lhs.swap(rhs);
 }
 
 template <typename T, size_t N>
-std::ostream& operator<<(std::ostream& os, const array<T, N> arr) noexcept {
+std::ostream& operator<<(std::ostream& os, const array<T, N>& arr) {
   for (size_t i = 0; i < N; ++i) {
     os << arr[i];
     if (i != N - 1) {
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+namespace my {
+
+/// @brief Size the hot atomics of the concurrent containers are padded to, so that threads writing different
+/// counters do not share a cache line (false sharing).
+inline constexpr std::size_t cache_line_size = 64;
+
+/// @brief Tells the CPU that the thread is spinning on a shared location (pause on x86, yield on ARM),
+/// this saves power and lets the sibling hyperthread run.
+inline void cpu_relax() noexcept {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+  asm volatile("yield");
+#endif
+}
+
+}  // namespace my
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <tuple>
+#include <utility>
+
+#include "mystd/concurrency.hpp"
+#include "mystd/hashtable.hpp"
+
+namespace my {
+
+/// @brief Hash map shared by many threads: the keys are partitioned by hash into shards, each one a my::hashtable
+/// behind its own std::shared_mutex. Lookups lock their shard shared, so readers run in parallel, and a writer
+/// only contends with the threads that hit the same shard.
+///
+/// No reference or iterator escapes a lock: find returns a copy of the value, visit/cvisit call back on the
+/// element while its shard is locked. A callback must not call into the map again (same shard: deadlock).
+/// size() and the *_all visits lock one shard at a time, they do not see the whole map at a single instant.
+/// @tparam Hash -- picks the shard (top bits of the mixed hash) and the bucket inside the shard (the hash as is)
+template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          class Allocator = std::allocator<std::pair<const Key, Value>>>
+class concurrent_unordered_map {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = std::size_t;
+
+ private:
+  struct KeyOfValue {
+    const Key& operator()(const value_type& v) const noexcept { return v.first; }
+  };
+
+  using table_type = hashtable<value_type, Key, KeyOfValue, Hash, KeyEqual, InsertPolicy::UniqueKeys, Allocator>;
+
+  /// one cache line at least, so that the locks of neighbouring shards are not falsely shared
+  struct alignas(cache_line_size) shard {
+    mutable std::shared_mutex lock;
+    table_type table;
+  };
+
+  std::unique_ptr<shard[]> shards_;
+  size_type mask_;
+  int shift_;  // digits - log2(shard count)
+  Hash hasher_;
+
+  /// The top bits of the mixed hash: the middle bits correlate with hash % buckets inside the shard for small
+  /// integer keys (identity std::hash), which made chains ~5x longer.
+  shard& shard_of(const key_type& k) const {
+    return shards_[mask_ == 0 ? 0 : detail::mix_hash(hasher_(k)) >> shift_];
+  }
+
+ public:
+  /// @param shard_count -- rounded up to a power of two; a few times the number of threads keeps collisions rare
+  explicit concurrent_unordered_map(size_type shard_count = 64)
+      : shards_(std::make_unique<shard[]>(std::bit_ceil(std::max<size_type>(shard_count, 1)))),
+        mask_(std::bit_ceil(std::max<size_type>(shard_count, 1)) - 1),
+        shift_(std::numeric_limits<size_type>::digits - std::bit_width(mask_)) {}
+
+  concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+  concurrent_unordered_map& operator=(const concurrent_unordered_map&) = delete;
+
+  size_type shard_count() const noexcept { return mask_ + 1; }
+
+  // lookup
+
+  /// @return a copy of the value of k, std::nullopt if k is missing
+  std::optional<mapped_type> find(const key_type& k) const {
+    const shard& s = shard_of(k);
+    std::shared_lock lock(s.lock);
+    auto it = s.table.find(k);
+    if (it == s.table.end()) return std::nullopt;
+    return it->second;
+  }
+
+  bool contains(const key_type& k) const {
+    const shard& s = shard_of(k);
+    std::shared_lock lock(s.lock);
+    return s.table.contains(k);
+  }
+
+  /// @brief Calls f(const value_type&) on the element of k under the shared lock of its shard.
+  /// @return false if k is missing
+  template <class F>
+  bool cvisit(const key_type& k, F&& f) const {
+    const shard& s = shard_of(k);
+    std::shared_lock lock(s.lock);
+    auto it = s.table.find(k);
+    if (it == s.table.end()) return false;
+    f(*it);
+    return true;
+  }
+
+  /// @brief Calls f(value_type&) on the element of k under the exclusive lock of its shard: a read-modify-write
+  /// of the value is atomic.
+  /// @return false if k is missing
+  template <class F>
+  bool visit(const key_type& k, F&& f) {
+    shard& s = shard_of(k);
+    std::unique_lock lock(s.lock);
+    auto it = s.table.find(k);
+    if (it == s.table.end()) return false;
+    f(*it);
+    return true;
+  }
+
+  /// @brief Calls f(const value_type&) on every element, one shard at a time under its shared lock.
+  template <class F>
+  void cvisit_all(F&& f) const {
+    for (size_type i = 0; i <= mask_; ++i) {
+      std::shared_lock lock(shards_[i].lock);
+      for (const auto& v : shards_[i].table) {
+        f(v);
+      }
+    }
+  }
+
+  /// @brief Calls f(value_type&) on every element, one shard at a time under its exclusive lock.
+  template <class F>
+  void visit_all(F&& f) {
+    for (size_type i = 0; i <= mask_; ++i) {
+      std::unique_lock lock(shards_[i].lock);
+      for (auto& v : shards_[i].table) {
+        f(v);
+      }
+    }
+  }
+
+  // modifiers
+
+  /// @return true if k was inserted, false if the value of an existing k was assigned
+  template <class M>
+  bool insert_or_assign(const key_type& k, M&& value) {
+    shard& s = shard_of(k);
+    std::unique_lock lock(s.lock);
+    auto [it, inserted] = s.table.try_emplace(k, std::piecewise_construct, std::forward_as_tuple(k),
+                                              std::forward_as_tuple(std::forward<M>(value)));
+    if (!inserted) {
+      it->second = std::forward<M>(value);  // not moved from: try_emplace constructs only what it inserts
+    }
+    return inserted;
+  }
+
+  /// @brief Constructs the value from args only if k is missing.
+  /// @return true if k was inserted
+  template <class... Args>
+  bool try_emplace(const key_type& k, Args&&... args) {
+    shard& s = shard_of(k);
+    std::unique_lock lock(s.lock);
+    return s.table
+        .try_emplace(k, std::piecewise_construct, std::forward_as_tuple(k),
+                     std::forward_as_tuple(std::forward<Args>(args)...))
+        .second;
+  }
+
+  /// @return true if k was present
+  bool erase(const key_type& k) {
+    shard& s = shard_of(k);
+    std::unique_lock lock(s.lock);
+    const size_type before = s.table.size();
+    s.table.erase(k);
+    return s.table.size() != before;
+  }
+
+  void clear() {
+    for (size_type i = 0; i <= mask_; ++i) {
+      std::unique_lock lock(shards_[i].lock);
+      shards_[i].table.clear();
+    }
+  }
+
+  // capacity
+
+  /// @return the sum of the shard sizes, each read under its lock
+  size_type size() const {
+    size_type n = 0;
+    for (size_type i = 0; i <= mask_; ++i) {
+      std::shared_lock lock(shards_[i].lock);
+      n += shards_[i].table.size();
+    }
+    return n;
+  }
+
+  bool empty() const { return size() == 0; }
+};
+
+}  // namespace my
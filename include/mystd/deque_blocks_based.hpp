@@ -1,17 +1,42 @@
 #pragma once
 
+#include <algorithm>
+#include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace my::blocksbased {
 
-template <typename T, std::size_t BlockCapacity = 8>
+/// @brief Default block size: 512 bytes of elements, at least 8 elements (the libstdc++ choice).
+template <typename T>
+inline constexpr std::size_t default_block_capacity = std::max<std::size_t>(512 / sizeof(T), 8);
+
+/// @brief Deque on fixed size blocks addressed through a map of block pointers.
+///
+/// The map is an array of pointers to blocks, the used part [begin_block_, end_block_) is kept near its middle,
+/// so both ends can grow without moving elements. The elements occupy the absolute positions [start_, finish_),
+/// each end only updates its own counter. Element i lives at absolute position start_ + i, that is
+/// in block (start_ + i) / BlockCapacity at offset (start_ + i) % BlockCapacity, which makes indexing O(1).
+/// When one end of the map is reached the used part is recentered, the map doubles only if it is at least half
+/// full, so push at both ends is amortized O(1). Blocks hold raw storage, only the live range is constructed.
+///
+/// Blocks that become empty are kept in a small cache (up to MaxSpareBlocks) and reused by the next push that
+/// crosses a block boundary, so a queue hovering around a boundary does not allocate on every operation.
+/// @tparam Allocator -- element storage and the map are allocated with it (rebound for the map)
+/// @tparam MaxSpareBlocks -- how many empty blocks are cached, 0 disables the cache
+template <typename T, std::size_t BlockCapacity = default_block_capacity<T>, typename Allocator = std::allocator<T>,
+          std::size_t MaxSpareBlocks = 2>
 class deque {
   static_assert(BlockCapacity > 0, "BLOCK_SIZE must be > 0");
 
  public:
   using value_type = T;
+  using allocator_type = Allocator;
   using reference = value_type&;
   using const_reference = const value_type&;
   using pointer = value_type*;
@@ -19,36 +44,167 @@ class deque {
   using size_type = size_t;
 
  private:
-  struct Block {
-    T* data;
-    Block* prev;
-    Block* next;
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using map_allocator_type = typename alloc_traits::template rebind_alloc<pointer>;
+  using map_alloc_traits = std::allocator_traits<map_allocator_type>;
+
+  static constexpr size_type INITIAL_MAP_SIZE = 8;
+
+  allocator_type alloc_;
+  map_allocator_type map_alloc_{alloc_};
+  pointer* map_ = nullptr;
+  size_type map_size_ = 0;
+  size_type begin_block_ = 0;  // blocks [begin_block_, end_block_) of the map are allocated
+  size_type end_block_ = 0;
+  size_type start_ = 0;   // absolute position of the first element
+  size_type finish_ = 0;  // absolute position past the last element
+  pointer spare_[MaxSpareBlocks ? MaxSpareBlocks : 1];
+  size_type spare_count_ = 0;
+
+  pointer make_block() {
+    if (spare_count_) return spare_[--spare_count_];
+    return alloc_traits::allocate(alloc_, BlockCapacity);
+  }
 
-    Block() : data(new T[BlockCapacity]), prev(nullptr), next(nullptr) {}
-    ~Block() { delete[] data; }
-  };
+  void free_block(pointer block) noexcept {
+    if (spare_count_ < MaxSpareBlocks) {
+      spare_[spare_count_++] = block;
+    } else {
+      alloc_traits::deallocate(alloc_, block, BlockCapacity);
+    }
+  }
+
+  void release_spare_blocks() noexcept {
+    while (spare_count_) {
+      alloc_traits::deallocate(alloc_, spare_[--spare_count_], BlockCapacity);
+    }
+  }
+
+  /// @brief The map has one extra slot past map_size_, so iterators may load the slot after the last block.
+  /// Slots without a block are null.
+  pointer* allocate_map(size_type size) {
+    pointer* map = map_alloc_traits::allocate(map_alloc_, size + 1);
+    std::fill(map, map + size + 1, nullptr);
+    return map;
+  }
+
+  void deallocate_map() noexcept {
+    if (map_) map_alloc_traits::deallocate(map_alloc_, map_, map_size_ + 1);
+  }
 
-  Block* head_ = nullptr;
-  Block* tail_ = nullptr;
-  size_type head_index_ = BlockCapacity / 2;
-  size_type tail_index_ = BlockCapacity / 2;
-  size_type size_ = 0;
+  /// @brief Makes room for one more block at the front or at the back of the used part of the map.
+  ///
+  /// Recenters the used blocks inside the current map if it is less than half full, otherwise moves them
+  /// to the middle of a map twice as big. Element positions shift by whole blocks, start_ follows.
+  void reserve_map(bool at_front) {
+    const size_type used = end_block_ - begin_block_;
+    if (at_front ? begin_block_ > 0 : end_block_ < map_size_) return;
+
+    size_type new_begin;
+    if (used * 2 < map_size_) {
+      new_begin = (map_size_ - used) / 2;
+      if (new_begin < begin_block_) {
+        std::copy(map_ + begin_block_, map_ + end_block_, map_ + new_begin);
+        std::fill(map_ + std::max(new_begin + used, begin_block_), map_ + end_block_, nullptr);
+      } else {
+        std::copy_backward(map_ + begin_block_, map_ + end_block_, map_ + new_begin + used);
+        std::fill(map_ + begin_block_, map_ + std::min(new_begin, end_block_), nullptr);
+      }
+    } else {
+      const size_type new_size = map_size_ ? map_size_ * 2 : INITIAL_MAP_SIZE;
+      pointer* new_map = allocate_map(new_size);
+      new_begin = (new_size - used) / 2;
+      std::copy(map_ + begin_block_, map_ + end_block_, new_map + new_begin);
+      deallocate_map();
+      map_ = new_map;
+      map_size_ = new_size;
+    }
+    start_ = start_ - begin_block_ * BlockCapacity + new_begin * BlockCapacity;
+    finish_ = finish_ - begin_block_ * BlockCapacity + new_begin * BlockCapacity;
+    begin_block_ = new_begin;
+    end_block_ = new_begin + used;
+  }
 
-  Block* make_block() { return new Block(); }
+  /// @brief The first element of an empty deque goes to the middle of a block in the middle of the map.
+  void init_first_block() {
+    if (!map_) reserve_map(false);
+    const size_type center = map_size_ / 2;
+    map_[center] = make_block();
+    begin_block_ = center;
+    end_block_ = center + 1;
+    start_ = finish_ = center * BlockCapacity + BlockCapacity / 2;
+  }
 
-  // it is o(n) now
-  // TODO save pointers to blocks and got O(1)
-  reference element_access(size_type pos) const {
-    size_type block_index = (pos + head_index_) / BlockCapacity;  // add offset for head_index_ in first block
-    size_type room_index = (pos + head_index_) % BlockCapacity;
+  /// @brief Copies count elements of it into the raw storage at dst through the allocator, destroying the ones
+  /// already built if a constructor throws. With std::allocator this is uninitialized_copy_n.
+  /// @return the iterator past the last copied element
+  template <typename It>
+  It construct_n(It it, size_type count, pointer dst) {
+    if constexpr (std::is_same_v<Allocator, std::allocator<T>>) {
+      return std::ranges::uninitialized_copy_n(std::move(it), count, dst, dst + count).in;
+    } else {
+      size_type i = 0;
+      try {
+        for (; i < count; ++i, ++it) {
+          alloc_traits::construct(alloc_, dst + i, *it);
+        }
+      } catch (...) {
+        for (; i > 0; --i) {
+          alloc_traits::destroy(alloc_, dst + i - 1);
+        }
+        throw;
+      }
+      return it;
+    }
+  }
 
-    Block* cur = head_;
-    for (size_t i = 0; i < block_index; ++i) {
-      cur = cur->next;
+  /// @brief Constructs the element first, a new block is linked only after that succeeded.
+  template <typename... Args>
+  void construct_front(Args&&... args) {
+    if (begin_block_ == end_block_) init_first_block();
+    if (start_ == begin_block_ * BlockCapacity) {
+      reserve_map(true);
+      pointer block = make_block();
+      try {
+        alloc_traits::construct(alloc_, block + BlockCapacity - 1, std::forward<Args>(args)...);
+      } catch (...) {
+        free_block(block);
+        throw;
+      }
+      map_[--begin_block_] = block;
+    } else {
+      alloc_traits::construct(alloc_, slot(start_ - 1), std::forward<Args>(args)...);
     }
-    return cur->data[room_index];
+    --start_;
   }
 
+  template <typename... Args>
+  void construct_back(Args&&... args) {
+    if (begin_block_ == end_block_) init_first_block();
+    const size_type pos = finish_;
+    if (pos == end_block_ * BlockCapacity) {
+      reserve_map(false);
+      pointer block = make_block();
+      try {
+        alloc_traits::construct(alloc_, block, std::forward<Args>(args)...);
+      } catch (...) {
+        free_block(block);
+        throw;
+      }
+      map_[end_block_++] = block;
+    } else {
+      alloc_traits::construct(alloc_, slot(pos), std::forward<Args>(args)...);
+    }
+    ++finish_;
+  }
+
+  /// @return storage for the absolute position pos
+  pointer slot(size_type pos) const noexcept { return map_[pos / BlockCapacity] + pos % BlockCapacity; }
+
+  reference element_access(size_type pos) const noexcept { return *slot(start_ + pos); }
+
+  /// @brief Keeps the map slot, the block pointer and the offset in the block: ++ and * do not touch the deque.
+  /// Invalidated when the map is reallocated or recentered (any push), like std::deque iterators.
   template <bool IsConst>
   class iterator_basic {
    public:
@@ -58,36 +214,57 @@ class deque {
     using pointer = std::conditional_t<IsConst, const T*, T*>;
     using reference = std::conditional_t<IsConst, const T&, T&>;
 
-    iterator_basic(deque* d = nullptr, std::size_t index = 0) : d_(d), index_(index) {};
+    static constexpr difference_type BLOCK = static_cast<difference_type>(BlockCapacity);
+
+    iterator_basic() = default;
+
+    iterator_basic(T* const* node, size_type offset) : node_(node), block_(*node), offset_(offset) {}
 
-    reference operator*() const { return (*d_)[index_]; }
+    reference operator*() const { return block_[offset_]; }
 
-    pointer operator->() const { return &(**this); }
+    pointer operator->() const { return block_ + offset_; }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
 
     iterator_basic& operator++() {
-      ++index_;
+      if (++offset_ == BlockCapacity) {
+        offset_ = 0;
+        block_ = *++node_;
+      }
       return *this;
     }
 
     iterator_basic operator++(int) {
-      deque tmp = *this;
+      auto tmp = *this;
       ++(*this);
       return tmp;
     }
 
     iterator_basic& operator--() {
-      --index_;
+      if (offset_ == 0) {
+        offset_ = BlockCapacity;
+        block_ = *--node_;
+      }
+      --offset_;
       return *this;
     }
 
     iterator_basic operator--(int) {
       auto tmp = *this;
-      --index_;
+      --(*this);
       return tmp;
     }
 
     iterator_basic& operator+=(difference_type n) {
-      index_ += n;
+      const difference_type offset = static_cast<difference_type>(offset_) + n;
+      if (offset >= 0 && offset < BLOCK) {
+        offset_ = static_cast<size_type>(offset);
+        return *this;
+      }
+      const difference_type blocks = offset >= 0 ? offset / BLOCK : -((-offset - 1) / BLOCK) - 1;
+      node_ += blocks;
+      block_ = *node_;
+      offset_ = static_cast<size_type>(offset - blocks * BLOCK);
       return *this;
     }
 
@@ -96,26 +273,25 @@ class deque {
       return tmp += n;
     }
 
-    iterator_basic& operator-=(difference_type n) {
-      index_ -= n;
-      return *this;
-    }
+    iterator_basic& operator-=(difference_type n) { return *this += -n; }
 
     iterator_basic operator-(difference_type n) const {
       auto tmp = *this;
       return tmp -= n;
     }
 
-    // TODO test it very well!
     difference_type operator-(const iterator_basic& other) const {
-      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+      return (node_ - other.node_) * BLOCK + static_cast<difference_type>(offset_) -
+             static_cast<difference_type>(other.offset_);
     }
 
-    bool operator==(const iterator_basic& other) const { return index_ == other.index_ && d_ == other.d_; }
+    bool operator==(const iterator_basic& other) const { return node_ == other.node_ && offset_ == other.offset_; }
 
     bool operator!=(const iterator_basic& other) const { return !(*this == other); }
 
-    bool operator<(const iterator_basic& other) const { return index_ < other.index_; }
+    bool operator<(const iterator_basic& other) const {
+      return node_ < other.node_ || (node_ == other.node_ && offset_ < other.offset_);
+    }
 
     bool operator>(const iterator_basic& other) const { return other < *this; }
 
@@ -124,8 +300,96 @@ class deque {
     bool operator>=(const iterator_basic& other) const { return !(*this < other); }
 
    private:
-    deque* d_;
-    std::size_t index_;
+    T* const* node_ = nullptr;
+    T* block_ = nullptr;
+    size_type offset_ = 0;
+  };
+
+  /// @return iterator to the absolute position pos, a deque that never allocated gives null iterators
+  template <typename Iterator>
+  Iterator make_iterator(size_type pos) const {
+    if (!map_) return Iterator();
+    return Iterator(map_ + pos / BlockCapacity, pos % BlockCapacity);
+  }
+
+  /// @brief Frees the blocks at both ends that hold no element (left behind when a bulk insert throws).
+  void trim_blocks() {
+    if (start_ == finish_) return clear();
+    while (start_ >= (begin_block_ + 1) * BlockCapacity) {
+      free_block(std::exchange(map_[begin_block_++], nullptr));
+    }
+    while (finish_ <= (end_block_ - 1) * BlockCapacity) {
+      free_block(std::exchange(map_[--end_block_], nullptr));
+    }
+  }
+
+  /// @brief Forward range over the contiguous pieces of the deque. Each std::span covers a block, or a run of
+  /// blocks that happen to be adjacent in memory (e.g. consecutive blocks from an arena), so there are at most
+  /// size / BlockCapacity + 2 of them.
+  template <bool IsConst>
+  class segments_view {
+    using element_type = std::conditional_t<IsConst, const T, T>;
+
+   public:
+    class segment_iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::span<element_type>;
+      using difference_type = std::ptrdiff_t;
+
+      segment_iterator() = default;
+
+      segment_iterator(T* const* map, size_type pos, size_type last) : map_(map), pos_(pos), last_(last) {}
+
+      value_type operator*() const {
+        return value_type(map_[pos_ / BlockCapacity] + pos_ % BlockCapacity, run_end() - pos_);
+      }
+
+      segment_iterator& operator++() {
+        pos_ = run_end();
+        return *this;
+      }
+
+      segment_iterator operator++(int) {
+        auto tmp = *this;
+        ++(*this);
+        return tmp;
+      }
+
+      bool operator==(const segment_iterator& other) const { return pos_ == other.pos_; }
+
+      bool operator!=(const segment_iterator& other) const { return !(*this == other); }
+
+     private:
+      /// @return absolute position past the run of memory adjacent blocks that starts at the block of pos_
+      size_type run_end() const noexcept {
+        size_type block = pos_ / BlockCapacity;
+        while ((block + 1) * BlockCapacity < last_ && map_[block + 1] == map_[block] + BlockCapacity) {
+          ++block;
+        }
+        return std::min((block + 1) * BlockCapacity, last_);
+      }
+
+      T* const* map_ = nullptr;
+      size_type pos_ = 0;
+      size_type last_ = 0;
+    };
+
+    segments_view(T* const* map, size_type first, size_type last) : map_(map), first_(first), last_(last) {}
+
+    segment_iterator begin() const { return segment_iterator(map_, first_, last_); }
+
+    segment_iterator end() const { return segment_iterator(map_, last_, last_); }
+
+    /// @return number of segments, O(number of blocks)
+    size_type size() const noexcept { return static_cast<size_type>(std::distance(begin(), end())); }
+
+    bool empty() const noexcept { return first_ == last_; }
+
+   private:
+    T* const* map_;
+    size_type first_;
+    size_type last_;
   };
 
  public:
@@ -133,12 +397,16 @@ class deque {
   using const_iterator = iterator_basic<true>;
   using reverse_iterator = std::reverse_iterator<iterator>;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using segments_type = segments_view<false>;
+  using const_segments_type = segments_view<true>;
 
   // ctor
 
   deque() = default;
 
-  deque(std::initializer_list<value_type> init) {
+  explicit deque(const allocator_type& alloc) : alloc_(alloc) {}
+
+  deque(std::initializer_list<value_type> init, const allocator_type& alloc = allocator_type()) : alloc_(alloc) {
     for (const auto& value : init) {
       push_back(value);
     }
@@ -146,7 +414,7 @@ class deque {
 
   // copy
 
-  deque(const deque& other) {
+  deque(const deque& other) : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
     for (size_t i = 0; i < other.size(); ++i) {
       push_back(other.at(i));
     }
@@ -161,14 +429,20 @@ class deque {
     return *this;
   }
 
-  // move
+  // move, the allocator is copied so the moved-from deque can still allocate
 
   deque(deque&& other)
-      : head_(std::exchange(other.head_, nullptr)),
-        tail_(std::exchange(other.tail_, nullptr)),
-        head_index_(std::exchange(other.head_index_, 0)),
-        tail_index_(std::exchange(other.tail_index_, 0)),
-        size_(std::exchange(other.size_, 0)) {}
+      : alloc_(other.alloc_),
+        map_alloc_(other.map_alloc_),
+        map_(std::exchange(other.map_, nullptr)),
+        map_size_(std::exchange(other.map_size_, 0)),
+        begin_block_(std::exchange(other.begin_block_, 0)),
+        end_block_(std::exchange(other.end_block_, 0)),
+        start_(std::exchange(other.start_, 0)),
+        finish_(std::exchange(other.finish_, 0)),
+        spare_count_(std::exchange(other.spare_count_, 0)) {
+    std::copy(other.spare_, other.spare_ + spare_count_, spare_);
+  }
 
   deque& operator=(deque&& other) {
     if (this != &other) {
@@ -178,13 +452,19 @@ class deque {
     return *this;
   }
 
-  ~deque() { clear(); }
+  ~deque() {
+    clear();
+    release_spare_blocks();
+    deallocate_map();
+  }
+
+  allocator_type get_allocator() const noexcept { return alloc_; }
 
   // capacity
 
-  bool empty() const noexcept { return size_ == 0; }
+  bool empty() const noexcept { return start_ == finish_; }
 
-  size_type size() const noexcept { return size_; }
+  size_type size() const noexcept { return finish_ - start_; }
 
   // observers
 
@@ -193,103 +473,138 @@ class deque {
   const_reference operator[](size_type pos) const noexcept { return element_access(pos); }
 
   reference at(size_type pos) {
-    if (pos >= size_) {
+    if (pos >= size()) {
       throw std::out_of_range("deque::at() calls for out of range element");
     }
     return (*this)[pos];
   }
 
   const_reference at(size_type pos) const {
-    if (pos >= size_) {
+    if (pos >= size()) {
       throw std::out_of_range("deque::at() calls for out of range element");
     }
     return (*this)[pos];
   }
 
-  reference front() { return head_->data[head_index_]; }
+  reference front() { return element_access(0); }
 
-  const_reference front() const { return head_->data[head_index_]; }
+  const_reference front() const { return element_access(0); }
 
-  reference back() { return tail_->data[tail_index_ - 1]; }
+  reference back() { return *slot(finish_ - 1); }
 
-  const_reference back() const { return tail_->data[tail_index_ - 1]; }
+  const_reference back() const { return *slot(finish_ - 1); }
 
   // modifiers
 
-  void push_front(const_reference value) {
-    if (!head_) {
-      head_ = tail_ = make_block();
-    }
-    if (head_index_ == 0) {
-      Block* block = make_block();
-      block->next = head_;
-      head_->prev = block;
-      head_ = block;
-      head_index_ = BlockCapacity;
+  void push_front(const_reference value) { construct_front(value); }
+
+  void push_back(const_reference value) { construct_back(value); }
+
+  /// @brief Appends the elements of rg. A forward range is copied block by block through the allocator
+  /// (with std::allocator a memmove per block for trivially copyable T from a contiguous source).
+  /// If an element constructor throws, the elements appended before it stay.
+  template <typename Range>
+  void append_range(Range&& rg) {
+    if constexpr (std::ranges::forward_range<Range>) {
+      auto n = static_cast<size_type>(std::ranges::distance(rg));
+      if (n == 0) return;
+      if (begin_block_ == end_block_) init_first_block();
+      auto it = std::ranges::begin(rg);
+      try {
+        while (n) {
+          if (finish_ == end_block_ * BlockCapacity) {
+            reserve_map(false);
+            pointer block = make_block();
+            map_[end_block_++] = block;
+          }
+          const size_type count = std::min(n, BlockCapacity - finish_ % BlockCapacity);
+          pointer dst = slot(finish_);
+          it = construct_n(std::move(it), count, dst);
+          finish_ += count;
+          n -= count;
+        }
+      } catch (...) {
+        trim_blocks();
+        throw;
+      }
+    } else {
+      for (auto&& value : rg) {
+        construct_back(std::forward<decltype(value)>(value));
+      }
     }
-    --head_index_;
-    head_->data[head_index_] = value;
-    ++size_;
   }
 
-  void push_back(const_reference value) {
-    if (!tail_) {
-      head_ = tail_ = make_block();
-    }
-    if (tail_index_ == BlockCapacity) {
-      Block* block = make_block();
-      block->prev = tail_;
-      tail_->next = block;
-      tail_ = block;
-      tail_index_ = 0;
+  /// @brief Inserts the elements of rg in front, keeping their order. All blocks are taken first,
+  /// then filled block by block. If an element constructor throws, the deque is left unchanged.
+  template <typename Range>
+  void prepend_range(Range&& rg) {
+    if constexpr (std::ranges::forward_range<Range>) {
+      const auto n = static_cast<size_type>(std::ranges::distance(rg));
+      if (n == 0) return;
+      if (begin_block_ == end_block_) init_first_block();
+      try {
+        while (start_ - begin_block_ * BlockCapacity < n) {
+          reserve_map(true);
+          pointer block = make_block();
+          map_[--begin_block_] = block;
+        }
+        const size_type first = start_ - n;
+        size_type pos = first;
+        auto it = std::ranges::begin(rg);
+        try {
+          while (pos < start_) {
+            const size_type count = std::min(start_ - pos, BlockCapacity - pos % BlockCapacity);
+            pointer dst = slot(pos);
+            it = construct_n(std::move(it), count, dst);
+            pos += count;
+          }
+        } catch (...) {
+          for (; pos > first; --pos) {
+            alloc_traits::destroy(alloc_, slot(pos - 1));
+          }
+          throw;
+        }
+        start_ = first;
+      } catch (...) {
+        trim_blocks();
+        throw;
+      }
+    } else {
+      deque tmp(alloc_);  // a single pass range: its size is known only after reading it
+      tmp.append_range(std::forward<Range>(rg));
+      for (; !tmp.empty(); tmp.pop_back()) {
+        construct_front(std::move(tmp.back()));
+      }
     }
-    tail_->data[tail_index_] = value;
-    ++tail_index_;
-    ++size_;
   }
 
   void pop_front() {
-    ++head_index_;
-    if (head_index_ == BlockCapacity) {
-      auto next = head_->next;
-      delete head_;
-      head_ = next;
-      if (head_) {
-        head_->prev = nullptr;
-      } else {
-        tail_ = nullptr;  // makes deque consistant (if delete last element then head_ == tail_)
-      }
-      head_index_ = 0;
+    alloc_traits::destroy(alloc_, slot(start_));
+    if (++start_ == finish_) return clear();  // releases the last block and recenters
+    if (start_ == (begin_block_ + 1) * BlockCapacity) {
+      free_block(std::exchange(map_[begin_block_++], nullptr));
     }
-    --size_;
   }
 
   void pop_back() {
-    --tail_index_;
-    if (tail_index_ == 0) {
-      auto prev = tail_->prev;
-      delete tail_;
-      tail_ = prev;
-      if (tail_) {
-        tail_->next = nullptr;
-      } else {
-        head_ = nullptr;  // makes deque consistant (if delete last element then head_ == tail_)
-      }
-      tail_index_ = BlockCapacity;
+    const size_type pos = --finish_;
+    alloc_traits::destroy(alloc_, slot(pos));
+    if (start_ == finish_) return clear();
+    if (pos == (end_block_ - 1) * BlockCapacity) {
+      free_block(std::exchange(map_[--end_block_], nullptr));
     }
-    --size_;
   }
 
   // iterators
 
-  iterator begin() { return iterator(this, 0); }
-  iterator end() { return iterator(this, size()); }
+  iterator begin() { return make_iterator<iterator>(start_); }
+  iterator end() { return make_iterator<iterator>(finish_); }
 
-  const_iterator begin() const { return const_iterator(this, 0); }
-  const_iterator end() const { return const_iterator(this, size()); }
+  const_iterator begin() const { return make_iterator<const_iterator>(start_); }
+  const_iterator end() const { return make_iterator<const_iterator>(finish_); }
 
-  const_iterator cbegin() const { return const_iterator(this, 0); }
-  const_iterator cend() const { return const_iterator(this, size()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
 
   reverse_iterator rbegin() { return reverse_iterator(end()); }
   reverse_iterator rend() { return reverse_iterator(begin()); }
@@ -300,25 +615,44 @@ class deque {
   const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
   const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
 
+  /// @return the contents as contiguous spans, e.g. for vectorized loops or writev. With separately allocated
+  /// blocks that is one span per block: a writev caller has to batch them by IOV_MAX.
+  segments_type segments() noexcept { return segments_type(map_, start_, finish_); }
+
+  const_segments_type segments() const noexcept { return const_segments_type(map_, start_, finish_); }
+
   // others
 
+  /// @brief Destroys all elements and frees the blocks (up to MaxSpareBlocks are cached), the map is kept for reuse.
   void clear() {
-    while (head_) {
-      auto next = head_->next;
-      delete head_;
-      head_ = next;
+    for (size_type pos = start_; pos < finish_; ++pos) {
+      alloc_traits::destroy(alloc_, slot(pos));
+    }
+    for (size_type b = begin_block_; b < end_block_; ++b) {
+      free_block(std::exchange(map_[b], nullptr));
     }
-    size_ = 0;
-    head_ = tail_ = nullptr;
+    begin_block_ = end_block_ = map_size_ / 2;
+    start_ = finish_ = begin_block_ * BlockCapacity;
   }
 
   void swap(deque& other) {
-    std::swap(head_, other.head_);
-    std::swap(tail_, other.tail_);
-    std::swap(head_index_, other.head_index_);
-    std::swap(tail_index_, other.tail_index_);
-    std::swap(size_, other.size_);
+    std::swap(alloc_, other.alloc_);
+    std::swap(map_alloc_, other.map_alloc_);
+    std::swap(map_, other.map_);
+    std::swap(map_size_, other.map_size_);
+    std::swap(begin_block_, other.begin_block_);
+    std::swap(end_block_, other.end_block_);
+    std::swap(start_, other.start_);
+    std::swap(finish_, other.finish_);
+    std::swap(spare_, other.spare_);
+    std::swap(spare_count_, other.spare_count_);
   }
+
+  /// @return number of cached empty blocks
+  size_type spare_blocks() const noexcept { return spare_count_; }
+
+  /// @brief Returns the cached empty blocks to the allocator.
+  void shrink_to_fit() noexcept { release_spare_blocks(); }
 };
 
 }  // namespace my::blocksbased
@@ -1,23 +1,67 @@
 #pragma once
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cstddef>
 #include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace my::cyclicbufferbased {
 
-template <typename T, std::size_t Capacity = 8>
+/// @brief What a push does when the deque is full.
+namespace on_full {
+
+/// @brief Reallocates a buffer twice as big.
+struct grow {};
+
+/// @brief Fixed capacity ring: push_back overwrites the front (oldest) element, push_front the back one.
+struct overwrite {};
+
+/// @brief Fixed capacity ring: the push does nothing and returns false.
+struct reject {};
+
+}  // namespace on_full
+
+/// @brief Deque on a ring buffer that doubles when full.
+///
+/// The buffer is raw storage, only the live range is constructed. If Capacity is a power of two every capacity
+/// is one too (sizes requested by the count constructor or range inserts are rounded up), and positions wrap with
+/// a mask instead of a compare and subtract.
+/// With on_full::overwrite or on_full::reject the capacity is fixed to Capacity: the buffer is allocated by the
+/// first push and never reallocated, so pushes neither divide nor allocate.
+/// @tparam Capacity -- initial capacity, or the fixed capacity of a ring
+/// @tparam Allocator -- the ring buffer is allocated with it
+/// @tparam OnFull -- on_full::grow, on_full::overwrite or on_full::reject
+template <typename T, std::size_t Capacity = 8, typename Allocator = std::allocator<T>,
+          typename OnFull = on_full::grow>
 class deque {
+  static constexpr bool fixed = !std::is_same_v<OnFull, on_full::grow>;
+  static constexpr bool power_of_two = std::has_single_bit(Capacity);
+  static_assert(!fixed || Capacity > 0, "a fixed capacity ring needs Capacity > 0");
+
  public:
   using value_type = T;
+  using allocator_type = Allocator;
   using reference = value_type&;
   using const_reference = const value_type&;
   using pointer = value_type*;
   using const_pointer = const value_type*;
   using size_type = std::size_t;
+  /// what pushes return: bool for a fixed ring (false if rejected), void when the deque grows,
+  /// so that a growing deque has the same push signatures as blocksbased::deque
+  using push_result = std::conditional_t<fixed, bool, void>;
 
  private:
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  static constexpr push_result accepted(bool ok) noexcept { return static_cast<push_result>(ok); }
+
+  allocator_type alloc_;
   pointer buffer_ = nullptr;
   size_type capacity_ = 0;
   size_type size_ = 0;
@@ -25,17 +69,84 @@ class deque {
 
   static constexpr size_type INITIAL_CAPACITY = Capacity;
 
-  size_type index(size_type offset) const noexcept { return (head_ + offset) % capacity_; }
+  /// @return i reduced to [0, capacity_), i must be < 2 * capacity_
+  size_type wrap(size_type i) const noexcept {
+    if constexpr (power_of_two) {
+      return i & (capacity_ - 1);
+    } else {
+      return i >= capacity_ ? i - capacity_ : i;
+    }
+  }
 
-  void reallocate() {
-    size_type new_capacity = capacity_ ? capacity_ * 2 : INITIAL_CAPACITY;
-    pointer new_buffer = new value_type[new_capacity];
+  size_type index(size_type offset) const noexcept { return wrap(head_ + offset); }
 
+  static size_type round_capacity(size_type n) noexcept {
+    if constexpr (power_of_two) {
+      return std::bit_ceil(n);
+    } else {
+      return n;
+    }
+  }
+
+  /// @brief Destroys the live range and frees the buffer.
+  void release() noexcept {
     for (size_type i = 0; i < size_; ++i) {
-      new_buffer[i] = std::move(buffer_[index(i)]);
+      alloc_traits::destroy(alloc_, buffer_ + index(i));
+    }
+    if (buffer_) alloc_traits::deallocate(alloc_, buffer_, capacity_);
+  }
+
+  /// @brief Copies count elements of it into the raw storage at dst through the allocator, destroying the ones
+  /// already built if a constructor throws. With std::allocator, whose construct adds nothing, this is
+  /// uninitialized_copy_n: a memmove for trivially copyable T from a contiguous source.
+  /// @return the iterator past the last copied element
+  template <typename It>
+  It construct_n(It it, size_type count, pointer dst) {
+    if constexpr (std::is_same_v<Allocator, std::allocator<T>>) {
+      return std::ranges::uninitialized_copy_n(std::move(it), count, dst, dst + count).in;
+    } else {
+      size_type i = 0;
+      try {
+        for (; i < count; ++i, ++it) {
+          alloc_traits::construct(alloc_, dst + i, *it);
+        }
+      } catch (...) {
+        destroy_n(dst, i);
+        throw;
+      }
+      return it;
+    }
+  }
+
+  void destroy_n(pointer first, size_type count) noexcept {
+    for (size_type i = 0; i < count; ++i) {
+      alloc_traits::destroy(alloc_, first + i);
+    }
+  }
+
+  /// @return true if a push on the full deque reallocates: always when it grows, once for a fixed ring (its buffer)
+  bool reallocates_when_full() const noexcept { return !fixed || capacity_ == 0; }
+
+  /// @brief Moves the elements to a new buffer of at least min_capacity (and 1), doubling the current one at least.
+  void reallocate(size_type min_capacity = 0) {
+    size_type new_capacity =
+        round_capacity(std::max({capacity_ ? capacity_ * 2 : INITIAL_CAPACITY, min_capacity, size_type{1}}));
+    pointer new_buffer = alloc_traits::allocate(alloc_, new_capacity);
+
+    size_type i = 0;
+    try {
+      for (; i < size_; ++i) {
+        alloc_traits::construct(alloc_, new_buffer + i, std::move_if_noexcept(buffer_[index(i)]));
+      }
+    } catch (...) {
+      for (size_type j = 0; j < i; ++j) {
+        alloc_traits::destroy(alloc_, new_buffer + j);
+      }
+      alloc_traits::deallocate(alloc_, new_buffer, new_capacity);
+      throw;
     }
 
-    delete[] buffer_;
+    release();
     buffer_ = new_buffer;
     capacity_ = new_capacity;
     head_ = 0;
@@ -100,24 +211,37 @@ class deque {
   // Constructors
   deque() = default;
 
-  explicit deque(size_type count, const_reference value = value_type()) {
-    capacity_ = std::max(count, INITIAL_CAPACITY);
-    buffer_ = new value_type[capacity_];
-    for (size_type i = 0; i < count; ++i) {
-      buffer_[i] = value;
+  explicit deque(const allocator_type& alloc) : alloc_(alloc) {}
+
+  explicit deque(size_type count, const_reference value = value_type(), const allocator_type& alloc = allocator_type())
+      : alloc_(alloc) {
+    if constexpr (fixed) {
+      if (count > Capacity) throw std::length_error("deque: count exceeds the fixed capacity");
+    }
+    capacity_ = round_capacity(std::max(count, INITIAL_CAPACITY));
+    buffer_ = capacity_ ? alloc_traits::allocate(alloc_, capacity_) : nullptr;
+    try {
+      for (; size_ < count; ++size_) {
+        alloc_traits::construct(alloc_, buffer_ + size_, value);
+      }
+    } catch (...) {
+      release();
+      throw;
     }
-    size_ = count;
-    head_ = 0;
   }
 
   // Copy constructor
-  deque(const deque& other) {
+  deque(const deque& other) : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
     capacity_ = other.capacity_;
-    size_ = other.size_;
     head_ = other.head_;
-    buffer_ = new value_type[capacity_];
-    for (size_type i = 0; i < size_; ++i) {
-      buffer_[index(i)] = other.buffer_[other.index(i)];
+    buffer_ = capacity_ ? alloc_traits::allocate(alloc_, capacity_) : nullptr;
+    try {
+      for (; size_ < other.size_; ++size_) {
+        alloc_traits::construct(alloc_, buffer_ + index(size_), other.buffer_[other.index(size_)]);
+      }
+    } catch (...) {
+      release();
+      throw;
     }
   }
 
@@ -130,9 +254,10 @@ class deque {
     return *this;
   }
 
-  // Move constructor
+  // Move constructor, the allocator is copied so the moved-from deque can still allocate
   deque(deque&& other) noexcept
-      : buffer_(std::exchange(other.buffer_, nullptr)),
+      : alloc_(other.alloc_),
+        buffer_(std::exchange(other.buffer_, nullptr)),
         capacity_(std::exchange(other.capacity_, 0)),
         size_(std::exchange(other.size_, 0)),
         head_(std::exchange(other.head_, 0)) {}
@@ -140,7 +265,8 @@ class deque {
   // Move assignment
   deque& operator=(deque&& other) noexcept {
     if (this != &other) {
-      clear();
+      release();
+      alloc_ = other.alloc_;
       buffer_ = std::exchange(other.buffer_, nullptr);
       capacity_ = std::exchange(other.capacity_, 0);
       size_ = std::exchange(other.size_, 0);
@@ -149,12 +275,22 @@ class deque {
     return *this;
   }
 
-  ~deque() { clear(); }
+  ~deque() { release(); }
+
+  allocator_type get_allocator() const noexcept { return alloc_; }
 
   // Capacity
   bool empty() const noexcept { return size_ == 0; }
   size_type size() const noexcept { return size_; }
   size_type capacity() const noexcept { return capacity_; }
+  /// @return true if a fixed ring holds Capacity elements, always false for on_full::grow
+  bool full() const noexcept {
+    if constexpr (fixed) {
+      return size_ == Capacity;
+    } else {
+      return false;
+    }
+  }
 
   // Element access
   reference operator[](size_type pos) { return buffer_[index(pos)]; }
@@ -192,45 +328,197 @@ class deque {
   }
 
   // Modifiers
-  void push_back(const_reference value) {
-    if (size_ == capacity_) reallocate();
-    buffer_[index(size_)] = value;
+
+  /// @return false if the deque is full and the policy is on_full::reject, true for other fixed rings
+  push_result push_back(const_reference value) {
+    if (size_ == capacity_) {
+      if (reallocates_when_full()) {
+        value_type copy(value);  // value may be an element of the buffer that reallocate() frees
+        reallocate();
+        alloc_traits::construct(alloc_, buffer_ + index(size_), std::move(copy));
+        ++size_;
+        return accepted(true);
+      }
+      if constexpr (std::is_same_v<OnFull, on_full::overwrite>) {
+        buffer_[head_] = value;  // the slot after the back is the front
+        head_ = wrap(head_ + 1);
+        return accepted(true);
+      }
+      return accepted(false);
+    }
+    alloc_traits::construct(alloc_, buffer_ + index(size_), value);
     ++size_;
+    return accepted(true);
   }
 
-  void push_front(const_reference value) {
-    if (size_ == capacity_) reallocate();
-    head_ = (head_ == 0) ? capacity_ - 1 : head_ - 1;
-    buffer_[head_] = value;
+  /// @return false if the deque is full and the policy is on_full::reject, true for other fixed rings
+  push_result push_front(const_reference value) {
+    if (size_ == capacity_) {
+      if (reallocates_when_full()) {
+        value_type copy(value);  // as in push_back
+        reallocate();
+        alloc_traits::construct(alloc_, buffer_ + (capacity_ - 1), std::move(copy));
+        head_ = capacity_ - 1;
+        ++size_;
+        return accepted(true);
+      }
+      if constexpr (std::is_same_v<OnFull, on_full::overwrite>) {
+        head_ = (head_ == 0) ? capacity_ - 1 : head_ - 1;  // the slot before the front is the back
+        buffer_[head_] = value;
+        return accepted(true);
+      }
+      return accepted(false);
+    }
+    const size_type new_head = (head_ == 0) ? capacity_ - 1 : head_ - 1;
+    alloc_traits::construct(alloc_, buffer_ + new_head, value);
+    head_ = new_head;
     ++size_;
+    return accepted(true);
+  }
+
+  /// @brief Appends the elements of rg. A forward range is copied in at most two pieces (before and after
+  /// the wrap-around point) through the allocator, a memmove for trivially copyable T from a contiguous source
+  /// with std::allocator. If an element constructor throws, the elements appended before it stay.
+  /// A fixed ring with on_full::overwrite keeps the last Capacity elements, with on_full::reject nothing is
+  /// inserted if rg does not fit (a single pass range is pushed one by one and may stop in the middle).
+  /// @return false if elements were rejected (fixed rings only)
+  template <typename Range>
+  push_result append_range(Range&& rg) {
+    if constexpr (std::ranges::forward_range<Range>) {
+      auto n = static_cast<size_type>(std::ranges::distance(rg));
+      if (n == 0) return accepted(true);
+      auto it = std::ranges::begin(rg);
+      if constexpr (fixed) {
+        if constexpr (std::is_same_v<OnFull, on_full::reject>) {
+          if (size_ + n > Capacity) return accepted(false);
+        } else {
+          if (n > Capacity) {
+            it = std::ranges::next(it, n - Capacity);
+            n = Capacity;
+          }
+          while (size_ + n > Capacity) pop_front();
+        }
+        if (!buffer_) reallocate();
+      } else {
+        if (size_ + n > capacity_) reallocate(size_ + n);
+      }
+      while (n) {
+        pointer dst = buffer_ + index(size_);
+        const size_type count = std::min(n, static_cast<size_type>(buffer_ + capacity_ - dst));
+        it = construct_n(std::move(it), count, dst);
+        size_ += count;
+        n -= count;
+      }
+      return accepted(true);
+    } else {
+      for (const auto& value : rg) {
+        if constexpr (fixed) {
+          if (!push_back(value)) return false;
+        } else {
+          push_back(value);
+        }
+      }
+      return accepted(true);
+    }
+  }
+
+  /// @brief Inserts the elements of rg in front, keeping their order, in at most two pieces.
+  /// If an element constructor throws, the deque is left unchanged.
+  /// A fixed ring with on_full::overwrite keeps the first Capacity elements, dropping from the back,
+  /// on_full::reject works as in append_range.
+  /// @return false if elements were rejected (fixed rings only)
+  template <typename Range>
+  push_result prepend_range(Range&& rg) {
+    if constexpr (std::ranges::forward_range<Range>) {
+      auto n = static_cast<size_type>(std::ranges::distance(rg));
+      if (n == 0) return accepted(true);
+      if constexpr (fixed) {
+        if constexpr (std::is_same_v<OnFull, on_full::reject>) {
+          if (size_ + n > Capacity) return accepted(false);
+        } else {
+          n = std::min(n, Capacity);
+          while (size_ + n > Capacity) pop_back();
+        }
+        if (!buffer_) reallocate();
+      } else {
+        if (size_ + n > capacity_) reallocate(size_ + n);
+      }
+      const size_type new_head = wrap(head_ + capacity_ - n);
+      const size_type first = std::min(n, capacity_ - new_head);
+      auto it = construct_n(std::ranges::begin(rg), first, buffer_ + new_head);
+      try {
+        construct_n(std::move(it), n - first, buffer_);
+      } catch (...) {
+        destroy_n(buffer_ + new_head, first);
+        throw;
+      }
+      head_ = new_head;
+      size_ += n;
+      return accepted(true);
+    } else {
+      deque<T, Capacity, Allocator> tmp(alloc_);  // a single pass range: its size is known only after reading it
+      tmp.append_range(std::forward<Range>(rg));
+      for (; !tmp.empty(); tmp.pop_back()) {
+        if constexpr (fixed) {
+          if (!push_front(tmp.back())) return false;
+        } else {
+          push_front(tmp.back());
+        }
+      }
+      return accepted(true);
+    }
   }
 
   void pop_back() {
     if (empty()) throw std::out_of_range("deque::pop_back: empty");
     --size_;
+    alloc_traits::destroy(alloc_, buffer_ + index(size_));
   }
 
   void pop_front() {
     if (empty()) throw std::out_of_range("deque::pop_front: empty");
-    head_ = (head_ + 1) % capacity_;
+    alloc_traits::destroy(alloc_, buffer_ + head_);
+    head_ = wrap(head_ + 1);
     --size_;
   }
 
   void swap(deque& other) noexcept {
+    std::swap(alloc_, other.alloc_);
     std::swap(buffer_, other.buffer_);
     std::swap(capacity_, other.capacity_);
     std::swap(size_, other.size_);
     std::swap(head_, other.head_);
   }
 
+  /// @brief Destroys all elements. A growing deque also frees its buffer, a fixed ring keeps it.
   void clear() {
-    delete[] buffer_;
-    buffer_ = nullptr;
-    capacity_ = 0;
+    if constexpr (fixed) {
+      for (size_type i = 0; i < size_; ++i) {
+        alloc_traits::destroy(alloc_, buffer_ + index(i));
+      }
+    } else {
+      release();
+      buffer_ = nullptr;
+      capacity_ = 0;
+    }
     size_ = 0;
     head_ = 0;
   }
 
+  /// @return the contents as at most two contiguous spans (the second one is used when the contents wrap
+  /// around the end of the buffer), unused spans are empty
+  std::array<std::span<T>, 2> segments() noexcept {
+    if (empty()) return {};
+    const size_type first = std::min(size_, capacity_ - head_);
+    return {std::span<T>(buffer_ + head_, first), std::span<T>(buffer_, size_ - first)};
+  }
+
+  std::array<std::span<const T>, 2> segments() const noexcept {
+    if (empty()) return {};
+    const size_type first = std::min(size_, capacity_ - head_);
+    return {std::span<const T>(buffer_ + head_, first), std::span<const T>(buffer_, size_ - first)};
+  }
+
   // Iterators
   iterator begin() { return iterator(this, 0); }
   iterator end() { return iterator(this, size_); }
@@ -0,0 +1,688 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#define MYSTD_SWISS_SSE2 1
+#include <emmintrin.h>
+#else
+#define MYSTD_SWISS_SSE2 0
+#endif
+
+#include "mystd/hashtable.hpp"
+
+namespace my {
+
+namespace detail::swiss {
+
+/// @brief One control byte per slot: a full slot stores the low 7 bits of the hash (H2) of its element,
+/// the others one of the negative markers below.
+using ctrl_t = std::int8_t;
+
+inline constexpr ctrl_t EMPTY = -128;   // 0b10000000
+inline constexpr ctrl_t DELETED = -2;   // 0b11111110, tombstone: probing goes on past it
+inline constexpr ctrl_t SENTINEL = -1;  // 0b11111111, after the last slot, stops iteration
+
+inline constexpr std::size_t GROUP_WIDTH = 16;
+
+inline bool is_full(ctrl_t c) noexcept { return c >= 0; }
+
+/// @brief 16 consecutive control bytes compared at once, every match is a bit of the returned mask.
+class group {
+#if MYSTD_SWISS_SSE2
+  __m128i ctrl_;
+
+  static std::uint32_t mask(__m128i m) noexcept { return static_cast<std::uint32_t>(_mm_movemask_epi8(m)); }
+
+ public:
+  explicit group(const ctrl_t* p) noexcept : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+  std::uint32_t match(ctrl_t h2) const noexcept { return mask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)); }
+
+  std::uint32_t match_empty() const noexcept { return match(EMPTY); }
+
+  std::uint32_t match_empty_or_deleted() const noexcept {
+    return mask(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), ctrl_));
+  }
+#else
+  ctrl_t ctrl_[GROUP_WIDTH];
+
+  template <typename Pred>
+  std::uint32_t mask(Pred pred) const noexcept {
+    std::uint32_t m = 0;
+    for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+      m |= static_cast<std::uint32_t>(pred(ctrl_[i])) << i;
+    }
+    return m;
+  }
+
+ public:
+  explicit group(const ctrl_t* p) noexcept { std::memcpy(ctrl_, p, GROUP_WIDTH); }
+
+  std::uint32_t match(ctrl_t h2) const noexcept {
+    return mask([h2](ctrl_t c) { return c == h2; });
+  }
+
+  std::uint32_t match_empty() const noexcept { return match(EMPTY); }
+
+  std::uint32_t match_empty_or_deleted() const noexcept {
+    return mask([](ctrl_t c) { return c < SENTINEL; });
+  }
+#endif
+};
+
+/// @brief Control bytes of a table without slots: every lookup stops at the first group, begin() == end().
+alignas(GROUP_WIDTH) inline ctrl_t empty_group[GROUP_WIDTH] = {SENTINEL, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+                                                               EMPTY,    EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+                                                               EMPTY,    EMPTY, EMPTY, EMPTY};
+
+}  // namespace detail::swiss
+
+/// @brief Open addressing hash table in the Swiss table layout, an alternative engine to my::hashtable
+/// with the same template parameters and interface.
+///
+/// Elements live in one flat array of slots, next to an array of one byte control words (see detail::swiss).
+/// A lookup hashes the key once, then compares the 7 bit fingerprint of 16 slots with a single SSE2 instruction
+/// and touches an element only on a fingerprint match; probing moves over groups quadratically and stops at the
+/// first group with an empty slot. Erase leaves a tombstone unless no probe can have passed the slot.
+///
+/// The capacity is 2^k - 1 slots; control bytes are followed by a sentinel and a copy of the first 15 bytes,
+/// so a group can be loaded at any position without wrapping. The table grows (x2) at 7/8 load.
+/// Iterators and references are invalidated by an insert that grows the table, erase invalidates only the
+/// erased element.
+template <class Value, class Key, class KeyOfValue, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          InsertPolicy Policy = InsertPolicy::UniqueKeys, class Allocator = std::allocator<Value>>
+class flat_hashtable {
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using reference = Value&;
+  using const_reference = const Value&;
+  using size_type = std::size_t;
+
+  static constexpr float max_load_factor = 7.0f / 8.0f;
+
+ private:
+  using ctrl_t = detail::swiss::ctrl_t;
+  using group = detail::swiss::group;
+
+  static constexpr size_type WIDTH = detail::swiss::GROUP_WIDTH;
+
+  using slot_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Value>;
+  using slot_traits = std::allocator_traits<slot_allocator_type>;
+  using ctrl_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<ctrl_t>;
+  using ctrl_traits = std::allocator_traits<ctrl_allocator_type>;
+
+  ctrl_t* ctrl_ = detail::swiss::empty_group;
+  Value* slots_ = nullptr;
+  size_type capacity_ = 0;
+  size_type size_ = 0;
+  size_type growth_left_ = 0;
+  Hash hasher;
+  KeyEqual equal;
+  KeyOfValue key_of_value;
+  slot_allocator_type slot_alloc;
+  ctrl_allocator_type ctrl_alloc;
+
+  /// @brief Group positions visited by a lookup: offset + WIDTH * (0, 1, 3, 6, ...) masked by the capacity,
+  /// the triangular steps visit every group once for a capacity of 2^k - 1.
+  class probe_seq {
+    size_type mask_;
+    size_type offset_;
+    size_type index_ = 0;
+
+   public:
+    probe_seq(size_type h1, size_type mask) noexcept : mask_(mask), offset_(h1 & mask) {}
+    size_type offset() const noexcept { return offset_; }
+    size_type offset(std::uint32_t bit) const noexcept { return (offset_ + bit) & mask_; }
+    void next() noexcept {
+      index_ += WIDTH;
+      offset_ = (offset_ + index_) & mask_;
+    }
+  };
+
+  static size_type h1(size_type hash) noexcept { return hash >> 7; }
+  static ctrl_t h2(size_type hash) noexcept { return static_cast<ctrl_t>(hash & 0x7f); }
+
+  static constexpr bool transparent = is_transparent_v<Hash> && is_transparent_v<KeyEqual>;
+
+  template <class K>
+  size_type hash_of(const K& k) const {
+    return detail::mix_hash(hasher(k));
+  }
+
+  static size_type growth_for(size_type capacity) noexcept { return capacity - capacity / 8; }
+
+  /// @return the smallest 2^k - 1 capacity (at least WIDTH - 1) that keeps n elements under the max load factor
+  static size_type capacity_for(size_type n) noexcept {
+    size_type capacity = WIDTH - 1;
+    while (growth_for(capacity) < n) {
+      capacity = capacity * 2 + 1;
+    }
+    return capacity;
+  }
+
+  /// @brief Writes c to slot i and to its copy after the sentinel.
+  void set_ctrl(size_type i, ctrl_t c) noexcept {
+    ctrl_[i] = c;
+    ctrl_[((i - (WIDTH - 1)) & capacity_) + (WIDTH - 1)] = c;
+  }
+
+  /// @return the first empty or deleted slot on the probe sequence of hash
+  size_type find_first_non_full(size_type hash) const noexcept {
+    probe_seq seq(h1(hash), capacity_);
+    for (;;) {
+      if (std::uint32_t m = group(ctrl_ + seq.offset()).match_empty_or_deleted()) {
+        return seq.offset(std::countr_zero(m));
+      }
+      seq.next();
+    }
+  }
+
+  /// @return index of the first element with key k, capacity_ if there is none
+  template <class K>
+  size_type find_index(const K& k, size_type hash) const {
+    probe_seq seq(h1(hash), capacity_);
+    for (;;) {
+      group g(ctrl_ + seq.offset());
+      for (std::uint32_t m = g.match(h2(hash)); m; m &= m - 1) {
+        const size_type i = seq.offset(std::countr_zero(m));
+        if (equal(key_of_value(slots_[i]), k)) return i;
+      }
+      if (g.match_empty()) return capacity_;
+      seq.next();
+    }
+  }
+
+  /// @brief Takes a free slot for hash, growing or cleaning up tombstones if the table is at its load limit.
+  /// @return index of the slot, its control byte is already set
+  size_type prepare_insert(size_type hash) {
+    size_type i = find_first_non_full(hash);
+    if (growth_left_ == 0 && ctrl_[i] != detail::swiss::DELETED) {
+      // mostly tombstones: rehash in place, otherwise double
+      resize(size_ < growth_for(capacity_) / 2 ? capacity_for(size_ + 1) : capacity_for(capacity_ + 1));
+      i = find_first_non_full(hash);
+    }
+    growth_left_ -= (ctrl_[i] == detail::swiss::EMPTY);
+    set_ctrl(i, h2(hash));
+    ++size_;
+    return i;
+  }
+
+  void allocate(size_type capacity) {
+    ctrl_ = ctrl_traits::allocate(ctrl_alloc, capacity + WIDTH);
+    try {
+      slots_ = slot_traits::allocate(slot_alloc, capacity);
+    } catch (...) {
+      ctrl_traits::deallocate(ctrl_alloc, ctrl_, capacity + WIDTH);
+      ctrl_ = detail::swiss::empty_group;
+      throw;
+    }
+    capacity_ = capacity;
+    std::memset(ctrl_, static_cast<unsigned char>(detail::swiss::EMPTY), capacity + WIDTH);
+    ctrl_[capacity] = detail::swiss::SENTINEL;
+    growth_left_ = growth_for(capacity);
+  }
+
+  void deallocate() noexcept {
+    if (capacity_ == 0) return;
+    ctrl_traits::deallocate(ctrl_alloc, ctrl_, capacity_ + WIDTH);
+    slot_traits::deallocate(slot_alloc, slots_, capacity_);
+    ctrl_ = detail::swiss::empty_group;
+    slots_ = nullptr;
+    capacity_ = 0;
+    growth_left_ = 0;
+  }
+
+  void destroy_all() noexcept {
+    for (size_type i = 0; i < capacity_; ++i) {
+      if (detail::swiss::is_full(ctrl_[i])) slot_traits::destroy(slot_alloc, slots_ + i);
+    }
+  }
+
+  /// @brief Moves all elements to a table of new_capacity slots (2^k - 1), dropping the tombstones.
+  /// If moving an element throws, the table is unchanged (the elements are copied if their move may throw).
+  void resize(size_type new_capacity) {
+    ctrl_t* old_ctrl = ctrl_;
+    Value* old_slots = slots_;
+    const size_type old_capacity = capacity_;
+    const size_type old_growth_left = growth_left_;
+
+    allocate(new_capacity);
+    size_type i = 0;
+    try {
+      for (; i < old_capacity; ++i) {
+        if (!detail::swiss::is_full(old_ctrl[i])) continue;
+        const size_type hash = hash_of(key_of_value(old_slots[i]));
+        const size_type j = find_first_non_full(hash);
+        slot_traits::construct(slot_alloc, slots_ + j, std::move_if_noexcept(old_slots[i]));
+        set_ctrl(j, h2(hash));
+      }
+    } catch (...) {
+      destroy_all();
+      ctrl_traits::deallocate(ctrl_alloc, ctrl_, capacity_ + WIDTH);
+      slot_traits::deallocate(slot_alloc, slots_, capacity_);
+      ctrl_ = old_ctrl;
+      slots_ = old_slots;
+      capacity_ = old_capacity;
+      growth_left_ = old_growth_left;
+      throw;
+    }
+    growth_left_ -= size_;
+
+    for (i = 0; i < old_capacity; ++i) {
+      if (detail::swiss::is_full(old_ctrl[i])) slot_traits::destroy(slot_alloc, old_slots + i);
+    }
+    if (old_capacity) {
+      ctrl_traits::deallocate(ctrl_alloc, old_ctrl, old_capacity + WIDTH);
+      slot_traits::deallocate(slot_alloc, old_slots, old_capacity);
+    }
+  }
+
+  /// @brief Frees slot i, a tombstone is needed only if a probe may have passed it: the empty slots around it
+  /// leave no window of WIDTH full/deleted slots containing i.
+  void erase_at(size_type i) noexcept {
+    slot_traits::destroy(slot_alloc, slots_ + i);
+    --size_;
+    const size_type before = (i - WIDTH) & capacity_;
+    const std::uint32_t empty_after = group(ctrl_ + i).match_empty();
+    const std::uint32_t empty_before = group(ctrl_ + before).match_empty();
+    const int after = empty_after ? std::countr_zero(empty_after) : static_cast<int>(WIDTH);
+    const int lead = empty_before ? std::countl_zero(empty_before << (32 - WIDTH)) : static_cast<int>(WIDTH);
+    const bool was_never_full = empty_before && empty_after && static_cast<size_type>(after + lead) < WIDTH;
+    set_ctrl(i, was_never_full ? detail::swiss::EMPTY : detail::swiss::DELETED);
+    growth_left_ += was_never_full;
+  }
+
+ public:
+  template <bool IsConst>
+  class iterator_basic {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::conditional_t<IsConst, const Value, Value>;
+    using pointer = std::conditional_t<IsConst, const Value*, Value*>;
+    using reference = std::conditional_t<IsConst, const Value&, Value&>;
+    using difference_type = std::ptrdiff_t;
+
+   private:
+    const ctrl_t* ctrl;
+    pointer slot;
+
+    /// the sentinel after the last slot stops the loop
+    void skip_empty() {
+      while (*ctrl < detail::swiss::SENTINEL) {
+        ++ctrl;
+        ++slot;
+      }
+    }
+
+   public:
+    iterator_basic(const ctrl_t* c, pointer s) : ctrl(c), slot(s) { skip_empty(); }
+
+    reference operator*() const { return *slot; }
+
+    pointer operator->() const { return slot; }
+
+    iterator_basic& operator++() {
+      ++ctrl;
+      ++slot;
+      skip_empty();
+      return *this;
+    }
+
+    iterator_basic operator++(int) {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator_basic& other) const { return ctrl == other.ctrl; }
+    bool operator!=(const iterator_basic& other) const { return !(*this == other); }
+  };
+
+  using iterator = iterator_basic<false>;
+  using const_iterator = iterator_basic<true>;
+
+  // ctor
+  /// @param bucket_count -- the table starts with room for at least bucket_count elements
+  explicit flat_hashtable(size_type bucket_count = 8) : hasher(), equal(), key_of_value(), slot_alloc(), ctrl_alloc() {
+    if (bucket_count) allocate(capacity_for(bucket_count));
+  }
+
+  // copy: same capacity and layout, so no rehashing
+  flat_hashtable(const flat_hashtable& other)
+      : hasher(other.hasher),
+        equal(other.equal),
+        key_of_value(other.key_of_value),
+        slot_alloc(slot_traits::select_on_container_copy_construction(other.slot_alloc)),
+        ctrl_alloc(ctrl_traits::select_on_container_copy_construction(other.ctrl_alloc)) {
+    if (other.capacity_ == 0) return;
+    allocate(other.capacity_);
+    size_type i = 0;
+    try {
+      for (; i < capacity_; ++i) {
+        if (detail::swiss::is_full(other.ctrl_[i])) {
+          slot_traits::construct(slot_alloc, slots_ + i, other.slots_[i]);
+          ctrl_[i] = other.ctrl_[i];
+        }
+      }
+    } catch (...) {
+      destroy_all();
+      deallocate();
+      throw;
+    }
+    std::memcpy(ctrl_, other.ctrl_, capacity_ + WIDTH);
+    size_ = other.size_;
+    growth_left_ = other.growth_left_;
+  }
+
+  // copy assign
+  flat_hashtable& operator=(const flat_hashtable& other) {
+    if (this != &other) {
+      flat_hashtable tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  // move: the moved-from table has no slots and allocates on the next insert
+  flat_hashtable(flat_hashtable&& other) noexcept : flat_hashtable(0) { swap(other); }
+
+  flat_hashtable& operator=(flat_hashtable&& other) noexcept {
+    if (this != &other) {
+      destroy_all();
+      deallocate();
+      size_ = 0;
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~flat_hashtable() {
+    destroy_all();
+    deallocate();
+  }
+
+  /// @brief Destroys all elements, the capacity is kept.
+  void clear() {
+    destroy_all();
+    if (capacity_) {
+      std::memset(ctrl_, static_cast<unsigned char>(detail::swiss::EMPTY), capacity_ + WIDTH);
+      ctrl_[capacity_] = detail::swiss::SENTINEL;
+    }
+    size_ = 0;
+    growth_left_ = growth_for(capacity_);
+  }
+
+  size_type count(const key_type& k) const { return count_key(k); }
+
+  /// @brief Heterogeneous lookup, if Hash and KeyEqual are transparent (see my::hashtable::count).
+  template <class K>
+    requires transparent
+  size_type count(const K& k) const {
+    return count_key(k);
+  }
+
+  bool contains(const key_type& k) const { return find_index(k, hash_of(k)) != capacity_; }
+
+  template <class K>
+    requires transparent
+  bool contains(const K& k) const {
+    return find_index(k, hash_of(k)) != capacity_;
+  }
+
+ private:
+  template <class K>
+  size_type count_key(const K& k) const {
+    const size_type hash = hash_of(k);
+    if constexpr (Policy == InsertPolicy::UniqueKeys) {
+      return find_index(k, hash) != capacity_;
+    } else {
+      size_type count = 0;
+      probe_seq seq(h1(hash), capacity_);
+      for (;;) {
+        group g(ctrl_ + seq.offset());
+        for (std::uint32_t m = g.match(h2(hash)); m; m &= m - 1) {
+          count += equal(key_of_value(slots_[seq.offset(std::countr_zero(m))]), k);
+        }
+        if (g.match_empty()) return count;
+        seq.next();
+      }
+    }
+  }
+
+ public:
+  std::pair<iterator, bool> insert(const_reference v) { return emplace_key(key_of_value(v), v); }
+
+  std::pair<iterator, bool> insert(value_type&& v) { return emplace_key(key_of_value(v), std::move(v)); }
+
+  /// @brief Builds the value on the stack to get its key, then moves it into a slot if the key is new.
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type v(std::forward<Args>(args)...);
+    return emplace_key(key_of_value(v), std::move(v));
+  }
+
+  /// @brief Hashes k once; constructs a value from args in its slot only if k is not present (or keys may repeat).
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+    return emplace_key(k, std::forward<Args>(args)...);
+  }
+
+ private:
+  template <class... Args>
+  std::pair<iterator, bool> emplace_key(const key_type& k, Args&&... args) {
+    return emplace_hashed(k, hash_of(k), std::forward<Args>(args)...);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace_hashed(const key_type& k, size_type hash, Args&&... args) {
+    if constexpr (Policy == InsertPolicy::UniqueKeys) {
+      if (const size_type i = find_index(k, hash); i != capacity_) {
+        return {iterator(ctrl_ + i, slots_ + i), false};
+      }
+    }
+
+    if (growth_left_ == 0) {
+      // prepare_insert may resize and free the slots args refer to, so take the value out of the table first
+      value_type v(std::forward<Args>(args)...);
+      return {construct_at_new_slot(hash, std::move(v)), true};
+    }
+    return {construct_at_new_slot(hash, std::forward<Args>(args)...), true};
+  }
+
+  template <class... Args>
+  iterator construct_at_new_slot(size_type hash, Args&&... args) {
+    const size_type i = prepare_insert(hash);
+    try {
+      slot_traits::construct(slot_alloc, slots_ + i, std::forward<Args>(args)...);
+    } catch (...) {
+      set_ctrl(i, detail::swiss::DELETED);
+      --size_;
+      throw;
+    }
+    return iterator(ctrl_ + i, slots_ + i);
+  }
+
+  template <class K>
+  iterator find_key(const K& k) {
+    const size_type i = find_index(k, hash_of(k));
+    return iterator(ctrl_ + i, slots_ + i);
+  }
+
+  template <class K>
+  const_iterator find_key(const K& k) const {
+    const size_type i = find_index(k, hash_of(k));
+    return const_iterator(ctrl_ + i, slots_ + i);
+  }
+
+  template <class K>
+  iterator erase_key(const K& k) {
+    const size_type i = find_index(k, hash_of(k));
+    if (i == capacity_) return end();
+    erase_at(i);
+    return iterator(ctrl_ + i, slots_ + i);
+  }
+
+ public:
+  iterator find(const key_type& k) { return find_key(k); }
+
+  template <class K>
+    requires transparent
+  iterator find(const K& k) {
+    return find_key(k);
+  }
+
+  const_iterator find(const key_type& k) const { return find_key(k); }
+
+  template <class K>
+    requires transparent
+  const_iterator find(const K& k) const {
+    return find_key(k);
+  }
+
+  /// @brief Erases one element with key k.
+  /// @return iterator to after removed element
+  iterator erase(const key_type& k) { return erase_key(k); }
+
+  template <class K>
+    requires transparent
+  iterator erase(const K& k) {
+    return erase_key(k);
+  }
+
+  // batches, as in my::hashtable: hash and prefetch the first group and slot of BATCH keys, then probe
+
+  template <std::random_access_iterator It, class OutputIt>
+  OutputIt find_batch(It first, It last, OutputIt out) {
+    resolve_batch(first, last, [&](size_type i) {
+      *out = iterator(ctrl_ + i, slots_ + i);
+      ++out;
+    });
+    return out;
+  }
+
+  template <std::random_access_iterator It, class OutputIt>
+  OutputIt contains_batch(It first, It last, OutputIt out) const {
+    resolve_batch(first, last, [&](size_type i) {
+      *out = i != capacity_;
+      ++out;
+    });
+    return out;
+  }
+
+  /// @return number of values inserted
+  template <std::random_access_iterator It>
+  size_type insert_batch(It first, It last) {
+    size_type inserted = 0;
+    size_type hashes[BATCH];
+    while (first != last) {
+      const size_type n = std::min<size_type>(BATCH, last - first);
+      for (size_type i = 0; i < n; ++i) {
+        const value_type& v = first[i];  // a converted temporary lives as long as v
+        hashes[i] = hash_of(key_of_value(v));
+        prefetch_probe(hashes[i]);
+      }
+      for (size_type i = 0; i < n; ++i) {
+        const value_type& v = first[i];
+        inserted += emplace_hashed(key_of_value(v), hashes[i], v).second;
+      }
+      first += n;
+    }
+    return inserted;
+  }
+
+ private:
+  static constexpr size_type BATCH = 16;
+
+  void prefetch_probe(size_type hash) const noexcept {
+    const size_type i = h1(hash) & capacity_;
+    detail::prefetch(ctrl_ + i);
+    detail::prefetch(slots_ + i);
+  }
+
+  /// @brief Calls visit(slot index) for every key of [first, last), capacity_ for a missing key.
+  template <class It, class Visit>
+  void resolve_batch(It first, It last, Visit visit) const {
+    size_type hashes[BATCH];
+    while (first != last) {
+      const size_type n = std::min<size_type>(BATCH, last - first);
+      for (size_type i = 0; i < n; ++i) {
+        hashes[i] = hash_of(first[i]);
+        prefetch_probe(hashes[i]);
+      }
+      for (size_type i = 0; i < n; ++i) {
+        visit(find_index(first[i], hashes[i]));
+      }
+      first += n;
+    }
+  }
+
+ public:
+  // iterators
+  iterator begin() { return iterator(ctrl_, slots_); }
+  iterator end() { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+  const_iterator begin() const { return const_iterator(ctrl_, slots_); }
+  const_iterator end() const { return const_iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  // capacity and others
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_type bucket_count() const { return capacity_; }
+
+  float load_factor() const { return capacity_ ? static_cast<float>(size_) / capacity_ : 0.0f; }
+
+  /// @brief Rebuilds the table with at least new_count slots (and room for the current elements).
+  void rehash(size_type new_count) {
+    resize(capacity_for(std::max(size_, new_count - new_count / 8)));
+  }
+
+  /// @brief Grows the table so that n elements fit without another resize. Never shrinks.
+  void reserve(size_type n) {
+    if (n > growth_for(capacity_)) {
+      resize(capacity_for(n));
+    }
+  }
+
+  /// @brief Rebuilds the table with the fewest slots that hold size() elements, dropping the tombstones; an empty
+  /// table frees its slots.
+  void shrink_to_fit() {
+    if (size_ == 0) {
+      deallocate();
+    } else if (capacity_for(size_) < capacity_) {
+      resize(capacity_for(size_));
+    }
+  }
+
+  void swap(flat_hashtable& other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(hasher, other.hasher);
+    std::swap(equal, other.equal);
+    std::swap(key_of_value, other.key_of_value);
+    std::swap(slot_alloc, other.slot_alloc);
+    std::swap(ctrl_alloc, other.ctrl_alloc);
+  }
+
+  // ADL
+  friend void swap(flat_hashtable& a, flat_hashtable& b) noexcept { a.swap(b); }
+};
+
+}  // namespace my
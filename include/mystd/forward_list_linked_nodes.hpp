@@ -2,6 +2,7 @@
 
 #include <initializer_list>
 #include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
@@ -9,10 +10,12 @@
 namespace my::heapbased {
 
 /// @brief Heap based forward list.
-template <typename T>
+/// @tparam Allocator -- nodes are allocated with Allocator rebound to the node type
+template <typename T, typename Allocator = std::allocator<T>>
 class forward_list {
  public:
   using value_type = T;
+  using allocator_type = Allocator;
   using reference = T&;
   using const_reference = const T&;
   using pointer = T*;
@@ -27,6 +30,10 @@ class forward_list {
     Node(const value_type& val, Node* next = nullptr) : data(val), next(next) {}
   };
 
+  using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+
+  node_allocator_type node_alloc_;
   Node* head_ = nullptr;
 
   template <bool IsConst>
@@ -70,22 +77,31 @@ class forward_list {
 
   forward_list() = default;
 
-  forward_list(std::initializer_list<value_type> init) {
+  explicit forward_list(const allocator_type& alloc) : node_alloc_(alloc) {}
+
+  forward_list(std::initializer_list<value_type> init, const allocator_type& alloc = allocator_type())
+      : node_alloc_(alloc) {
     for (auto it = std::rbegin(init); it != std::rend(init); ++it) {
       push_front(*it);
     }
   }
 
-  forward_list(const forward_list& other) {
+  forward_list(const forward_list& other)
+      : node_alloc_(node_alloc_traits::select_on_container_copy_construction(other.node_alloc_)) {
     if (!other.head_) return;
 
-    head_ = new Node(other.head_->data);
+    head_ = create_node(other.head_->data);
     Node* curr = head_;
     Node* other_node = other.head_->next;
-    while (other_node) {
-      curr->next = new Node(other_node->data);
-      other_node = other_node->next;
-      curr = curr->next;
+    try {
+      while (other_node) {
+        curr->next = create_node(other_node->data);
+        other_node = other_node->next;
+        curr = curr->next;
+      }
+    } catch (...) {
+      clear();
+      throw;
     }
   }
 
@@ -97,11 +113,14 @@ class forward_list {
     return *this;
   }
 
-  forward_list(forward_list&& other) noexcept : head_(std::exchange(other.head_, nullptr)) {}
+  // the allocator is copied so the moved-from list can still allocate
+  forward_list(forward_list&& other) noexcept
+      : node_alloc_(other.node_alloc_), head_(std::exchange(other.head_, nullptr)) {}
 
   forward_list& operator=(forward_list&& other) noexcept {
     if (this != &other) {
       clear();
+      node_alloc_ = other.node_alloc_;
       head_ = std::exchange(other.head_, nullptr);
     }
     return *this;
@@ -109,6 +128,8 @@ class forward_list {
 
   ~forward_list() noexcept { clear(); }
 
+  allocator_type get_allocator() const noexcept { return allocator_type(node_alloc_); }
+
   // element access
   const_reference front() const {
     if (!head_) {
@@ -144,13 +165,13 @@ class forward_list {
     if (prev != end()) {
       Node* to_delete = prev.node()->next;
       prev.node()->next = to_delete->next;
-      delete to_delete;
+      destroy_node(to_delete);
       return iterator(prev.node()->next);
     }
     return end();
   }
 
-  void push_front(const value_type& value) { head_ = new Node(value, head_); }
+  void push_front(const value_type& value) { head_ = create_node(value, head_); }
 
   void pop_front() {
     if (!head_) {
@@ -158,7 +179,7 @@ class forward_list {
     };
     Node* tmp = head_;
     head_ = head_->next;
-    delete tmp;
+    destroy_node(tmp);
   }
 
   void reverse() noexcept {
@@ -173,7 +194,10 @@ class forward_list {
     head_ = prev;
   }
 
-  void swap(forward_list& other) noexcept { std::swap(head_, other.head_); }
+  void swap(forward_list& other) noexcept {
+    std::swap(node_alloc_, other.node_alloc_);
+    std::swap(head_, other.head_);
+  }
 
   // iterators
   iterator begin() noexcept { return iterator(head_); }
@@ -186,10 +210,27 @@ class forward_list {
   const_iterator cend() const noexcept { return const_iterator(nullptr); }
 
  private:
+  template <typename... Args>
+  Node* create_node(Args&&... args) {
+    Node* node = node_alloc_traits::allocate(node_alloc_, 1);
+    try {
+      node_alloc_traits::construct(node_alloc_, node, std::forward<Args>(args)...);
+    } catch (...) {
+      node_alloc_traits::deallocate(node_alloc_, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void destroy_node(Node* node) noexcept {
+    node_alloc_traits::destroy(node_alloc_, node);
+    node_alloc_traits::deallocate(node_alloc_, node, 1);
+  }
+
   void free_nodes(Node* node) noexcept {
     while (node) {
       Node* next = node->next;
-      delete node;
+      destroy_node(node);
       node = next;
     }
   }
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "mystd/array.hpp"
+#include "mystd/hashtable.hpp"
+#include "mystd/type_traits.hpp"
+
+namespace my {
+
+/// @brief The default hash of the frozen tables, usable in constant expressions (std::hash is not): integers and
+/// enums as they are (the table mixes the hash), strings 8 bytes per multiply, like std::hash.
+struct frozen_hash {
+  using is_transparent = void;
+
+  template <class T>
+    requires std::is_integral_v<T> || std::is_enum_v<T>
+  constexpr std::size_t operator()(T v) const noexcept {
+    return static_cast<std::size_t>(v);
+  }
+
+  /// A string of 8 bytes or more is read in words, the last one overlapping the one before; a shorter one in
+  /// two overlapping halves (4 to 7 bytes) or as its first, middle and last byte.
+  constexpr std::size_t operator()(std::string_view s) const noexcept {
+    const char* p = s.data();
+    const std::size_t n = s.size();
+    std::uint64_t h = n * 0x9e3779b97f4a7c15ULL;
+    if (n >= 8) {
+      for (std::size_t i = 0; i + 8 < n; i += 8) {
+        h = step_(h, load_<8>(p + i));
+      }
+      h = step_(h, load_<8>(p + n - 8));
+    } else if (n >= 4) {
+      h = step_(h, load_<4>(p) << 32 | load_<4>(p + n - 4));
+    } else if (n > 0) {
+      h = step_(h, std::uint64_t{static_cast<unsigned char>(p[0])} << 16 |
+                       std::uint64_t{static_cast<unsigned char>(p[n / 2])} << 8 | static_cast<unsigned char>(p[n - 1]));
+    }
+    return static_cast<std::size_t>(h);
+  }
+
+ private:
+  static constexpr std::uint64_t step_(std::uint64_t h, std::uint64_t word) noexcept {
+    return std::rotl((h ^ word) * 0xff51afd7ed558ccdULL, 31);
+  }
+
+  /// @return Bytes bytes at p as a native endian integer, the same at compile time and at run time
+  template <std::size_t Bytes>
+  static constexpr std::uint64_t load_(const char* p) noexcept {
+    using word = std::conditional_t<Bytes == 8, std::uint64_t, std::uint32_t>;
+    if (std::is_constant_evaluated()) {
+      word w = 0;
+      for (std::size_t i = 0; i < Bytes; ++i) {
+        const std::size_t shift = 8 * (std::endian::native == std::endian::little ? i : Bytes - 1 - i);
+        w |= static_cast<word>(static_cast<unsigned char>(p[i])) << shift;
+      }
+      return w;
+    }
+    word w;
+    std::memcpy(&w, p, Bytes);
+    return w;
+  }
+};
+
+/// @brief Immutable hash table over N values, built once (at compile time if the values are constants) with a
+/// minimal perfect hash in the CHD way (hash, displace and compress): the N values fill exactly N slots, and a
+/// lookup is one hash of the key, one displacement read and one key comparison. No heap, no chains, no probing.
+///
+/// The build: the mixed hash h of a key picks one of BUCKETS buckets (about two keys each). The buckets are placed
+/// from the biggest down: a bucket takes the first displacement d for which all of its keys land in free slots at
+/// (h ^ d * golden) * K scaled to [0, N). The single key buckets then take the remaining free slots directly. If a
+/// bucket finds no displacement, the build starts over with another seed for h. The scratch arrays live on the
+/// stack: meant for static tables of up to a few thousand values.
+///
+/// A key given twice, or two keys with the same Hash, throw std::invalid_argument: a compile error when the table
+/// is constexpr.
+/// @tparam Hash -- must be constexpr to build the table at compile time, see my::frozen_hash
+template <class Value, class Key, class KeyOfValue, std::size_t N, class Hash = frozen_hash,
+          class KeyEqual = std::equal_to<Key>>
+class frozen_hashtable {
+  static_assert(N > 0, "frozen_hashtable: a table needs at least one value");
+  static_assert(N < (std::size_t{1} << 32), "frozen_hashtable: too many values");
+
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = std::size_t;
+  using const_reference = const Value&;
+  using const_iterator = const Value*;
+  using iterator = const_iterator;
+
+  static constexpr size_type BUCKETS = std::bit_ceil((N + 1) / 2);  // a power of two: h % BUCKETS is a mask
+
+ private:
+  static constexpr std::uint32_t DIRECT = std::uint32_t{1} << 31;  // set: the rest is the slot of a lone key
+  static constexpr std::uint32_t MAX_DISPLACEMENT = 1 << 16;
+  static constexpr std::uint64_t MAX_SEEDS = 64;
+  static constexpr std::uint64_t GOLDEN = 0x9e3779b97f4a7c15ULL;
+
+  my::array<Value, N> items_;                      // in slot order
+  my::array<std::uint32_t, BUCKETS> displacement_;  // per bucket: d, or DIRECT | slot
+  std::uint64_t seed_ = 0;
+  Hash hasher;
+  KeyEqual equal;
+  KeyOfValue key_of_value;
+
+  static constexpr bool transparent_ = is_transparent_v<Hash> && is_transparent_v<KeyEqual>;
+
+  /// the seeded hash through detail::mix_hash, one round of the murmur3 finalizer: enough to spread integer keys
+  /// over the buckets, and a bucket that still collides is fixed by its displacement or a new seed
+  constexpr std::uint64_t mixed_(std::uint64_t hash) const noexcept {
+    return detail::mix_hash(hash ^ (seed_ * GOLDEN));
+  }
+
+  /// the top half of one multiply, scaled to [0, N) by another (no division): N < 2^32
+  static constexpr size_type slot_(std::uint64_t h, std::uint32_t d) noexcept {
+    return static_cast<size_type>((((h ^ (d * GOLDEN)) * 0xff51afd7ed558ccdULL) >> 32) * N >> 32);
+  }
+
+  /// @brief Builds the displacements with the current seed_ and stores the values at their slots.
+  /// @return false if some bucket found no displacement
+  constexpr bool place_(const my::array<Value, N>& values, const std::array<std::uint64_t, N>& hashes) {
+    std::array<std::uint64_t, N> h{};
+    std::array<size_type, BUCKETS + 1> start{};  // the keys of bucket b are members[start[b], start[b + 1])
+    for (size_type i = 0; i < N; ++i) {
+      h[i] = mixed_(hashes[i]);
+      ++start[h[i] % BUCKETS + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::array<size_type, N> members{};
+    std::array<size_type, BUCKETS> fill{};
+    for (size_type i = 0; i < N; ++i) {
+      const size_type b = h[i] % BUCKETS;
+      members[start[b] + fill[b]++] = i;
+    }
+
+    std::array<size_type, BUCKETS> order{};
+    std::iota(order.begin(), order.end(), size_type{0});
+    std::sort(order.begin(), order.end(), [&start](size_type a, size_type b) {
+      return start[a + 1] - start[a] > start[b + 1] - start[b];
+    });
+
+    std::array<bool, N> taken{};
+    std::array<size_type, N> slot_of{};
+    size_type next = 0;
+    for (; next < BUCKETS && start[order[next] + 1] - start[order[next]] > 1; ++next) {
+      const size_type b = order[next];
+      std::uint32_t d = 0;
+      for (; d < MAX_DISPLACEMENT; ++d) {
+        size_type placed = start[b];
+        for (; placed < start[b + 1] && !taken[slot_(h[members[placed]], d)]; ++placed) {
+          taken[slot_(h[members[placed]], d)] = true;  // so that the next keys of b avoid it too
+        }
+        if (placed == start[b + 1]) break;
+        for (size_type j = start[b]; j < placed; ++j) {
+          taken[slot_(h[members[j]], d)] = false;
+        }
+      }
+      if (d == MAX_DISPLACEMENT) return false;
+      displacement_[b] = d;
+      for (size_type j = start[b]; j < start[b + 1]; ++j) {
+        slot_of[members[j]] = slot_(h[members[j]], d);
+      }
+    }
+
+    // the lone keys take the free slots in order; empty buckets keep 0, their lookups compare against some value
+    size_type free = 0;
+    for (; next < BUCKETS && start[order[next] + 1] - start[order[next]] == 1; ++next) {
+      const size_type b = order[next];
+      while (taken[free]) {
+        ++free;
+      }
+      taken[free] = true;
+      slot_of[members[start[b]]] = free;
+      displacement_[b] = DIRECT | static_cast<std::uint32_t>(free);
+    }
+
+    for (size_type i = 0; i < N; ++i) {
+      items_[slot_of[i]] = values[i];
+    }
+    return true;
+  }
+
+  template <class K>
+  constexpr const_iterator find_(const K& k) const {
+    const std::uint64_t h = mixed_(hasher(k));
+    const std::uint32_t d = displacement_[h % BUCKETS];
+    const size_type displaced = slot_(h, d);  // computed either way: a select, not a branch the CPU must guess
+    const size_type slot = (d & DIRECT) ? d & ~DIRECT : displaced;
+    return equal(key_of_value(items_[slot]), k) ? items_.data() + slot : end();
+  }
+
+ public:
+  constexpr explicit frozen_hashtable(const my::array<Value, N>& values) {
+    std::array<std::uint64_t, N> hashes{};
+    std::array<size_type, N> by_hash{};
+    for (size_type i = 0; i < N; ++i) {
+      hashes[i] = hasher(key_of_value(values[i]));
+      by_hash[i] = i;
+    }
+    // keys with one hash share every bucket and slot, whatever the seed
+    std::sort(by_hash.begin(), by_hash.end(), [&hashes](size_type a, size_type b) { return hashes[a] < hashes[b]; });
+    for (size_type i = 1; i < N; ++i) {
+      if (hashes[by_hash[i - 1]] == hashes[by_hash[i]]) {
+        if (equal(key_of_value(values[by_hash[i - 1]]), key_of_value(values[by_hash[i]]))) {
+          throw std::invalid_argument("frozen_hashtable: duplicate key");
+        }
+        throw std::invalid_argument("frozen_hashtable: two keys with the same hash");
+      }
+    }
+
+    for (; seed_ < MAX_SEEDS; ++seed_) {
+      if (place_(values, hashes)) return;
+    }
+    throw std::invalid_argument("frozen_hashtable: no perfect hash found");
+  }
+
+  // lookup
+
+  constexpr const_iterator find(const key_type& k) const { return find_(k); }
+
+  /// @brief Heterogeneous lookup, if Hash and KeyEqual are transparent (e.g. const char* for std::string_view keys
+  /// with my::frozen_hash and std::equal_to<>). The same for count and contains.
+  template <class K>
+    requires transparent_
+  constexpr const_iterator find(const K& k) const {
+    return find_(k);
+  }
+
+  constexpr bool contains(const key_type& k) const { return find_(k) != end(); }
+
+  template <class K>
+    requires transparent_
+  constexpr bool contains(const K& k) const {
+    return find_(k) != end();
+  }
+
+  constexpr size_type count(const key_type& k) const { return contains(k); }
+
+  template <class K>
+    requires transparent_
+  constexpr size_type count(const K& k) const {
+    return contains(k);
+  }
+
+  // iterators, in slot order
+
+  constexpr const_iterator begin() const noexcept { return items_.data(); }
+  constexpr const_iterator end() const noexcept { return items_.data() + N; }
+  constexpr const_iterator cbegin() const noexcept { return begin(); }
+  constexpr const_iterator cend() const noexcept { return end(); }
+
+  // capacity
+
+  constexpr size_type size() const noexcept { return N; }
+  constexpr bool empty() const noexcept { return false; }
+  constexpr size_type bucket_count() const noexcept { return BUCKETS; }
+};
+
+}  // namespace my
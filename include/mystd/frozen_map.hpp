@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "mystd/array.hpp"
+#include "mystd/frozen_hashtable.hpp"
+
+namespace my {
+
+/// @brief Read-only map over a fixed set of N keys, e.g. opcodes or header names: built from a my::array of
+/// pairs, at compile time when constexpr, with a perfect hash (see my::frozen_hashtable). A lookup costs one
+/// hash and one key comparison, and nothing is allocated.
+///   constexpr my::array<std::pair<std::string_view, int>, 2> codes = {{"GET", 1}, {"PUT", 2}};
+///   constexpr my::frozen_map methods(codes);
+///   static_assert(methods.at("PUT") == 2);
+template <class Key, class Value, std::size_t N, class Hash = frozen_hash, class KeyEqual = std::equal_to<Key>>
+class frozen_map {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using size_type = std::size_t;
+
+ private:
+  struct KeyOfValue {
+    constexpr const Key& operator()(const value_type& v) const noexcept { return v.first; }
+  };
+
+  using Base = frozen_hashtable<value_type, Key, KeyOfValue, N, Hash, KeyEqual>;
+  Base table;
+
+  static constexpr bool transparent = is_transparent_v<Hash> && is_transparent_v<KeyEqual>;
+
+ public:
+  using const_reference = const value_type&;
+  using iterator = typename Base::iterator;
+  using const_iterator = typename Base::const_iterator;
+
+  /// @throw std::invalid_argument -- a key is given twice
+  constexpr explicit frozen_map(const my::array<value_type, N>& values) : table(values) {}
+
+  // lookup
+  constexpr const_iterator find(const key_type& k) const { return table.find(k); }
+
+  template <class K>
+    requires transparent
+  constexpr const_iterator find(const K& k) const {
+    return table.find(k);
+  }
+
+  constexpr bool contains(const key_type& k) const { return table.contains(k); }
+
+  template <class K>
+    requires transparent
+  constexpr bool contains(const K& k) const {
+    return table.contains(k);
+  }
+
+  constexpr size_type count(const key_type& k) const { return table.count(k); }
+
+  template <class K>
+    requires transparent
+  constexpr size_type count(const K& k) const {
+    return table.count(k);
+  }
+
+  /// @throw std::out_of_range -- k is not a key
+  constexpr const mapped_type& at(const key_type& k) const { return at_(table.find(k)); }
+
+  template <class K>
+    requires transparent
+  constexpr const mapped_type& at(const K& k) const {
+    return at_(table.find(k));
+  }
+
+  // capacity
+  constexpr size_type size() const noexcept { return table.size(); }
+
+  constexpr bool empty() const noexcept { return table.empty(); }
+
+  // iterators
+  constexpr const_iterator begin() const noexcept { return table.begin(); }
+
+  constexpr const_iterator end() const noexcept { return table.end(); }
+
+  constexpr const_iterator cbegin() const noexcept { return table.cbegin(); }
+
+  constexpr const_iterator cend() const noexcept { return table.cend(); }
+
+ private:
+  constexpr const mapped_type& at_(const_iterator it) const {
+    if (it == table.end()) throw std::out_of_range("frozen_map: key not found");
+    return it->second;
+  }
+};
+
+template <class Key, class Value, std::size_t N>
+frozen_map(const my::array<std::pair<Key, Value>, N>&) -> frozen_map<Key, Value, N>;
+
+}  // namespace my
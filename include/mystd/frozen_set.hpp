@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "mystd/array.hpp"
+#include "mystd/frozen_hashtable.hpp"
+
+namespace my {
+
+/// @brief Read-only set of N keys, built from a my::array at compile time when constexpr, with a perfect hash
+/// (see my::frozen_hashtable): a lookup is one hash and one comparison.
+template <class Key, std::size_t N, class Hash = frozen_hash, class KeyEqual = std::equal_to<Key>>
+class frozen_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = std::size_t;
+
+ private:
+  struct Identity {
+    constexpr const Key& operator()(const Key& k) const noexcept { return k; }
+  };
+
+  using Base = frozen_hashtable<Key, Key, Identity, N, Hash, KeyEqual>;
+  Base table;
+
+  static constexpr bool transparent = is_transparent_v<Hash> && is_transparent_v<KeyEqual>;
+
+ public:
+  using const_reference = const Key&;
+  using iterator = typename Base::iterator;
+  using const_iterator = typename Base::const_iterator;
+
+  /// @throw std::invalid_argument -- a key is given twice
+  constexpr explicit frozen_set(const my::array<Key, N>& keys) : table(keys) {}
+
+  // lookup
+  constexpr const_iterator find(const key_type& k) const { return table.find(k); }
+
+  template <class K>
+    requires transparent
+  constexpr const_iterator find(const K& k) const {
+    return table.find(k);
+  }
+
+  constexpr bool contains(const key_type& k) const { return table.contains(k); }
+
+  template <class K>
+    requires transparent
+  constexpr bool contains(const K& k) const {
+    return table.contains(k);
+  }
+
+  constexpr size_type count(const key_type& k) const { return table.count(k); }
+
+  template <class K>
+    requires transparent
+  constexpr size_type count(const K& k) const {
+    return table.count(k);
+  }
+
+  // capacity
+  constexpr size_type size() const noexcept { return table.size(); }
+
+  constexpr bool empty() const noexcept { return table.empty(); }
+
+  // iterators
+  constexpr const_iterator begin() const noexcept { return table.begin(); }
+
+  constexpr const_iterator end() const noexcept { return table.end(); }
+
+  constexpr const_iterator cbegin() const noexcept { return table.cbegin(); }
+
+  constexpr const_iterator cend() const noexcept { return table.cend(); }
+};
+
+template <class Key, std::size_t N>
+frozen_set(const my::array<Key, N>&) -> frozen_set<Key, N>;
+
+}  // namespace my
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/// @brief Growth policies for my::vector.
+///
+/// A policy is a type with
+/// - static size_t next_capacity(size_t capacity, size_t required, size_t element_size) noexcept,
+///   which must return a value >= required (so an empty vector always grows);
+/// - static constexpr bool remaps, true if the policy can own large buffers itself (map/unmap/remap/is_mapped).
+namespace my::growth {
+
+/// @brief capacity * 2
+struct doubling {
+  static constexpr bool remaps = false;
+
+  static constexpr size_t next_capacity(size_t capacity, size_t required, size_t) noexcept {
+    const size_t grown = capacity * 2;
+    return grown > required ? grown : required;
+  }
+};
+
+/// @brief capacity * 1.5, lets freed blocks be reused by later growth.
+struct one_and_half {
+  static constexpr bool remaps = false;
+
+  static constexpr size_t next_capacity(size_t capacity, size_t required, size_t) noexcept {
+    const size_t grown = capacity + capacity / 2;
+    return grown > required ? grown : required;
+  }
+};
+
+/// @brief Doubling for small buffers, huge page multiples for large ones.
+///
+/// Buffers of large_threshold bytes and more grow by 1.5x rounded up to huge_page_size. On Linux such buffers are
+/// taken directly from mmap and grown with mremap, which extends the mapping in place or moves pages without copying
+/// bytes. my::vector uses this only for trivially relocatable T with std::allocator.
+struct page_granular {
+  static constexpr size_t huge_page_size = size_t{2} << 20;  // 2 MiB
+  static constexpr size_t large_threshold = huge_page_size;
+
+#if defined(__linux__)
+  static constexpr bool remaps = true;
+#else
+  static constexpr bool remaps = false;
+#endif
+
+  static constexpr size_t round_up(size_t bytes, size_t granularity) noexcept {
+    return (bytes + granularity - 1) / granularity * granularity;
+  }
+
+  static constexpr size_t next_capacity(size_t capacity, size_t required, size_t element_size) noexcept {
+    if (capacity * element_size < large_threshold) {
+      const size_t grown = capacity * 2 > required ? capacity * 2 : required;
+      if (grown * element_size < large_threshold) {
+        return grown;
+      }
+    }
+    size_t grown = capacity + capacity / 2;
+    if (grown < required) grown = required;
+    return round_up(grown * element_size, huge_page_size) / element_size;
+  }
+
+  static constexpr bool is_mapped(size_t bytes) noexcept { return remaps && bytes >= large_threshold; }
+
+#if defined(__linux__)
+  static size_t mapping_size(size_t bytes) noexcept { return round_up(bytes, huge_page_size); }
+
+  static void* map(size_t bytes) {
+    void* p = ::mmap(nullptr, mapping_size(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+#if defined(MADV_HUGEPAGE)
+    ::madvise(p, mapping_size(bytes), MADV_HUGEPAGE);
+#endif
+    return p;
+  }
+
+  static void unmap(void* p, size_t bytes) noexcept { ::munmap(p, mapping_size(bytes)); }
+
+  static void* remap(void* p, size_t old_bytes, size_t new_bytes) {
+    if (mapping_size(old_bytes) == mapping_size(new_bytes)) return p;
+    void* np = ::mremap(p, mapping_size(old_bytes), mapping_size(new_bytes), MREMAP_MAYMOVE);
+    if (np == MAP_FAILED) throw std::bad_alloc();
+    return np;
+  }
+#endif
+};
+
+}  // namespace my::growth
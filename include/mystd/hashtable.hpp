@@ -1,24 +1,270 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "mystd/type_traits.hpp"
+
+/// @brief 1 instruments every my::hashtable (and the my::unordered_* built on it) with the counters of
+/// my::hashtable_stats. With the default 0 the hooks are empty and compile away, and stats() does not exist.
+#ifndef MYSTD_HASHTABLE_STATS
+#define MYSTD_HASHTABLE_STATS 0
+#endif
+
 namespace my {
 
 /// @brief The policy for map/set multimap/multiset.
 enum class InsertPolicy { UniqueKeys, AllowDuplicates };
 
+/// @brief Transparent hash for string keys: std::string, std::string_view and const char* hash alike, so
+/// my::unordered_map<std::string, V, string_hash, std::equal_to<>> is searched by string_view without a copy.
+struct string_hash {
+  using is_transparent = void;
+
+  std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+namespace detail {
+
+/// @brief Spreads the entropy of h over the bits, so that any subset of them can be used as an index. std::hash of
+/// integers is the identity, sequential keys differ only in the low bits. This is the first round of the murmur3
+/// finalizer (xorshift, multiply, xorshift: a bijection), not the full two round one: the multiply carries every
+/// bit upwards and the shifts bring the high bits down, but its avalanche is weaker (a flipped input bit flips
+/// fewer than half of the output bits).
+constexpr std::size_t mix_hash(std::size_t h) noexcept {
+  std::uint64_t x = h;
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return static_cast<std::size_t>(x);
+}
+
+/// @brief Hint to bring the cache line of p into the cache, no-op if the compiler has no builtin for it.
+inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+
+}  // namespace detail
+
+/// @brief How my::hashtable maps a hash to a bucket and which bucket counts it uses.
+///
+/// A policy has three static functions:
+/// - mix(h): applied once to the user hash, the result is stored in the node and compared on lookup;
+/// - bucket_count(n): the bucket count used when n buckets are requested;
+/// - index(h, count): the bucket of a mixed hash h.
+namespace bucket_policy {
+
+/// @brief Any bucket count, index = hash % count. The default.
+struct modulo {
+  static std::size_t mix(std::size_t h) noexcept { return h; }
+  static std::size_t bucket_count(std::size_t n) noexcept { return std::max<std::size_t>(n, 1); }
+  static std::size_t index(std::size_t h, std::size_t count) noexcept { return h % count; }
+};
+
+/// @brief Prime bucket counts, index = hash % count: every bit of a poor hash (e.g. multiples of 8) takes part.
+struct prime {
+  static std::size_t mix(std::size_t h) noexcept { return h; }
+
+  static std::size_t bucket_count(std::size_t n) noexcept {
+    for (n = std::max<std::size_t>(n, 2);; ++n) {
+      bool is_prime = true;
+      for (std::size_t d = 2; d * d <= n && is_prime; ++d) {
+        is_prime = n % d != 0;
+      }
+      if (is_prime) return n;
+    }
+  }
+
+  static std::size_t index(std::size_t h, std::size_t count) noexcept { return h % count; }
+};
+
+/// @brief Power of two bucket counts, index = mixed hash & (count - 1): no division on the lookup path.
+/// The hash is mixed first, masking alone would keep only the low bits of the user hash.
+struct power_of_two {
+  static std::size_t mix(std::size_t h) noexcept { return detail::mix_hash(h); }
+  static std::size_t bucket_count(std::size_t n) noexcept { return std::bit_ceil(std::max<std::size_t>(n, 1)); }
+  static std::size_t index(std::size_t h, std::size_t count) noexcept { return h & (count - 1); }
+};
+
+/// @brief Base's bucket counts and mapping, and next to its head pointer every bucket holds a 64 bit filter with
+/// one bit per hash of its chain: a lookup whose bit is clear rejects the bucket without touching a node, so a
+/// miss walks a chain of one node about 1 time in 64. Buckets take 16 bytes instead of 8.
+template <class Base = modulo>
+struct fingerprinted : Base {
+  static constexpr bool fingerprints = true;
+};
+
+}  // namespace bucket_policy
+
+/// @brief When my::hashtable moves its nodes to a bigger bucket array once the load factor is exceeded.
+namespace rehash_policy {
+
+/// @brief All nodes in one go, inside the insert that crossed the load factor. The default.
+struct stop_the_world {};
+
+/// @brief The way of Redis' dict: the insert that crosses the load factor only allocates the new bucket array,
+/// then every insert, find and erase moves up to Step non-empty buckets of the old array (visiting at most
+/// 10 * Step empty ones) until it is drained. Meanwhile lookups search both arrays, inserts go to the new one.
+/// No operation pays for more than a few buckets, at the price of both arrays living together for a while.
+template <std::size_t Step = 4>
+struct incremental {
+  static_assert(Step > 0, "rehash_policy::incremental: Step must be positive");
+  static constexpr std::size_t step = Step;
+};
+
+}  // namespace rehash_policy
+
+/// @brief What an instrumented my::hashtable reports, see hashtable::stats().
+struct hashtable_stats {
+  std::size_t size = 0;
+  std::size_t bucket_count = 0;
+  std::vector<std::size_t> chain_histogram;  // [n] -- the number of buckets holding n nodes
+  std::size_t max_chain = 0;
+  std::size_t lookups = 0;     // find, count, contains, erase and the key lookups of inserts
+  std::size_t probes = 0;      // nodes compared by those lookups
+  std::size_t max_probes = 0;  // by a single lookup
+  std::size_t rehashes = 0;    // new bucket arrays, rehash(n) included
+  std::chrono::nanoseconds rehash_time{0};  // the migration steps of an incremental rehash included
+  std::size_t node_allocations = 0;
+  std::size_t bucket_allocations = 0;  // of whole bucket arrays
+
+  double load_factor() const noexcept { return bucket_count ? static_cast<double>(size) / bucket_count : 0; }
+  double probes_per_lookup() const noexcept { return lookups ? static_cast<double>(probes) / lookups : 0; }
+
+  /// @brief A few human readable lines, the histogram as chain length:buckets for the non-zero entries.
+  void dump(std::ostream& os) const {
+    os << "size " << size << ", buckets " << bucket_count << ", load factor " << load_factor() << '\n'
+       << "chains: max " << max_chain << ", histogram";
+    for (std::size_t n = 0; n < chain_histogram.size(); ++n) {
+      if (chain_histogram[n] != 0) os << ' ' << n << ':' << chain_histogram[n];
+    }
+    os << '\n'
+       << "lookups " << lookups << ", probes per lookup " << probes_per_lookup() << ", max probes " << max_probes
+       << '\n'
+       << "rehashes " << rehashes << ", rehash time " << rehash_time.count() << " ns\n"
+       << "allocations: nodes " << node_allocations << ", bucket arrays " << bucket_allocations << '\n';
+  }
+};
+
+namespace detail {
+
+/// @brief The counters of my::hashtable: empty, and every hook a no-op, unless Enabled.
+template <bool Enabled>
+struct hashtable_counters {
+  struct timer {};
+
+  void lookup(std::size_t) const noexcept {}
+  void node_allocated() noexcept {}
+  void buckets_allocated() noexcept {}
+  void rehashed() noexcept {}
+  timer time_rehash() noexcept { return {}; }
+  void swap(hashtable_counters&) noexcept {}
+};
+
+template <>
+struct hashtable_counters<true> {
+  /// A relaxed load and store rather than fetch_add: no locked instruction on the lookup path, and const lookups,
+  /// which may run concurrently, now and then lose an increment instead of racing.
+  class counter {
+    std::atomic<std::size_t> n_{0};
+
+   public:
+    void add(std::size_t d) noexcept { n_.store(n_.load(std::memory_order_relaxed) + d, std::memory_order_relaxed); }
+    void max(std::size_t v) noexcept {
+      if (v > n_.load(std::memory_order_relaxed)) n_.store(v, std::memory_order_relaxed);
+    }
+    std::size_t get() const noexcept { return n_.load(std::memory_order_relaxed); }
+    void swap(counter& other) noexcept {
+      const std::size_t n = get();
+      n_.store(other.get(), std::memory_order_relaxed);
+      other.n_.store(n, std::memory_order_relaxed);
+    }
+  };
+
+  /// adds the time from its construction to its destruction to rehash_ns
+  class timer {
+    counter& rehash_ns_;
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+   public:
+    explicit timer(counter& rehash_ns) noexcept : rehash_ns_(rehash_ns) {}
+    timer(const timer&) = delete;
+    ~timer() {
+      rehash_ns_.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_)
+                         .count());
+    }
+  };
+
+  mutable counter lookups, probes, max_probes;
+  counter rehashes, rehash_ns, node_allocations, bucket_allocations;
+
+  void lookup(std::size_t n) const noexcept {
+    lookups.add(1);
+    probes.add(n);
+    max_probes.max(n);
+  }
+  void node_allocated() noexcept { node_allocations.add(1); }
+  void buckets_allocated() noexcept { bucket_allocations.add(1); }
+  void rehashed() noexcept { rehashes.add(1); }
+  timer time_rehash() noexcept { return timer(rehash_ns); }
+
+  void swap(hashtable_counters& other) noexcept {
+    for (auto [a, b] : {std::pair{&lookups, &other.lookups}, {&probes, &other.probes},
+                        {&max_probes, &other.max_probes}, {&rehashes, &other.rehashes},
+                        {&rehash_ns, &other.rehash_ns}, {&node_allocations, &other.node_allocations},
+                        {&bucket_allocations, &other.bucket_allocations}}) {
+      a->swap(*b);
+    }
+  }
+
+  void fill(hashtable_stats& s) const noexcept {
+    s.lookups = lookups.get();
+    s.probes = probes.get();
+    s.max_probes = max_probes.get();
+    s.rehashes = rehashes.get();
+    s.rehash_time = std::chrono::nanoseconds(rehash_ns.get());
+    s.node_allocations = node_allocations.get();
+    s.bucket_allocations = bucket_allocations.get();
+  }
+};
+
+}  // namespace detail
+
 /// @brief The core of others hash tables based data structures.
 /// @tparam Value
 /// @tparam Key
-/// @tparam KeyOfValue -- rule how to extract Key
+/// @tparam KeyOfValue -- rule how to get Key from Value
 /// @tparam Hash -- rule how to compute hash of Key
 /// @tparam KeyEqual -- rule how to equal to Key
 /// @tparam Policy -- rule if Key is unique or not
+/// @tparam BucketPolicy -- bucket counts and hash to bucket mapping, see my::bucket_policy
+/// @tparam RehashPolicy -- rehash_policy::stop_the_world or rehash_policy::incremental; with the latter find and
+/// erase may move nodes between buckets too, so like insert they invalidate iterators (not references)
+/// @tparam Stats -- collect the counters of stats(), MYSTD_HASHTABLE_STATS by default
 template <class Value, class Key, class KeyOfValue, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
-          InsertPolicy Policy = InsertPolicy::UniqueKeys, class Allocator = std::allocator<Value>>
+          InsertPolicy Policy = InsertPolicy::UniqueKeys, class Allocator = std::allocator<Value>,
+          class BucketPolicy = bucket_policy::modulo, class RehashPolicy = rehash_policy::stop_the_world,
+          bool Stats = MYSTD_HASHTABLE_STATS>
 class hashtable {
  public:
   using key_type = Key;
@@ -27,7 +273,7 @@ class hashtable {
   using const_reference = const Value&;
   using size_type = std::size_t;
 
-  static constexpr float max_load_factor = 0.75f;
+  static constexpr float default_max_load_factor = 0.75f;
   static constexpr size_type reallocation_factor = 2;
 
  private:
@@ -36,26 +282,241 @@ class hashtable {
     size_type hash;
     Node* next;
 
-    Node(const_reference v, size_type h, Node* n = nullptr) : value(v), hash(h), next(n) {}
+    template <class... Args>
+    explicit Node(size_type h, Args&&... args) : value(std::forward<Args>(args)...), hash(h), next(nullptr) {}
   };
 
   using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_allocator_type>;
+
+  static constexpr bool incremental_ = !std::is_same_v<RehashPolicy, rehash_policy::stop_the_world>;
+  static constexpr bool fingerprints_ = requires { requires BucketPolicy::fingerprints; };
+
+  struct filtered_bucket {
+    Node* head = nullptr;
+    std::uint64_t filter = 0;  // the fingerprint_ bits of the hashes in the chain
+  };
 
-  std::vector<Node*> buckets;
+  /// a chain head, with its filter for a bucket_policy::fingerprinted
+  using bucket_type = std::conditional_t<fingerprints_, filtered_bucket, Node*>;
+
+  std::vector<bucket_type> old_buckets;  // being drained by an incremental rehash, empty otherwise
+  std::vector<bucket_type> buckets;
+  size_type migrate_pos = 0;  // old_buckets before it are drained
   size_type size_ = 0;
+  float max_load_factor_ = default_max_load_factor;
   Hash hasher;
   KeyEqual equal;
   KeyOfValue key_of_value;
   node_allocator_type alloc;
+  [[no_unique_address]] detail::hashtable_counters<Stats> stats_;
+
+  static constexpr bool transparent_ = is_transparent_v<Hash> && is_transparent_v<KeyEqual>;
+
+  template <class K>
+  size_type hash_(const K& k) const {
+    return BucketPolicy::mix(hasher(k));
+  }
+
+  size_type index_(size_type h) const { return BucketPolicy::index(h, buckets.size()); }
+
+  static Node*& head_(bucket_type& b) noexcept {
+    if constexpr (fingerprints_) {
+      return b.head;
+    } else {
+      return b;
+    }
+  }
 
-  size_type get_index_(const key_type& k, size_type bucket_count) const { return hasher(k) % bucket_count; }
+  static Node* head_(const bucket_type& b) noexcept {
+    if constexpr (fingerprints_) {
+      return b.head;
+    } else {
+      return b;
+    }
+  }
+
+  /// one bit per hash, from the top 6 bits of the mixed hash: the multiply in mix_hash makes them depend on the
+  /// low bits of h, not on the same bits as the bucket index
+  static std::uint64_t fingerprint_(size_type h) noexcept {
+    return std::uint64_t{1} << (detail::mix_hash(h) >> (std::numeric_limits<size_type>::digits - 6));
+  }
+
+  /// @return false only if no node of b has the hash h
+  static bool may_contain_(const bucket_type& b, size_type h) noexcept {
+    if constexpr (fingerprints_) {
+      return (b.filter & fingerprint_(h)) != 0;
+    } else {
+      return true;
+    }
+  }
+
+  static void push_front_(bucket_type& b, Node* node) noexcept {
+    node->next = head_(b);
+    head_(b) = node;
+    if constexpr (fingerprints_) {
+      b.filter |= fingerprint_(node->hash);
+    }
+  }
+
+  /// @brief Rebuilds the filter of b from its chain, after a node left it.
+  static void refilter_(bucket_type& b) noexcept {
+    if constexpr (fingerprints_) {
+      b.filter = 0;
+      for (Node* node = b.head; node; node = node->next) {
+        b.filter |= fingerprint_(node->hash);
+      }
+    }
+  }
+
+  /// @return the not yet drained old bucket of h, or nullptr; iterators number it before the new buckets
+  const bucket_type* old_bucket_(size_type h, size_type& idx) const {
+    if constexpr (incremental_) {
+      if (!old_buckets.empty()) {
+        idx = BucketPolicy::index(h, old_buckets.size());
+        if (idx >= migrate_pos) return &old_buckets[idx];
+      }
+    }
+    return nullptr;
+  }
 
-  void rehash_() {
-    if (load_factor() > max_load_factor) {
-      rehash(buckets.size() * reallocation_factor);
+  /// @return true if the nodes were moved (stop_the_world) or the buckets swapped to old_buckets (incremental)
+  bool rehash_() {
+    if (load_factor() > max_load_factor_) {
+      if constexpr (incremental_) {
+        [[maybe_unused]] auto timer = stats_.time_rehash();
+        if (!old_buckets.empty()) {
+          migrate_all_();  // grown faster than drained
+        }
+        old_buckets.swap(buckets);
+        buckets.assign(BucketPolicy::bucket_count(old_buckets.size() * reallocation_factor), bucket_type{});
+        migrate_pos = 0;
+        stats_.rehashed();
+        stats_.buckets_allocated();
+      } else {
+        rehash(buckets.size() * reallocation_factor);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  /// @brief Moves the nodes of old bucket migrate_pos to the new array.
+  void migrate_bucket_() {
+    for (Node* node = head_(old_buckets[migrate_pos]); node;) {
+      Node* next = node->next;
+      push_front_(buckets[index_(node->hash)], node);
+      node = next;
+    }
+    old_buckets[migrate_pos++] = bucket_type{};
+  }
+
+  void finish_migration_() {
+    std::vector<bucket_type>().swap(old_buckets);
+    migrate_pos = 0;
+  }
+
+  /// @brief One bounded step of an incremental rehash, if one is running.
+  void migrate_step_() {
+    if constexpr (incremental_) {
+      if (old_buckets.empty()) return;
+      [[maybe_unused]] auto timer = stats_.time_rehash();
+      size_type moved = 0;
+      size_type empty_visits = 10 * RehashPolicy::step;
+      while (migrate_pos < old_buckets.size() && moved < RehashPolicy::step) {
+        if (head_(old_buckets[migrate_pos])) {
+          migrate_bucket_();
+          ++moved;
+        } else {
+          ++migrate_pos;
+          if (--empty_visits == 0) break;
+        }
+      }
+      if (migrate_pos == old_buckets.size()) {
+        finish_migration_();
+      }
     }
   }
 
+  void migrate_all_() {
+    while (migrate_pos < old_buckets.size()) {
+      migrate_bucket_();
+    }
+    finish_migration_();
+  }
+
+  /// @brief Copies the chains of src into dst, bucket by bucket, keeping their order.
+  void copy_buckets_(const std::vector<bucket_type>& src, std::vector<bucket_type>& dst) {
+    for (size_type i = 0; i < src.size(); ++i) {
+      Node** tail = &head_(dst[i]);
+      for (Node* node = head_(src[i]); node; node = node->next) {
+        Node* new_node = make_node_(node->hash, node->value);
+        *tail = new_node;
+        tail = &new_node->next;
+        ++size_;
+      }
+      if constexpr (fingerprints_) {
+        dst[i].filter = src[i].filter;
+      }
+    }
+  }
+
+  void destroy_buckets_(std::vector<bucket_type>& v) {
+    for (const bucket_type& b : v) {
+      Node* node = head_(b);
+      while (node) {
+        Node* tmp = node->next;
+        destroy_node_(node);
+        node = tmp;
+      }
+    }
+  }
+
+  /// @brief Allocates a node and constructs its value from args, the node is not linked.
+  template <class... Args>
+  Node* make_node_(size_type h, Args&&... args) {
+    Node* node = node_traits::allocate(alloc, 1);
+    stats_.node_allocated();
+    try {
+      node_traits::construct(alloc, node, h, std::forward<Args>(args)...);
+    } catch (...) {
+      node_traits::deallocate(alloc, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void destroy_node_(Node* node) noexcept {
+    node_traits::destroy(alloc, node);
+    node_traits::deallocate(alloc, node, 1);
+  }
+
+  /// @return the node with key k and hash h and its iterator index, or a null node
+  template <class K>
+  std::pair<Node*, size_type> find_node_(const K& k, size_type h) const {
+    size_type probes = 0;
+    size_type old_idx;
+    if (const bucket_type* old = old_bucket_(h, old_idx); old && may_contain_(*old, h)) {
+      for (Node* node = head_(*old); node; node = node->next) {
+        ++probes;
+        if (node->hash == h && equal(key_of_value(node->value), k)) {
+          stats_.lookup(probes);
+          return {node, old_idx};
+        }
+      }
+    }
+    size_type idx = index_(h);
+    for (Node* node = may_contain_(buckets[idx], h) ? head_(buckets[idx]) : nullptr; node; node = node->next) {
+      ++probes;
+      if (node->hash == h && equal(key_of_value(node->value), k)) {
+        stats_.lookup(probes);
+        return {node, old_buckets.size() + idx};
+      }
+    }
+    stats_.lookup(probes);
+    return {nullptr, 0};
+  }
+
  public:
   template <bool IsConst>
   class iterator_basic {
@@ -65,21 +526,32 @@ class hashtable {
     using pointer = std::conditional_t<IsConst, const Value*, Value*>;
     using reference = std::conditional_t<IsConst, const Value&, Value&>;
     using difference_type = std::ptrdiff_t;
-    using BucketsVector = std::conditional_t<IsConst, const std::vector<Node*>, std::vector<Node*>>;
+    using BucketsVector = std::conditional_t<IsConst, const std::vector<bucket_type>, std::vector<bucket_type>>;
 
    private:
     Node* node;
+    BucketsVector* old_buckets;
     BucketsVector* buckets;
-    size_type bucket_idx;
+    size_type bucket_idx;  // the old buckets first, then the new ones
+
+    size_type bucket_total() const { return old_buckets->size() + buckets->size(); }
+
+    Node* bucket_at(size_type i) const {
+      return head_(i < old_buckets->size() ? (*old_buckets)[i] : (*buckets)[i - old_buckets->size()]);
+    }
 
     void skip_empty() {
-      while (!node && bucket_idx + 1 < buckets->size()) {
-        node = (*buckets)[++bucket_idx];
+      while (!node && bucket_idx + 1 < bucket_total()) {
+        node = bucket_at(++bucket_idx);
+      }
+      if (!node) {
+        bucket_idx = bucket_total();  // end()
       }
     }
 
    public:
-    iterator_basic(Node* n, BucketsVector* b, size_type i) : node(n), buckets(b), bucket_idx(i) {
+    iterator_basic(Node* n, BucketsVector* o, BucketsVector* b, size_type i)
+        : node(n), old_buckets(o), buckets(b), bucket_idx(i) {
       if (!node) {
         skip_empty();
       }
@@ -94,9 +566,6 @@ class hashtable {
         node = node->next;
         if (!node) {
           skip_empty();
-          if (!node) {
-            bucket_idx = buckets->size();
-          }
         }
       }
       return *this;
@@ -111,30 +580,111 @@ class hashtable {
   using iterator = iterator_basic<false>;
   using const_iterator = iterator_basic<true>;
 
+  /// @brief Owns a node taken out of a table by extract. insert links it into a table of the same type, whose
+  /// allocator compares equal, with its stored hash: the element is neither moved nor copied, nothing is
+  /// allocated or hashed. A node that is never inserted is destroyed with the handle.
+  class node_type {
+   public:
+    using value_type = Value;
+    using allocator_type = Allocator;
+
+    node_type() noexcept = default;
+
+    node_type(node_type&& other) noexcept
+        : node_(std::exchange(other.node_, nullptr)), alloc_(std::move(other.alloc_)) {}
+
+    node_type& operator=(node_type&& other) noexcept {
+      if (this != &other) {
+        reset_();
+        node_ = std::exchange(other.node_, nullptr);
+        alloc_ = std::move(other.alloc_);
+      }
+      return *this;
+    }
+
+    ~node_type() { reset_(); }
+
+    bool empty() const noexcept { return node_ == nullptr; }
+    explicit operator bool() const noexcept { return node_ != nullptr; }
+
+    /// the key stays as it is: insert reuses the hash stored in the node
+    value_type& value() const noexcept { return node_->value; }
+
+   private:
+    friend class hashtable;
+
+    Node* node_ = nullptr;
+    std::optional<node_allocator_type> alloc_;  // a default constructed allocator may be costly (a new pool)
+
+    node_type(Node* node, const node_allocator_type& alloc) : node_(node), alloc_(alloc) {}
+
+    void reset_() noexcept {
+      if (node_) {
+        node_traits::destroy(*alloc_, node_);
+        node_traits::deallocate(*alloc_, node_, 1);
+        node_ = nullptr;
+      }
+    }
+  };
+
+  /// @brief What insert(node_type&&) did: the element of the key and, if nothing was inserted, the node back.
+  struct insert_return_type {
+    iterator position;
+    bool inserted;
+    node_type node;
+  };
+
+ private:
+  iterator make_iterator_(Node* node, size_type idx) { return iterator(node, &old_buckets, &buckets, idx); }
+
+  const_iterator make_iterator_(Node* node, size_type idx) const {
+    return const_iterator(node, &old_buckets, &buckets, idx);
+  }
+
+  /// @brief The head of the first bucket, an iterator built with a null node starts after its bucket.
+  Node* first_bucket_() const {
+    if (!old_buckets.empty()) return head_(old_buckets[0]);
+    return buckets.empty() ? nullptr : head_(buckets[0]);
+  }
+
+ public:
   // ctor
   explicit hashtable(size_type bucket_count = 8)
-      : buckets(bucket_count, nullptr), size_(0), hasher(), equal(), key_of_value(), alloc() {}
+      : buckets(BucketPolicy::bucket_count(bucket_count), bucket_type{}),
+        size_(0),
+        hasher(),
+        equal(),
+        key_of_value(),
+        alloc() {
+    stats_.buckets_allocated();
+  }
+
+  /// @brief Inserts [first, last). A forward range is measured first and the buckets reserved for all of it, so
+  /// the load does not go through a rehash per doubling.
+  template <std::input_iterator It>
+  hashtable(It first, It last) : hashtable() {
+    if constexpr (std::forward_iterator<It>) {
+      reserve(std::distance(first, last));
+    }
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
 
   // copy
   hashtable(const hashtable& other)
-      : buckets(other.buckets.size(), nullptr),
+      : old_buckets(other.old_buckets.size(), bucket_type{}),
+        buckets(other.buckets.size(), bucket_type{}),
+        migrate_pos(other.migrate_pos),
         size_(0),
+        max_load_factor_(other.max_load_factor_),
         hasher(other.hasher),
         equal(other.equal),
         key_of_value(other.key_of_value),
         alloc(other.alloc) {
-    for (size_type i = 0; i < other.buckets.size(); ++i) {
-      Node* src = other.buckets[i];
-      Node** dst = &buckets[i];
-      while (src) {
-        Node* new_node = alloc.allocate(1);
-        std::allocator_traits<node_allocator_type>::construct(alloc, new_node, src->value, src->hash);
-        *dst = new_node;
-        dst = &new_node->next;
-        src = src->next;
-        ++size_;
-      }
-    }
+    stats_.buckets_allocated();
+    copy_buckets_(other.old_buckets, old_buckets);
+    copy_buckets_(other.buckets, buckets);
   }
 
   // copy assign
@@ -164,112 +714,384 @@ class hashtable {
   ~hashtable() { clear(); }
 
   void clear() {
-    for (Node* node : buckets) {
-      while (node) {
-        Node* tmp = node->next;
-        std::allocator_traits<node_allocator_type>::destroy(alloc, node);
-        alloc.deallocate(node, 1);
-        node = tmp;
-      }
-    }
+    destroy_buckets_(old_buckets);
+    destroy_buckets_(buckets);
     // leave the object in consistent state
-    buckets.assign(buckets.size(), nullptr);
+    finish_migration_();
+    buckets.assign(buckets.size(), bucket_type{});
     size_ = 0;
   }
 
-  size_type count(const key_type& k) const {
-    size_type h = hasher(k);
-    size_type idx = h % buckets.size();
+  size_type count(const key_type& k) const { return count_(k); }
 
-    auto cur = buckets[idx];
+  /// @brief Heterogeneous lookup, if Hash and KeyEqual are transparent: k is any type they accept (e.g. a
+  /// std::string_view for std::string keys), no key_type is built. Same for find, contains and erase.
+  template <class K>
+    requires transparent_
+  size_type count(const K& k) const {
+    return count_(k);
+  }
 
+  bool contains(const key_type& k) const { return find_node_(k, hash_(k)).first != nullptr; }
+
+  template <class K>
+    requires transparent_
+  bool contains(const K& k) const {
+    return find_node_(k, hash_(k)).first != nullptr;
+  }
+
+ private:
+  template <class K>
+  size_type count_(const K& k) const {
+    size_type h = hash_(k);
     size_type count = 0;
-    while (cur) {
-      if (cur->hash == h && equal(key_of_value(cur->value), k)) {
-        ++count;
+    size_type probes = 0;
+    size_type old_idx;
+    for (const bucket_type* bucket : {old_bucket_(h, old_idx), &buckets[index_(h)]}) {
+      for (Node* cur = bucket && may_contain_(*bucket, h) ? head_(*bucket) : nullptr; cur; cur = cur->next) {
+        ++probes;
+        if (cur->hash == h && equal(key_of_value(cur->value), k)) {
+          ++count;
+        }
       }
-      cur = cur->next;
     }
+    stats_.lookup(probes);
     return count;
   }
 
-  std::pair<iterator, bool> insert(const_reference v) {
-    const key_type& k = key_of_value(v);
-    size_type h = hasher(k);
-    size_type idx = h % buckets.size();
+ public:
+  std::pair<iterator, bool> insert(const_reference v) { return emplace_key_(key_of_value(v), v); }
 
-    if constexpr (Policy == InsertPolicy::UniqueKeys) {
-      for (Node* node = buckets[idx]; node; node = node->next) {
-        if (node->hash == h && equal(key_of_value(node->value), k)) {
-          return {iterator(node, &buckets, idx), false};
+  std::pair<iterator, bool> insert(value_type&& v) { return emplace_key_(key_of_value(v), std::move(v)); }
+
+  /// @brief Constructs the value from args in a new node, then hashes its key. With unique keys the node is
+  /// destroyed again if the key is present: prefer try_emplace when the key is at hand.
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    migrate_step_();
+    Node* node = make_node_(0, std::forward<Args>(args)...);
+    try {
+      node->hash = hash_(key_of_value(node->value));
+      if constexpr (Policy == InsertPolicy::UniqueKeys) {
+        if (auto [found, idx] = find_node_(key_of_value(node->value), node->hash); found) {
+          destroy_node_(node);
+          return {make_iterator_(found, idx), false};
         }
       }
+    } catch (...) {
+      destroy_node_(node);
+      throw;
     }
+    return {link_(node), true};
+  }
 
-    Node* new_node = alloc.allocate(1);
-    std::allocator_traits<node_allocator_type>::construct(alloc, new_node, v, h, buckets[idx]);
-    buckets[idx] = new_node;
-    ++size_;
+  /// @brief Hashes k once; constructs a value from args only if k is not present (or keys may repeat).
+  /// args construct the whole value, e.g. (piecewise_construct, tuple(k), tuple(mapped args...)) for a pair.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+    return emplace_key_(k, std::forward<Args>(args)...);
+  }
 
-    rehash_();
+  iterator find(const key_type& k) { return find_(k); }
 
-    return {iterator(new_node, &buckets, idx), true};
+  template <class K>
+    requires transparent_
+  iterator find(const K& k) {
+    return find_(k);
   }
 
-  iterator find(const key_type& k) {
-    size_type h = hasher(k);
-    size_type idx = h % buckets.size();
-    for (Node* node = buckets[idx]; node; node = node->next) {
-      if (node->hash == h && equal(key_of_value(node->value), k)) {
-        return iterator(node, &buckets, idx);
+  /// @brief Never moves nodes, not even during an incremental rehash: concurrent const calls are safe.
+  const_iterator find(const key_type& k) const { return find_(k); }
+
+  template <class K>
+    requires transparent_
+  const_iterator find(const K& k) const {
+    return find_(k);
+  }
+
+  /// @return iterator to after removed element
+  iterator erase(const key_type& k) { return erase_(k); }
+
+  template <class K>
+    requires transparent_
+  iterator erase(const K& k) {
+    return erase_(k);
+  }
+
+  // node handles
+
+  /// @brief Unlinks the element of k (the first one, with repeated keys) without destroying it.
+  /// @return its node, an empty node_type if k is missing
+  node_type extract(const key_type& k) { return extract_(k); }
+
+  template <class K>
+    requires transparent_
+  node_type extract(const K& k) {
+    return extract_(k);
+  }
+
+  /// @brief Links the node of nh, which must come from a table with an equal allocator. With unique keys and the
+  /// key already present nothing is inserted, the node is given back in the result.
+  insert_return_type insert(node_type&& nh) {
+    if (nh.empty()) return {end(), false, node_type()};
+    migrate_step_();
+    if constexpr (Policy == InsertPolicy::UniqueKeys) {
+      if (auto [found, idx] = find_node_(key_of_value(nh.node_->value), nh.node_->hash); found) {
+        return {make_iterator_(found, idx), false, std::move(nh)};
       }
     }
-    return end();
+    return {link_(std::exchange(nh.node_, nullptr)), true, node_type()};
   }
 
-  /// @return iterator to after removed element
-  iterator erase(const key_type& k) {
-    size_type h = hasher(k);
-    size_type idx = h % buckets.size();
+  /// @brief Relinks into this table the nodes of other whose key it does not hold yet (all of them with repeated
+  /// keys), with their stored hashes: a rebalance that allocates, copies and hashes nothing. The nodes of present
+  /// keys stay in other. other must have an equal allocator.
+  void merge(hashtable& other) {
+    if (&other == this) return;
+    auto take_from = [&](std::vector<bucket_type>& v, size_type first) {
+      for (size_type i = first; i < v.size(); ++i) {
+        Node** link = &head_(v[i]);
+        while (Node* node = *link) {
+          if constexpr (Policy == InsertPolicy::UniqueKeys) {
+            if (find_node_(key_of_value(node->value), node->hash).first) {
+              link = &node->next;
+              continue;
+            }
+          }
+          *link = node->next;
+          --other.size_;
+          migrate_step_();
+          link_(node);
+        }
+        refilter_(v[i]);
+      }
+    };
+    take_from(other.old_buckets, other.migrate_pos);
+    take_from(other.buckets, 0);
+  }
+
+  void merge(hashtable&& other) { merge(other); }
+
+ private:
+  template <class K>
+  iterator find_(const K& k) {
+    migrate_step_();
+    auto [node, idx] = find_node_(k, hash_(k));
+    return node ? make_iterator_(node, idx) : end();
+  }
+
+  template <class K>
+  const_iterator find_(const K& k) const {
+    auto [node, idx] = find_node_(k, hash_(k));
+    return node ? make_iterator_(node, idx) : end();
+  }
+
+  template <class K>
+  iterator erase_(const K& k) {
+    migrate_step_();
+    size_type idx;
+    Node* next;
+    Node* node = unlink_(k, idx, next);
+    if (!node) return end();
+    destroy_node_(node);
+    return make_iterator_(next, idx);  // if the bucket became empty the iterator moves on from it
+  }
+
+  template <class K>
+  node_type extract_(const K& k) {
+    migrate_step_();
+    size_type idx;
+    Node* next;
+    Node* node = unlink_(k, idx, next);
+    return node ? node_type(node, alloc) : node_type();
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace_key_(const key_type& k, Args&&... args) {
+    migrate_step_();
+    return emplace_hashed_(k, hash_(k), std::forward<Args>(args)...);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace_hashed_(const key_type& k, size_type h, Args&&... args) {
+    if constexpr (Policy == InsertPolicy::UniqueKeys) {
+      if (auto [node, idx] = find_node_(k, h); node) {
+        return {make_iterator_(node, idx), false};
+      }
+    }
+    return {link_(make_node_(h, std::forward<Args>(args)...)), true};
+  }
+
+  /// @brief Links node in front of its bucket, then grows the table if needed.
+  iterator link_(Node* node) {
+    size_type idx = index_(node->hash);
+    push_front_(buckets[idx], node);
+    ++size_;
+
+    if (rehash_()) {
+      if constexpr (incremental_) {
+        return make_iterator_(node, idx);  // its bucket is now old_buckets[idx]
+      } else {
+        idx = index_(node->hash);
+      }
+    }
+    return make_iterator_(node, old_buckets.size() + idx);
+  }
+
+  /// @brief Takes the node of k (the first one, with repeated keys) out of its old or new bucket, the caller owns
+  /// it then.
+  /// @param idx, next -- set to the iterator index of its bucket and to the node after it
+  /// @return the node, or nullptr if k is missing
+  template <class K>
+  Node* unlink_(const K& k, size_type& idx, Node*& next) {
+    size_type h = hash_(k);
+    size_type probes = 0;
+    if (old_bucket_(h, idx)) {
+      if (Node* node = unlink_from_(old_buckets[idx], h, k, probes, next)) return node;
+    }
+    const size_type new_idx = index_(h);
+    idx = old_buckets.size() + new_idx;
+    if (Node* node = unlink_from_(buckets[new_idx], h, k, probes, next)) return node;
+    stats_.lookup(probes);
+    return nullptr;
+  }
 
-    Node* cur = buckets[idx];
+  /// @param probes -- nodes compared so far, reported once k is found
+  template <class K>
+  Node* unlink_from_(bucket_type& bucket, size_type h, const K& k, size_type& probes, Node*& next) {
+    Node* cur = may_contain_(bucket, h) ? head_(bucket) : nullptr;
     Node* prev = nullptr;
 
     while (cur) {
+      ++probes;
       if (cur->hash == h && equal(key_of_value(cur->value), k)) {
-        Node* next = cur->next;
+        stats_.lookup(probes);
+        next = cur->next;
         if (prev) {
           prev->next = next;
         } else {  // first element case
-          buckets[idx] = next;
+          head_(bucket) = next;
         }
-
-        std::allocator_traits<node_allocator_type>::destroy(alloc, cur);
-        alloc.deallocate(cur, 1);
         --size_;
-
-        if (next) {
-          return iterator(next, &buckets, idx);
-        } else {  // if bucket become empty find from start
-          return iterator(nullptr, &buckets, idx);
-        }
+        refilter_(bucket);
+        return cur;
       }
       prev = cur;
       cur = cur->next;
     }
+    return nullptr;
+  }
+
+ public:
+  // batches
 
-    return end();
+  /// @brief out[i] = find(first[i]) for every key of [first, last). The keys are hashed and their buckets and
+  /// first nodes prefetched BATCH at a time before any chain is walked, so the cache misses of a batch overlap
+  /// instead of being paid one after another.
+  /// @return out past the last iterator written
+  template <std::random_access_iterator It, class OutputIt>
+  OutputIt find_batch(It first, It last, OutputIt out) {
+    migrate_step_();
+    resolve_batch_(first, last, [&](Node* node, size_type idx) {
+      *out = node ? make_iterator_(node, idx) : end();
+      ++out;
+    });
+    return out;
   }
 
+  /// @brief out[i] = contains(first[i]), batched as find_batch.
+  template <std::random_access_iterator It, class OutputIt>
+  OutputIt contains_batch(It first, It last, OutputIt out) const {
+    resolve_batch_(first, last, [&](Node* node, size_type) {
+      *out = node != nullptr;
+      ++out;
+    });
+    return out;
+  }
+
+  /// @brief Inserts the values of [first, last) as insert(first[i]) in order, hashing and prefetching BATCH of
+  /// them ahead of the inserts.
+  /// @return number of values inserted
+  template <std::random_access_iterator It>
+  size_type insert_batch(It first, It last) {
+    size_type inserted = 0;
+    size_type hashes[BATCH];
+    while (first != last) {
+      const size_type n = std::min<size_type>(BATCH, last - first);
+      for (size_type i = 0; i < n; ++i) {
+        const value_type& v = first[i];  // a converted temporary lives as long as v
+        hashes[i] = hash_(key_of_value(v));
+        detail::prefetch(&buckets[index_(hashes[i])]);
+      }
+      for (size_type i = 0; i < n; ++i) {
+        migrate_step_();
+        const value_type& v = first[i];
+        inserted += emplace_hashed_(key_of_value(v), hashes[i], v).second;
+      }
+      first += n;
+    }
+    return inserted;
+  }
+
+ private:
+  static constexpr size_type BATCH = 16;
+
+  /// @brief Calls visit(node, iterator index) for every key of [first, last), node is null for a missing key.
+  /// A two stage pipeline over chunks of BATCH keys: while a chunk is resolved, the buckets of the next one are
+  /// on their way; its node prefetches are issued once the buckets arrived, one chunk later.
+  template <class It, class Visit>
+  void resolve_batch_(It first, It last, Visit visit) const {
+    size_type hashes[2][BATCH];
+    const bucket_type* heads[2][BATCH];
+    auto stage = [&](It chunk, size_type n, size_type slot) {
+      for (size_type i = 0; i < n; ++i) {
+        hashes[slot][i] = hash_(chunk[i]);
+        heads[slot][i] = &buckets[index_(hashes[slot][i])];
+        detail::prefetch(heads[slot][i]);
+      }
+    };
+
+    size_type n = std::min<size_type>(BATCH, last - first);
+    stage(first, n, 0);
+    for (size_type cur = 0; n != 0; cur ^= 1) {
+      const It next = first + n;
+      const size_type next_n = std::min<size_type>(BATCH, last - next);
+      for (size_type i = 0; i < n; ++i) {
+        if (Node* head = head_(*heads[cur][i]); head && may_contain_(*heads[cur][i], hashes[cur][i])) {
+          detail::prefetch(head);
+        }
+      }
+      stage(next, next_n, cur ^ 1);
+      for (size_type i = 0; i < n; ++i) {
+        if (rehashing()) {
+          auto [node, idx] = find_node_(first[i], hashes[cur][i]);
+          visit(node, idx);
+          continue;
+        }
+        Node* node = may_contain_(*heads[cur][i], hashes[cur][i]) ? head_(*heads[cur][i]) : nullptr;
+        size_type probes = node != nullptr;
+        while (node && !(node->hash == hashes[cur][i] && equal(key_of_value(node->value), first[i]))) {
+          node = node->next;
+          probes += node != nullptr;
+        }
+        stats_.lookup(probes);
+        visit(node, heads[cur][i] - buckets.data());
+      }
+      first = next;
+      n = next_n;
+    }
+  }
+
+ public:
   // iterators
-  iterator begin() { return iterator(nullptr, &buckets, 0); }
-  iterator end() { return iterator(nullptr, &buckets, buckets.size()); }
+  iterator begin() { return make_iterator_(first_bucket_(), 0); }
+  iterator end() { return make_iterator_(nullptr, old_buckets.size() + buckets.size()); }
 
-  const_iterator begin() const { return const_iterator(nullptr, &buckets, 0); }
-  const_iterator end() const { return const_iterator(nullptr, &buckets, buckets.size()); }
+  const_iterator begin() const { return make_iterator_(first_bucket_(), 0); }
+  const_iterator end() const { return make_iterator_(nullptr, old_buckets.size() + buckets.size()); }
 
-  const_iterator cbegin() const { return const_iterator(nullptr, &buckets, 0); }
-  const_iterator cend() const { return const_iterator(nullptr, &buckets, buckets.size()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
 
   // capacity and others
 
@@ -279,15 +1101,72 @@ class hashtable {
 
   float load_factor() const { return static_cast<float>(size_) / buckets.size(); }
 
+  float max_load_factor() const noexcept { return max_load_factor_; }
+
+  /// @brief The load factor above which an insert grows the table; grows it right away if it is already above.
+  void max_load_factor(float ml) {
+    if (!(ml > 0.0f)) throw std::invalid_argument("hashtable: max_load_factor must be positive");
+    max_load_factor_ = ml;
+    reserve(size_);
+  }
+
+  /// @brief Grows the buckets so that n elements fit under max_load_factor(): inserting up to n elements then
+  /// never rehashes. Never shrinks.
+  void reserve(size_type n) {
+    const auto count = static_cast<size_type>(std::ceil(static_cast<double>(n) / max_load_factor_));
+    if (count > buckets.size()) {
+      rehash(count);
+    }
+  }
+
+  /// @brief Rehashes to the fewest buckets that hold size() elements under max_load_factor(), e.g. after most of
+  /// the elements were erased.
+  void shrink_to_fit() { rehash(static_cast<size_type>(std::ceil(static_cast<double>(size_) / max_load_factor_))); }
+
+  /// @return true while an incremental rehash still has old buckets to drain
+  bool rehashing() const { return !old_buckets.empty(); }
+
+  /// @brief The counters since construction, plus the chain lengths of the buckets now (a walk over all of them).
+  /// Only with Stats, i.e. MYSTD_HASHTABLE_STATS.
+  hashtable_stats stats() const
+    requires Stats
+  {
+    hashtable_stats s;
+    stats_.fill(s);
+    s.size = size_;
+    s.bucket_count = buckets.size();
+    auto chains = [&s](const std::vector<bucket_type>& v, size_type from) {
+      for (size_type i = from; i < v.size(); ++i) {
+        size_type n = 0;
+        for (Node* node = head_(v[i]); node; node = node->next) {
+          ++n;
+        }
+        if (n >= s.chain_histogram.size()) s.chain_histogram.resize(n + 1);
+        ++s.chain_histogram[n];
+        s.max_chain = std::max(s.max_chain, n);
+      }
+    };
+    chains(old_buckets, migrate_pos);  // the drained ones are gone
+    chains(buckets, 0);
+    return s;
+  }
+
+  /// @brief Redistributes the nodes over BucketPolicy::bucket_count(new_count) buckets, all at once:
+  /// a running incremental rehash is finished first.
   void rehash(size_type new_count) {
-    std::vector<Node*> new_buckets(new_count, nullptr);
+    [[maybe_unused]] auto timer = stats_.time_rehash();
+    if (!old_buckets.empty()) {
+      migrate_all_();
+    }
+    new_count = BucketPolicy::bucket_count(new_count);
+    std::vector<bucket_type> new_buckets(new_count, bucket_type{});
+    stats_.rehashed();
+    stats_.buckets_allocated();
 
-    for (Node* node : buckets) {
-      while (node) {
+    for (const bucket_type& b : buckets) {
+      for (Node* node = head_(b); node;) {
         Node* next = node->next;
-        size_type idx = node->hash % new_count;
-        node->next = new_buckets[idx];
-        new_buckets[idx] = node;
+        push_front_(new_buckets[BucketPolicy::index(node->hash, new_count)], node);
         node = next;
       }
     }
@@ -296,16 +1175,29 @@ class hashtable {
   }
 
   void swap(hashtable& other) noexcept {
+    std::swap(old_buckets, other.old_buckets);
     std::swap(buckets, other.buckets);
+    std::swap(migrate_pos, other.migrate_pos);
     std::swap(size_, other.size_);
+    std::swap(max_load_factor_, other.max_load_factor_);
     std::swap(hasher, other.hasher);
     std::swap(equal, other.equal);
     std::swap(key_of_value, other.key_of_value);
     std::swap(alloc, other.alloc);
+    stats_.swap(other.stats_);
   }
 
   // ADL
   friend void swap(hashtable& a, hashtable& b) noexcept { a.swap(b); }
 };
 
+/// @brief my::hashtable with a bucket (and rehash, stats) policy, as a Table engine for unordered_map_base and
+/// unordered_set_base:
+/// unordered_map_base<K, V, Hash, Equal, Policy, Alloc, hashtable_with_buckets<bucket_policy::power_of_two>::type>
+template <class BucketPolicy, class RehashPolicy = rehash_policy::stop_the_world, bool Stats = MYSTD_HASHTABLE_STATS>
+struct hashtable_with_buckets {
+  template <class Value, class Key, class KeyOfValue, class Hash, class KeyEqual, InsertPolicy Policy, class Allocator>
+  using type = hashtable<Value, Key, KeyOfValue, Hash, KeyEqual, Policy, Allocator, BucketPolicy, RehashPolicy, Stats>;
+};
+
 }  // namespace my
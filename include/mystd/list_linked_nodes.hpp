@@ -2,16 +2,19 @@
 
 #include <initializer_list>
 #include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 
 namespace my::heapbased {
 
 /// @brief doubly linked list on linked nodes
-template <typename T>
+/// @tparam Allocator -- nodes are allocated with Allocator rebound to the node type
+template <typename T, typename Allocator = std::allocator<T>>
 class list {
  public:
   using value_type = T;
+  using allocator_type = Allocator;
   using reference = T&;
   using const_reference = const T&;
   using pointer = T*;
@@ -23,8 +26,15 @@ class list {
     value_type data{};
     Node* prev = nullptr;
     Node* next = nullptr;
+
+    template <typename... Args>
+    explicit Node(Args&&... args) : data(std::forward<Args>(args)...) {}
   };
 
+  using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+
+  node_allocator_type node_alloc_;
   Node* head_ = nullptr;
   Node* tail_ = nullptr;
   size_type size_ = 0;
@@ -90,10 +100,27 @@ class list {
     node_type* ptr_ = nullptr;
   };
 
+  template <typename... Args>
+  Node* create_node(Args&&... args) {
+    Node* node = node_alloc_traits::allocate(node_alloc_, 1);
+    try {
+      node_alloc_traits::construct(node_alloc_, node, std::forward<Args>(args)...);
+    } catch (...) {
+      node_alloc_traits::deallocate(node_alloc_, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void destroy_node(Node* node) noexcept {
+    node_alloc_traits::destroy(node_alloc_, node);
+    node_alloc_traits::deallocate(node_alloc_, node, 1);
+  }
+
   void free_nodes(Node* node) {
     while (node) {
       Node* next = node->next;
-      delete node;
+      destroy_node(node);
       node = next;
     }
     head_ = tail_ = nullptr;
@@ -109,14 +136,16 @@ class list {
   // ctor
   list() = default;
 
-  list(std::initializer_list<value_type> init) {
+  explicit list(const allocator_type& alloc) : node_alloc_(alloc) {}
+
+  list(std::initializer_list<value_type> init, const allocator_type& alloc = allocator_type()) : node_alloc_(alloc) {
     for (const auto& val : init) {
       push_back(val);
     }
   }
 
   // copy
-  list(const list& other) {
+  list(const list& other) : node_alloc_(node_alloc_traits::select_on_container_copy_construction(other.node_alloc_)) {
     for (const auto& val : other) {
       push_back(val);
     }
@@ -130,15 +159,17 @@ class list {
     return *this;
   }
 
-  // move
+  // move, the allocator is copied so the moved-from list can still allocate
   list(list&& other) noexcept
-      : head_(std::exchange(other.head_, nullptr)),
+      : node_alloc_(other.node_alloc_),
+        head_(std::exchange(other.head_, nullptr)),
         tail_(std::exchange(other.tail_, nullptr)),
         size_(std::exchange(other.size_, 0)) {}
 
   list& operator=(list&& other) noexcept {
     if (this != &other) {
       clear();
+      node_alloc_ = other.node_alloc_;
       head_ = std::exchange(other.head_, nullptr);
       tail_ = std::exchange(other.tail_, nullptr);
       size_ = std::exchange(other.size_, 0);
@@ -148,6 +179,8 @@ class list {
 
   ~list() { clear(); }
 
+  allocator_type get_allocator() const noexcept { return allocator_type(node_alloc_); }
+
   // element access
   reference front() {
     if (!head_) throw std::out_of_range("front() on empty list");
@@ -195,7 +228,7 @@ class list {
   // modifiers
   iterator insert(iterator pos, const_reference value) {
     Node* curr = pos.node();
-    Node* new_node = new Node{value};
+    Node* new_node = create_node(value);
 
     if (!curr) {  // insert at end
       new_node->prev = tail_;
@@ -237,7 +270,7 @@ class list {
     else
       tail_ = prev;
 
-    delete node;
+    destroy_node(node);
     --size_;
 
     return iterator(this, next);
@@ -262,6 +295,7 @@ class list {
   void clear() { free_nodes(head_); }
 
   void swap(list& other) noexcept {
+    std::swap(node_alloc_, other.node_alloc_);
     std::swap(head_, other.head_);
     std::swap(tail_, other.tail_);
     std::swap(size_, other.size_);
@@ -4,6 +4,7 @@
 #include <utility>
 
 #include "mystd/some_trees/rb_tree.hpp"
+#include "mystd/type_traits.hpp"
 
 namespace my {
 
@@ -27,6 +28,8 @@ class map_base {
  private:
   Tree tree{};
 
+  static constexpr bool transparent = is_transparent_v<typename Tree::key_compare>;
+
  public:
   // construct/copy/move/destruct
   map_base() = default;
@@ -128,6 +131,14 @@ class map_base {
 
   void erase(const key_type& key) { tree.erase(key); }
 
+  /// @brief With a transparent comparator in Tree (e.g. rb_tree<std::pair<Key, T>, KeyOfPair<Key, T>, std::less<>>)
+  /// erase and the lookups below take any key type comparable with Key, e.g. a std::string_view for std::string.
+  template <typename K>
+    requires transparent
+  void erase(const K& key) {
+    tree.erase(key);
+  }
+
   void swap(map_base& other) { std::swap(tree, other.tree); }
   // merge()
 
@@ -135,12 +146,51 @@ class map_base {
 
   size_type count(const key_type& key) { return tree.count(key); }
 
+  template <typename K>
+    requires transparent
+  size_type count(const K& key) {
+    return tree.count(key);
+  }
+
   iterator find(const key_type& key) { return tree.find(key); }
 
+  template <typename K>
+    requires transparent
+  iterator find(const K& key) {
+    return tree.find(key);
+  }
+
   bool contains(const key_type& key) { return tree.contains(key); }
 
-  // lower_bound()
-  // upper_bound()
+  template <typename K>
+    requires transparent
+  bool contains(const K& key) {
+    return tree.contains(key);
+  }
+
+  iterator lower_bound(const key_type& key) { return tree.lower_bound(key); }
+
+  template <typename K>
+    requires transparent
+  iterator lower_bound(const K& key) {
+    return tree.lower_bound(key);
+  }
+
+  iterator upper_bound(const key_type& key) { return tree.upper_bound(key); }
+
+  template <typename K>
+    requires transparent
+  iterator upper_bound(const K& key) {
+    return tree.upper_bound(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) { return tree.equal_range(key); }
+
+  template <typename K>
+    requires transparent
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return tree.equal_range(key);
+  }
 
   /// iterators
 
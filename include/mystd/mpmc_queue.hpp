@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "mystd/concurrency.hpp"
+
+namespace my {
+
+/// @brief What a blocking push/pop of my::mpmc_queue does after spinning for a while on a full/empty queue.
+namespace queue_wait {
+
+/// @brief Keeps spinning, yielding the CPU between attempts. Lowest wake up latency, burns a core per waiter.
+struct spin {};
+
+/// @brief Sleeps in the kernel (std::atomic::wait, a futex on Linux) until the other side signals.
+/// The other side pays a fence and a load on every operation, and a syscall only if somebody sleeps.
+struct futex {};
+
+}  // namespace queue_wait
+
+/// @brief Bounded lock-free queue for many producers and many consumers (D. Vyukov's algorithm).
+///
+/// Every slot carries a sequence number that says whose turn it is: seq == pos means the slot is free for the
+/// push of position pos, seq == pos + 1 means it holds the element of position pos. A push (pop) claims a
+/// position with a CAS on the enqueue (dequeue) counter only after seeing the right sequence, then publishes the
+/// slot with a release store of the next sequence. Producers and consumers only contend on their own counter,
+/// and the two counters live in different cache lines.
+///
+/// The interface follows my::queue: push, pop, size, empty, plus the non-blocking try_push/try_pop.
+/// size() is a snapshot. The capacity is rounded up to a power of two.
+/// T must be nothrow move constructible and assignable, an element is moved in and out of a claimed slot that
+/// cannot be given back.
+/// @tparam Wait -- queue_wait::spin or queue_wait::futex, how push/pop wait on a full/empty queue
+template <typename T, typename Wait = queue_wait::spin, typename Allocator = std::allocator<T>>
+class mpmc_queue {
+  static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                "mpmc_queue: T must be nothrow movable");
+
+ public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = std::size_t;
+
+ private:
+  struct slot {
+    std::atomic<size_type> seq;
+    alignas(T) std::byte storage[sizeof(T)];
+
+    T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+  };
+
+  struct alignas(cache_line_size) counter {
+    std::atomic<size_type> pos{0};
+  };
+
+  /// a sleeping side waits for epoch to change, the other side bumps it only if waiters > 0
+  struct alignas(cache_line_size) sleepers {
+    std::atomic<std::uint32_t> epoch{0};
+    std::atomic<std::uint32_t> waiters{0};
+  };
+
+  using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+  using slot_traits = std::allocator_traits<slot_allocator>;
+
+  static constexpr unsigned SPIN_LIMIT = 64;
+
+  counter enqueue_;
+  counter dequeue_;
+  sleepers not_full_;
+  sleepers not_empty_;
+  slot_allocator alloc_;
+  slot* slots_;
+  size_type mask_;
+
+  /// @brief Claims a free slot and constructs the element from value.
+  /// @return false if the queue is full
+  template <typename U>
+  bool push_impl(U&& value) noexcept {
+    size_type pos = enqueue_.pos.load(std::memory_order_relaxed);
+    for (;;) {
+      slot& s = slots_[pos & mask_];
+      const size_type seq = s.seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (enqueue_.pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          ::new (static_cast<void*>(s.storage)) T(std::forward<U>(value));
+          s.seq.store(pos + 1, std::memory_order_release);
+          wake(not_empty_);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // the slot still holds the element of the previous lap
+      } else {
+        pos = enqueue_.pos.load(std::memory_order_relaxed);  // another producer took pos
+      }
+    }
+  }
+
+  /// @brief Claims a ready slot and moves its element to sink (a noexcept callable taking T&&).
+  /// @return false if the queue is empty
+  template <typename Sink>
+  bool pop_impl(Sink&& sink) noexcept {
+    size_type pos = dequeue_.pos.load(std::memory_order_relaxed);
+    for (;;) {
+      slot& s = slots_[pos & mask_];
+      const size_type seq = s.seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (dequeue_.pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          sink(std::move(*s.value()));
+          s.value()->~T();
+          s.seq.store(pos + mask_ + 1, std::memory_order_release);
+          wake(not_full_);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // the slot of pos is not pushed yet
+      } else {
+        pos = dequeue_.pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool can_push() const noexcept {
+    const size_type pos = enqueue_.pos.load(std::memory_order_relaxed);
+    return slots_[pos & mask_].seq.load(std::memory_order_acquire) == pos;
+  }
+
+  bool can_pop() const noexcept {
+    const size_type pos = dequeue_.pos.load(std::memory_order_relaxed);
+    return slots_[pos & mask_].seq.load(std::memory_order_acquire) == pos + 1;
+  }
+
+  void wake(sleepers& s) noexcept {
+    if constexpr (std::is_same_v<Wait, queue_wait::futex>) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);  // pairs with the fence in wait_until
+      if (s.waiters.load(std::memory_order_relaxed) != 0) {
+        s.epoch.fetch_add(1, std::memory_order_release);
+        s.epoch.notify_all();
+      }
+    }
+  }
+
+  /// @brief One step of a blocking wait: spin, then yield (spin) or sleep until s is signalled (futex).
+  template <typename Ready>
+  void wait_until(sleepers& s, unsigned& spins, Ready ready) noexcept {
+    if (spins < SPIN_LIMIT) {
+      ++spins;
+      cpu_relax();
+      return;
+    }
+    if constexpr (std::is_same_v<Wait, queue_wait::futex>) {
+      const std::uint32_t epoch = s.epoch.load(std::memory_order_acquire);
+      s.waiters.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);  // the recheck cannot miss a wake that saw no waiter
+      if (!ready()) s.epoch.wait(epoch, std::memory_order_acquire);
+      s.waiters.fetch_sub(1, std::memory_order_relaxed);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+ public:
+  /// @param capacity -- rounded up to a power of two, at least 2
+  explicit mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type())
+      : alloc_(alloc), mask_(std::bit_ceil(std::max<size_type>(capacity, 2)) - 1) {
+    slots_ = slot_traits::allocate(alloc_, mask_ + 1);
+    for (size_type i = 0; i <= mask_; ++i) {
+      ::new (static_cast<void*>(slots_ + i)) slot;
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  mpmc_queue(const mpmc_queue&) = delete;
+  mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+  ~mpmc_queue() {
+    const size_type end = enqueue_.pos.load(std::memory_order_relaxed);
+    for (size_type pos = dequeue_.pos.load(std::memory_order_relaxed); pos != end; ++pos) {
+      slots_[pos & mask_].value()->~T();
+    }
+    slot_traits::deallocate(alloc_, slots_, mask_ + 1);
+  }
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+
+  size_type size() const noexcept {
+    const size_type head = dequeue_.pos.load(std::memory_order_acquire);
+    return enqueue_.pos.load(std::memory_order_acquire) - head;
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  // Non-blocking
+
+  /// @return false if the queue is full, value is left untouched
+  bool try_push(T&& value) noexcept { return push_impl(std::move(value)); }
+
+  bool try_push(const T& value) {
+    if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+      return push_impl(value);
+    } else {
+      T copy(value);
+      return push_impl(std::move(copy));
+    }
+  }
+
+  /// @return false if the queue is empty
+  bool try_pop(T& out) noexcept {
+    return pop_impl([&out](T&& value) noexcept { out = std::move(value); });
+  }
+
+  // Blocking
+
+  void push(T&& value) noexcept {
+    for (unsigned spins = 0; !push_impl(std::move(value));) {
+      wait_until(not_full_, spins, [this] { return can_push(); });
+    }
+  }
+
+  void push(const T& value) {
+    if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+      for (unsigned spins = 0; !push_impl(value);) {
+        wait_until(not_full_, spins, [this] { return can_push(); });
+      }
+    } else {
+      push(T(value));
+    }
+  }
+
+  void pop(T& out) noexcept {
+    for (unsigned spins = 0; !pop_impl([&out](T&& value) noexcept { out = std::move(value); });) {
+      wait_until(not_empty_, spins, [this] { return can_pop(); });
+    }
+  }
+
+  T pop() noexcept {
+    std::optional<T> out;  // T need not be default constructible
+    for (unsigned spins = 0; !pop_impl([&out](T&& value) noexcept { out.emplace(std::move(value)); });) {
+      wait_until(not_empty_, spins, [this] { return can_pop(); });
+    }
+    return std::move(*out);
+  }
+};
+
+}  // namespace my
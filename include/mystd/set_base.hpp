@@ -1,8 +1,10 @@
 #pragma once
 
 #include <initializer_list>
+#include <utility>
 
 #include "mystd/some_trees/rb_tree.hpp"
+#include "mystd/type_traits.hpp"
 
 namespace my {
 
@@ -25,6 +27,8 @@ class set_base {
  private:
   Tree tree{};
 
+  static constexpr bool transparent = is_transparent_v<typename Tree::key_compare>;
+
  public:
   set_base() = default;
 
@@ -71,13 +75,33 @@ class set_base {
 
   size_type count(const key_type& key) { return tree.count(key); }
 
+  /// @brief With a transparent comparator in Tree (e.g. rb_tree<Key, KeyOfIdentity<Key>, std::less<>>) the lookups
+  /// and erase take any key type comparable with Key.
+  template <typename K>
+    requires transparent
+  size_type count(const K& key) {
+    return tree.count(key);
+  }
+
   bool contains(const key_type& key) { return tree.contains(key); }
 
+  template <typename K>
+    requires transparent
+  bool contains(const K& key) {
+    return tree.contains(key);
+  }
+
   iterator find(const key_type& key) {
     auto it = tree.find(key);
     return it;
   }
 
+  template <typename K>
+    requires transparent
+  iterator find(const K& key) {
+    return tree.find(key);
+  }
+
   // process to insert unique values
   void insert(const value_type& value) {
     if constexpr (Unique) {
@@ -91,8 +115,35 @@ class set_base {
 
   void erase(const value_type& value) { tree.erase(value); }
 
-  // lower_bound()
-  // upper_bound()
+  template <typename K>
+    requires transparent
+  void erase(const K& key) {
+    tree.erase(key);
+  }
+
+  iterator lower_bound(const key_type& key) { return tree.lower_bound(key); }
+
+  template <typename K>
+    requires transparent
+  iterator lower_bound(const K& key) {
+    return tree.lower_bound(key);
+  }
+
+  iterator upper_bound(const key_type& key) { return tree.upper_bound(key); }
+
+  template <typename K>
+    requires transparent
+  iterator upper_bound(const K& key) {
+    return tree.upper_bound(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) { return tree.equal_range(key); }
+
+  template <typename K>
+    requires transparent
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return tree.equal_range(key);
+  }
 
   iterator begin() { return tree.begin(); }
 
@@ -0,0 +1,454 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MYSTD_SIMD_X86 1
+#include <immintrin.h>
+#define MYSTD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MYSTD_SIMD_X86 0
+#endif
+
+/// @brief Comparison and search kernels over contiguous ranges of arithmetic types.
+///
+/// Every kernel has a scalar version (namespace scalar) and, on x86 with GCC/Clang, an AVX2 version
+/// (namespace avx2). The functions in my::simd pick the AVX2 one at runtime if the CPU supports it and
+/// fall back to std algorithms for types the kernels do not cover, so they are safe to call with any T.
+///
+/// Note: sum of floating point values is computed in a different order by the AVX2 kernel,
+/// so the result may differ from the scalar one in the last bits.
+/// min and max of floating point values return what std::min_element/std::max_element return on every CPU:
+/// the AVX2 kernels hand a range that contains a NaN over to the scalar ones.
+namespace my::simd {
+
+namespace detail {
+
+/// float, double and integers of up to 8 bytes; long double and bool take the scalar path
+template <typename T>
+inline constexpr bool is_lane_type_v = std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                                       (std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8);
+
+/// bytewise comparison gives element equality
+template <typename T>
+inline constexpr bool is_bitwise_comparable_v = std::is_integral_v<T>;
+
+template <typename T>
+inline constexpr bool has_vector_minmax_v = is_lane_type_v<T> && (std::is_floating_point_v<T> || sizeof(T) <= 4);
+
+template <typename T>
+inline constexpr bool has_vector_sum_v = is_lane_type_v<T> && (std::is_floating_point_v<T> || sizeof(T) >= 4);
+
+/// integer type of the same size, used to broadcast T into lanes
+template <typename T>
+using lane_int_t =
+    std::conditional_t<sizeof(T) == 1, int8_t,
+                       std::conditional_t<sizeof(T) == 2, int16_t,
+                                          std::conditional_t<sizeof(T) == 4, int32_t, int64_t>>>;
+
+/// sum with wrap around for integers (no signed overflow UB), plain addition for floating point
+template <typename T>
+constexpr T wrapping_add(T a, T b) noexcept {
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+  } else {
+    return a + b;
+  }
+}
+
+}  // namespace detail
+
+/// @brief Portable versions, also used for tails and when AVX2 is not available.
+namespace scalar {
+
+/// @return index of first element where a and b differ, n if none
+template <typename T>
+size_t mismatch(const T* a, const T* b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (!(a[i] == b[i])) return i;
+  }
+  return n;
+}
+
+template <typename T>
+const T* find(const T* first, const T* last, T value) {
+  return std::find(first, last, value);
+}
+
+template <typename T>
+size_t count(const T* first, const T* last, T value) {
+  return static_cast<size_t>(std::count(first, last, value));
+}
+
+template <typename T>
+T min(const T* first, const T* last) {
+  assert(first != last && "min of empty range");
+  return *std::min_element(first, last);
+}
+
+template <typename T>
+T max(const T* first, const T* last) {
+  assert(first != last && "max of empty range");
+  return *std::max_element(first, last);
+}
+
+template <typename T>
+T sum(const T* first, const T* last) {
+  T acc{};
+  for (; first != last; ++first) {
+    acc = detail::wrapping_add(acc, *first);
+  }
+  return acc;
+}
+
+}  // namespace scalar
+
+#if MYSTD_SIMD_X86
+
+/// @brief AVX2 versions. Call them only if cpu_has_avx2() is true.
+namespace avx2 {
+
+namespace lanes {
+
+template <typename T>
+MYSTD_TARGET_AVX2 inline __m256i load(const T* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+template <typename T>
+MYSTD_TARGET_AVX2 inline __m256i broadcast(T value) {
+  const auto bits = std::bit_cast<detail::lane_int_t<T>>(value);
+  if constexpr (sizeof(T) == 1) {
+    return _mm256_set1_epi8(bits);
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_set1_epi16(bits);
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm256_set1_epi32(bits);
+  } else {
+    return _mm256_set1_epi64x(bits);
+  }
+}
+
+/// @return all ones in lanes where a == b
+template <typename T>
+MYSTD_TARGET_AVX2 inline __m256i equal(__m256i a, __m256i b) {
+  if constexpr (std::is_same_v<T, float>) {
+    return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+  } else if constexpr (std::is_same_v<T, double>) {
+    return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm256_cmpeq_epi8(a, b);
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_cmpeq_epi16(a, b);
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm256_cmpeq_epi32(a, b);
+  } else {
+    return _mm256_cmpeq_epi64(a, b);
+  }
+}
+
+template <typename T>
+MYSTD_TARGET_AVX2 inline __m256i min(__m256i a, __m256i b) {
+  if constexpr (std::is_same_v<T, float>) {
+    return _mm256_castps_si256(_mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+  } else if constexpr (std::is_same_v<T, double>) {
+    return _mm256_castpd_si256(_mm256_min_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+  } else if constexpr (std::is_signed_v<T> && sizeof(T) == 1) {
+    return _mm256_min_epi8(a, b);
+  } else if constexpr (std::is_signed_v<T> && sizeof(T) == 2) {
+    return _mm256_min_epi16(a, b);
+  } else if constexpr (std::is_signed_v<T>) {
+    return _mm256_min_epi32(a, b);
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm256_min_epu8(a, b);
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_min_epu16(a, b);
+  } else {
+    return _mm256_min_epu32(a, b);
+  }
+}
+
+template <typename T>
+MYSTD_TARGET_AVX2 inline __m256i max(__m256i a, __m256i b) {
+  if constexpr (std::is_same_v<T, float>) {
+    return _mm256_castps_si256(_mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+  } else if constexpr (std::is_same_v<T, double>) {
+    return _mm256_castpd_si256(_mm256_max_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+  } else if constexpr (std::is_signed_v<T> && sizeof(T) == 1) {
+    return _mm256_max_epi8(a, b);
+  } else if constexpr (std::is_signed_v<T> && sizeof(T) == 2) {
+    return _mm256_max_epi16(a, b);
+  } else if constexpr (std::is_signed_v<T>) {
+    return _mm256_max_epi32(a, b);
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm256_max_epu8(a, b);
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_max_epu16(a, b);
+  } else {
+    return _mm256_max_epu32(a, b);
+  }
+}
+
+/// @return all ones in lanes that hold a NaN, zero for integers
+template <typename T>
+MYSTD_TARGET_AVX2 inline __m256i unordered(__m256i a) {
+  if constexpr (std::is_same_v<T, float>) {
+    const __m256 f = _mm256_castsi256_ps(a);
+    return _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+  } else if constexpr (std::is_same_v<T, double>) {
+    const __m256d d = _mm256_castsi256_pd(a);
+    return _mm256_castpd_si256(_mm256_cmp_pd(d, d, _CMP_UNORD_Q));
+  } else {
+    return _mm256_setzero_si256();
+  }
+}
+
+template <typename T>
+MYSTD_TARGET_AVX2 inline __m256i add(__m256i a, __m256i b) {
+  if constexpr (std::is_same_v<T, float>) {
+    return _mm256_castps_si256(_mm256_add_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+  } else if constexpr (std::is_same_v<T, double>) {
+    return _mm256_castpd_si256(_mm256_add_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm256_add_epi32(a, b);
+  } else {
+    return _mm256_add_epi64(a, b);
+  }
+}
+
+/// @brief Applies scalar op to the lanes of v.
+template <typename T, typename Op>
+MYSTD_TARGET_AVX2 inline T reduce(__m256i v, Op op) {
+  T tmp[32 / sizeof(T)];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp), v);
+  T acc = tmp[0];
+  for (size_t i = 1; i < 32 / sizeof(T); ++i) {
+    acc = op(acc, tmp[i]);
+  }
+  return acc;
+}
+
+}  // namespace lanes
+
+template <typename T>
+MYSTD_TARGET_AVX2 size_t mismatch(const T* a, const T* b, size_t n) {
+  static_assert(detail::is_bitwise_comparable_v<T>);
+  const auto* pa = reinterpret_cast<const unsigned char*>(a);
+  const auto* pb = reinterpret_cast<const unsigned char*>(b);
+  const size_t bytes = n * sizeof(T);
+  size_t i = 0;
+  for (; i + 32 <= bytes; i += 32) {
+    const __m256i eq = _mm256_cmpeq_epi8(lanes::load(pa + i), lanes::load(pb + i));
+    const auto diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+    if (diff) return (i + std::countr_zero(diff)) / sizeof(T);
+  }
+  return i / sizeof(T) + scalar::mismatch(a + i / sizeof(T), b + i / sizeof(T), n - i / sizeof(T));
+}
+
+template <typename T>
+MYSTD_TARGET_AVX2 const T* find(const T* first, const T* last, T value) {
+  static_assert(detail::is_lane_type_v<T>);
+  constexpr size_t step = 32 / sizeof(T);
+  const __m256i key = lanes::broadcast(value);
+  for (; static_cast<size_t>(last - first) >= step; first += step) {
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(lanes::equal<T>(lanes::load(first), key)));
+    if (mask) return first + std::countr_zero(mask) / sizeof(T);
+  }
+  return scalar::find(first, last, value);
+}
+
+template <typename T>
+MYSTD_TARGET_AVX2 size_t count(const T* first, const T* last, T value) {
+  static_assert(detail::is_lane_type_v<T>);
+  constexpr size_t step = 32 / sizeof(T);
+  const __m256i key = lanes::broadcast(value);
+  size_t matched_bytes = 0;
+  for (; static_cast<size_t>(last - first) >= step; first += step) {
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(lanes::equal<T>(lanes::load(first), key)));
+    matched_bytes += std::popcount(mask);
+  }
+  return matched_bytes / sizeof(T) + scalar::count(first, last, value);
+}
+
+/// vminps/vmaxps return the second operand on a NaN, so a floating point range with a NaN goes to scalar::min
+template <typename T>
+MYSTD_TARGET_AVX2 T min(const T* first, const T* last) {
+  static_assert(detail::has_vector_minmax_v<T>);
+  constexpr size_t step = 32 / sizeof(T);
+  if (static_cast<size_t>(last - first) < step) return scalar::min(first, last);
+  const T* const begin = first;
+  __m256i acc = lanes::load(first);
+  __m256i nan = lanes::unordered<T>(acc);
+  for (first += step; static_cast<size_t>(last - first) >= step; first += step) {
+    const __m256i x = lanes::load(first);
+    acc = lanes::min<T>(acc, x);
+    if constexpr (std::is_floating_point_v<T>) nan = _mm256_or_si256(nan, lanes::unordered<T>(x));
+  }
+  if constexpr (std::is_floating_point_v<T>) {
+    if (!_mm256_testz_si256(nan, nan)) return scalar::min(begin, last);
+  }
+  T result = lanes::reduce<T>(acc, [](T a, T b) { return b < a ? b : a; });
+  for (; first != last; ++first) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (*first != *first) return scalar::min(begin, last);
+    }
+    if (*first < result) result = *first;
+  }
+  return result;
+}
+
+/// vminps/vmaxps return the second operand on a NaN, so a floating point range with a NaN goes to scalar::max
+template <typename T>
+MYSTD_TARGET_AVX2 T max(const T* first, const T* last) {
+  static_assert(detail::has_vector_minmax_v<T>);
+  constexpr size_t step = 32 / sizeof(T);
+  if (static_cast<size_t>(last - first) < step) return scalar::max(first, last);
+  const T* const begin = first;
+  __m256i acc = lanes::load(first);
+  __m256i nan = lanes::unordered<T>(acc);
+  for (first += step; static_cast<size_t>(last - first) >= step; first += step) {
+    const __m256i x = lanes::load(first);
+    acc = lanes::max<T>(acc, x);
+    if constexpr (std::is_floating_point_v<T>) nan = _mm256_or_si256(nan, lanes::unordered<T>(x));
+  }
+  if constexpr (std::is_floating_point_v<T>) {
+    if (!_mm256_testz_si256(nan, nan)) return scalar::max(begin, last);
+  }
+  T result = lanes::reduce<T>(acc, [](T a, T b) { return a < b ? b : a; });
+  for (; first != last; ++first) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (*first != *first) return scalar::max(begin, last);
+    }
+    if (result < *first) result = *first;
+  }
+  return result;
+}
+
+template <typename T>
+MYSTD_TARGET_AVX2 T sum(const T* first, const T* last) {
+  static_assert(detail::has_vector_sum_v<T>);
+  constexpr size_t step = 32 / sizeof(T);
+  __m256i acc = _mm256_setzero_si256();
+  for (; static_cast<size_t>(last - first) >= step; first += step) {
+    acc = lanes::add<T>(acc, lanes::load(first));
+  }
+  const T head = lanes::reduce<T>(acc, [](T a, T b) { return detail::wrapping_add(a, b); });
+  return detail::wrapping_add(head, scalar::sum(first, last));
+}
+
+}  // namespace avx2
+
+#endif  // MYSTD_SIMD_X86
+
+/// @return true if the AVX2 kernels can run on this CPU (checked once)
+inline bool cpu_has_avx2() noexcept {
+#if MYSTD_SIMD_X86
+  static const bool has = __builtin_cpu_supports("avx2");
+  return has;
+#else
+  return false;
+#endif
+}
+
+// dispatching front end
+
+template <typename T>
+size_t mismatch(const T* a, const T* b, size_t n) {
+#if MYSTD_SIMD_X86
+  if constexpr (detail::is_bitwise_comparable_v<T>) {
+    if (cpu_has_avx2()) return avx2::mismatch(a, b, n);
+  }
+#endif
+  return scalar::mismatch(a, b, n);
+}
+
+template <typename T>
+bool equal(const T* a, const T* b, size_t n) {
+  if (n == 0) return true;
+  if constexpr (detail::is_bitwise_comparable_v<T>) {
+#if MYSTD_SIMD_X86
+    if (cpu_has_avx2()) return avx2::mismatch(a, b, n) == n;
+#endif
+    return std::memcmp(a, b, n * sizeof(T)) == 0;
+  } else {
+    return std::equal(a, a + n, b);
+  }
+}
+
+/// @brief Lexicographical three way comparison, only operator< of T is used.
+/// @return negative if a < b, 0 if equal, positive if a > b
+template <typename T>
+int compare(const T* a, size_t na, const T* b, size_t nb) {
+  const size_t n = std::min(na, nb);
+  if constexpr (detail::is_bitwise_comparable_v<T>) {
+    const size_t i = n ? mismatch(a, b, n) : 0;
+    if (i != n) return a[i] < b[i] ? -1 : 1;
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      if (a[i] < b[i]) return -1;
+      if (b[i] < a[i]) return 1;
+    }
+  }
+  return na < nb ? -1 : (na > nb ? 1 : 0);
+}
+
+template <typename T>
+const T* find(const T* first, const T* last, const T& value) {
+#if MYSTD_SIMD_X86
+  if constexpr (detail::is_lane_type_v<T>) {
+    if (cpu_has_avx2()) return avx2::find(first, last, value);
+  }
+#endif
+  return std::find(first, last, value);
+}
+
+template <typename T>
+size_t count(const T* first, const T* last, const T& value) {
+#if MYSTD_SIMD_X86
+  if constexpr (detail::is_lane_type_v<T>) {
+    if (cpu_has_avx2()) return avx2::count(first, last, value);
+  }
+#endif
+  return static_cast<size_t>(std::count(first, last, value));
+}
+
+/// @pre first != last
+template <typename T>
+T min(const T* first, const T* last) {
+#if MYSTD_SIMD_X86
+  if constexpr (detail::has_vector_minmax_v<T>) {
+    if (cpu_has_avx2()) return avx2::min(first, last);
+  }
+#endif
+  return scalar::min(first, last);
+}
+
+/// @pre first != last
+template <typename T>
+T max(const T* first, const T* last) {
+#if MYSTD_SIMD_X86
+  if constexpr (detail::has_vector_minmax_v<T>) {
+    if (cpu_has_avx2()) return avx2::max(first, last);
+  }
+#endif
+  return scalar::max(first, last);
+}
+
+template <typename T>
+T sum(const T* first, const T* last) {
+#if MYSTD_SIMD_X86
+  if constexpr (detail::has_vector_sum_v<T>) {
+    if (cpu_has_avx2()) return avx2::sum(first, last);
+  }
+#endif
+  return scalar::sum(first, last);
+}
+
+}  // namespace my::simd
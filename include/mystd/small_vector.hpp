@@ -0,0 +1,462 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "mystd/growth_policy.hpp"
+
+namespace my {
+
+/// @brief Dynamic array with inline storage for the first N elements (small buffer optimization).
+///
+/// Up to N elements live inside the object itself, the heap is touched only when size exceeds N.
+/// The interface is the same as my::vector.
+/// @tparam Growth -- growth policy of the heap buffer, see growth_policy.hpp (only next_capacity is used)
+/// @tparam Allocator -- the heap buffer comes from it, see allocator.hpp
+template <typename T, size_t N = 8, typename Growth = growth::doubling, typename Allocator = std::allocator<T>>
+class small_vector {
+  static_assert(N > 0, "Inline capacity must be > 0");
+
+ public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+ private:
+  using alloc_traits = std::allocator_traits<allocator_type>;
+
+  [[no_unique_address]] allocator_type alloc_;
+  alignas(T) std::byte inline_[N * sizeof(T)];
+  pointer data_ = inline_data();
+  size_type size_ = 0;
+  size_type capacity_ = N;
+
+  pointer inline_data() noexcept { return reinterpret_cast<pointer>(inline_); }
+
+  const_pointer inline_data() const noexcept { return reinterpret_cast<const_pointer>(inline_); }
+
+  bool is_inline() const noexcept { return data_ == inline_data(); }
+
+  pointer allocate(size_type n) { return n > N ? alloc_traits::allocate(alloc_, n) : inline_data(); }
+
+  void deallocate(pointer p, size_type n) {
+    if (p != inline_data()) alloc_traits::deallocate(alloc_, p, n);
+  }
+
+  void destroy(pointer first, pointer last) noexcept {
+    for (; first != last; ++first) {
+      alloc_traits::destroy(alloc_, first);
+    }
+  }
+
+  /// @brief Constructs [first, last) in raw memory through the allocator from args (value-initialized without
+  /// args). On exception the elements built so far are destroyed.
+  template <typename... Args>
+  void construct_range(pointer first, pointer last, const Args&... args) {
+    pointer cur = first;
+    try {
+      for (; cur != last; ++cur) {
+        alloc_traits::construct(alloc_, cur, args...);
+      }
+    } catch (...) {
+      destroy(first, cur);
+      throw;
+    }
+  }
+
+  /// @brief Constructs copies of [first, last) in raw memory at dst through the allocator. With std::allocator this
+  /// is uninitialized_copy. On exception nothing is left constructed at dst.
+  template <typename It>
+  void construct_from(It first, It last, pointer dst) {
+    if constexpr (std::is_same_v<Allocator, std::allocator<T>>) {
+      std::uninitialized_copy(first, last, dst);
+    } else {
+      pointer cur = dst;
+      try {
+        for (; first != last; ++first, ++cur) {
+          alloc_traits::construct(alloc_, cur, *first);
+        }
+      } catch (...) {
+        destroy(dst, cur);
+        throw;
+      }
+    }
+  }
+
+  /// @brief Moves [first, last) to raw memory at dst if T has noexcept move ctor (or can not be copied),
+  /// otherwise copies it. On exception nothing is left constructed at dst.
+  void transfer(pointer first, pointer last, pointer dst) {
+    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+      construct_from(std::make_move_iterator(first), std::make_move_iterator(last), dst);
+    } else {
+      construct_from(first, last, dst);
+    }
+  }
+
+  size_type next_capacity() const { return Growth::next_capacity(capacity_, size_ + 1, sizeof(T)); }
+
+  /// @brief Room for count elements, at least the next geometric step if it has to reallocate.
+  void grow_to(size_type count) {
+    if (count > capacity_) {
+      reallocate(std::max(count, next_capacity()));
+    }
+  }
+
+  /// @brief Moves elements to a buffer of new_capacity, the inline buffer is used when new_capacity <= N.
+  void reallocate(size_type new_capacity) {
+    pointer new_data = allocate(new_capacity);
+    if (new_data == data_) return;  // inline -> inline
+    try {
+      transfer(data_, data_ + size_, new_data);
+    } catch (...) {
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    destroy(data_, data_ + size_);
+    deallocate(data_, capacity_);
+    data_ = new_data;
+    capacity_ = new_data == inline_data() ? N : new_capacity;
+  }
+
+  /// @brief Spills to a larger heap buffer and constructs a new element at pos (size_ is not changed).
+  template <typename... Args>
+  pointer realloc_insert(size_type pos, Args&&... args) {
+    const size_type new_capacity = next_capacity();
+    pointer new_data = alloc_traits::allocate(alloc_, new_capacity);
+    try {
+      alloc_traits::construct(alloc_, new_data + pos, std::forward<Args>(args)...);
+    } catch (...) {
+      alloc_traits::deallocate(alloc_, new_data, new_capacity);
+      throw;
+    }
+    try {
+      transfer(data_, data_ + pos, new_data);
+      try {
+        transfer(data_ + pos, data_ + size_, new_data + pos + 1);
+      } catch (...) {
+        destroy(new_data, new_data + pos);
+        throw;
+      }
+    } catch (...) {
+      alloc_traits::destroy(alloc_, new_data + pos);
+      alloc_traits::deallocate(alloc_, new_data, new_capacity);
+      throw;
+    }
+    destroy(data_, data_ + size_);
+    deallocate(data_, capacity_);
+    data_ = new_data;
+    capacity_ = new_capacity;
+    return data_ + pos;
+  }
+
+  /// @brief Takes other's elements, leaves other empty and inline. *this must be empty.
+  void steal(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (other.is_inline()) {
+      construct_from(std::make_move_iterator(other.data_), std::make_move_iterator(other.data_ + other.size_), data_);
+      size_ = other.size_;
+      other.clear();
+    } else {
+      data_ = other.data_;
+      size_ = other.size_;
+      capacity_ = other.capacity_;
+      other.data_ = other.inline_data();
+      other.size_ = 0;
+      other.capacity_ = N;
+    }
+  }
+
+ public:
+  // contruction and assignment
+
+  small_vector() noexcept = default;
+
+  explicit small_vector(const allocator_type& alloc) noexcept : alloc_(alloc) {}
+
+  small_vector(std::initializer_list<value_type> init, const allocator_type& alloc = allocator_type())
+      : alloc_(alloc) {
+    reserve(init.size());
+    try {
+      construct_from(init.begin(), init.end(), data_);
+    } catch (...) {
+      deallocate(data_, capacity_);
+      throw;
+    }
+    size_ = init.size();
+  }
+
+  ~small_vector() {
+    destroy(data_, data_ + size_);
+    deallocate(data_, capacity_);
+  }
+
+  // copy and copy assigment
+  small_vector(const small_vector& other)
+      : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    reserve(other.size_);
+    try {
+      construct_from(other.data_, other.data_ + other.size_, data_);
+    } catch (...) {
+      deallocate(data_, capacity_);
+      throw;
+    }
+    size_ = other.size_;
+  }
+
+  small_vector& operator=(const small_vector& other) {
+    if (this != &other) {
+      small_vector tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  // move and move assignment, the allocator is copied along with the buffer it owns
+  small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : alloc_(other.alloc_) {
+    steal(other);
+  }
+
+  small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      clear();
+      deallocate(data_, capacity_);
+      data_ = inline_data();
+      capacity_ = N;
+      alloc_ = other.alloc_;
+      steal(other);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const noexcept { return alloc_; }
+
+  // capacity
+
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type capacity() const noexcept { return capacity_; }
+
+  static constexpr size_type inline_capacity() noexcept { return N; }
+
+  /// @return true while elements are stored inside the object
+  bool is_small() const noexcept { return is_inline(); }
+
+  // observers
+
+  pointer data() { return data_; }
+
+  const_pointer data() const { return data_; }
+
+  reference operator[](size_type index) noexcept { return data_[index]; }
+
+  const_reference operator[](size_type index) const noexcept { return data_[index]; }
+
+  reference at(size_type index) {
+    if (index >= size_) throw std::out_of_range("");
+    return data_[index];
+  }
+
+  const_reference at(size_type index) const {
+    if (index >= size_) throw std::out_of_range("");
+    return data_[index];
+  }
+
+  reference front() { return at(0); }
+
+  const_reference front() const { return at(0); }
+
+  reference back() { return at(size_ - 1); }
+
+  const_reference back() const { return at(size_ - 1); }
+
+  // modifiers
+
+  void push_back(const_reference value) { emplace_back(value); }
+
+  void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    pointer slot = data_ + size_;
+    if (capacity_ < size_ + 1) {
+      slot = realloc_insert(size_, std::forward<Args>(args)...);
+    } else {
+      alloc_traits::construct(alloc_, slot, std::forward<Args>(args)...);
+    }
+    ++size_;
+    return *slot;
+  }
+
+  void pop_back() {
+    --size_;
+    alloc_traits::destroy(alloc_, data_ + size_);
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    const size_type idx = pos - data_;
+    if (capacity_ < size_ + 1) {
+      pointer slot = realloc_insert(idx, std::forward<Args>(args)...);
+      ++size_;
+      return slot;
+    }
+    if (idx == size_) {
+      alloc_traits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+      ++size_;
+      return data_ + idx;
+    }
+    value_type tmp(std::forward<Args>(args)...);
+    alloc_traits::construct(alloc_, data_ + size_, std::move(data_[size_ - 1]));
+    ++size_;
+    std::move_backward(data_ + idx, data_ + size_ - 2, data_ + size_ - 1);
+    data_[idx] = std::move(tmp);
+    return data_ + idx;
+  }
+
+  iterator insert(const_iterator pos, const_reference value) { return emplace(pos, value); }
+
+  iterator insert(const_iterator pos, value_type&& value) { return emplace(pos, std::move(value)); }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    pointer f = data_ + (first - data_);
+    pointer l = data_ + (last - data_);
+    if (f != l) {
+      pointer new_end = std::move(l, data_ + size_, f);
+      destroy(new_end, data_ + size_);
+      size_ = new_end - data_;
+    }
+    return f;
+  }
+
+  void clear() noexcept {
+    destroy(data_, data_ + size_);
+    size_ = 0;
+  }
+
+  void reserve(size_type new_capacity) {
+    if (new_capacity > capacity_) {
+      reallocate(new_capacity);
+    }
+  }
+
+  /// @brief Releases unused heap memory, moves elements back inline if they fit.
+  void shrink_to_fit() {
+    if (!is_inline() && capacity_ > size_) {
+      reallocate(size_);
+    }
+  }
+
+  /// @brief Grows geometrically like push_back when count exceeds the capacity; reserve stays exact.
+  void resize(size_type count) {
+    if (count < size_) {
+      destroy(data_ + count, data_ + size_);
+    } else {
+      grow_to(count);
+      construct_range(data_ + size_, data_ + count);
+    }
+    size_ = count;
+  }
+
+  void resize(size_type count, const_reference value) {
+    if (count < size_) {
+      destroy(data_ + count, data_ + size_);
+    } else if (count > capacity_) {
+      value_type tmp(value);  // value may live in the buffer being released
+      grow_to(count);
+      construct_range(data_ + size_, data_ + count, tmp);
+    } else {
+      construct_range(data_ + size_, data_ + count, value);
+    }
+    size_ = count;
+  }
+
+  // iterators
+
+  iterator begin() { return data_; }
+
+  const_iterator begin() const { return data_; }
+
+  iterator end() { return data_ + size_; }
+
+  const_iterator end() const { return data_ + size_; }
+
+  void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this == &other) return;
+    if (!is_inline() && !other.is_inline()) {
+      std::swap(alloc_, other.alloc_);
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+      std::swap(capacity_, other.capacity_);
+      return;
+    }
+    small_vector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+};
+
+// non-member methods
+
+template <typename T, size_t N, typename Growth, typename Alloc>
+bool operator==(const small_vector<T, N, Growth, Alloc>& lhs, const small_vector<T, N, Growth, Alloc>& rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t N, typename Growth, typename Alloc>
+bool operator!=(const small_vector<T, N, Growth, Alloc>& lhs, const small_vector<T, N, Growth, Alloc>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, size_t N, typename Growth, typename Alloc>
+bool operator<(const small_vector<T, N, Growth, Alloc>& lhs, const small_vector<T, N, Growth, Alloc>& rhs) {
+  return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t N, typename Growth, typename Alloc>
+bool operator>(const small_vector<T, N, Growth, Alloc>& lhs, const small_vector<T, N, Growth, Alloc>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, size_t N, typename Growth, typename Alloc>
+bool operator<=(const small_vector<T, N, Growth, Alloc>& lhs, const small_vector<T, N, Growth, Alloc>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, size_t N, typename Growth, typename Alloc>
+bool operator>=(const small_vector<T, N, Growth, Alloc>& lhs, const small_vector<T, N, Growth, Alloc>& rhs) {
+  return !(lhs < rhs);
+}
+
+template <typename T, size_t N, typename Growth, typename Alloc>
+void swap(small_vector<T, N, Growth, Alloc>& lhs, small_vector<T, N, Growth, Alloc>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, size_t N, typename Growth, typename Alloc>
+std::ostream& operator<<(std::ostream& os, const small_vector<T, N, Growth, Alloc>& arr) {
+  const size_t size = arr.size();
+  for (size_t i = 0; i < size; ++i) {
+    os << arr[i];
+    if (i != size - 1) {
+      os << " ";
+    }
+  }
+  os << "\n";
+  return os;
+}
+
+}  // namespace my
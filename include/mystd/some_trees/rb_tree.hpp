@@ -8,8 +8,10 @@
 #include <limits>
 #include <sstream>
 #include <stack>
+#include <utility>
 
 #include "mystd/iterator/iterator.hpp"
+#include "mystd/type_traits.hpp"
 
 namespace my {
 
@@ -39,6 +41,7 @@ template <typename ValueType, typename KeyOfValue,
 class rb_tree {
  public:
   using Key = std::invoke_result_t<KeyOfValue, ValueType>;
+  using key_compare = Compare;
 
  private:
   struct Node {
@@ -65,7 +68,10 @@ class rb_tree {
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
  private:
-  Node* find_node(Node* node, const Key& key) const {
+  static constexpr bool transparent = is_transparent_v<Compare>;
+
+  template <typename K>
+  Node* find_node(Node* node, const K& key) const {
     Node* current = node;
 
     while (current != nullptr) {
@@ -81,7 +87,38 @@ class rb_tree {
     return nullptr;
   }
 
-  size_t count_node(Node* node, const Key& key) const {
+  /// @return the first node whose key is not less than key, nullptr if there is none
+  template <typename K>
+  Node* lower_bound_node(const K& key) const {
+    Node* result = nullptr;
+    for (Node* current = root; current;) {
+      if (comp(key_of_value(current->value), key)) {
+        current = current->right;
+      } else {
+        result = current;
+        current = current->left;
+      }
+    }
+    return result;
+  }
+
+  /// @return the first node whose key is greater than key, nullptr if there is none
+  template <typename K>
+  Node* upper_bound_node(const K& key) const {
+    Node* result = nullptr;
+    for (Node* current = root; current;) {
+      if (comp(key, key_of_value(current->value))) {
+        result = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return result;
+  }
+
+  template <typename K>
+  size_t count_node(Node* node, const K& key) const {
     if (node == nullptr) return 0;
 
     if (comp(key, key_of_value(node->value))) {
@@ -494,8 +531,104 @@ class rb_tree {
     insert_rebalance(new_node);
   }
 
-  void erase(const Key& key) {
-    Node* z = find_node(root, key);
+  void erase(const Key& key) { erase_node(find_node(root, key)); }
+
+  /// @brief Heterogeneous lookup, if Compare is transparent (e.g. std::less<>): key is any type comparable with
+  /// Key, no Key is built. The same for find, contains, count, lower_bound, upper_bound and equal_range.
+  template <typename K>
+    requires transparent
+  void erase(const K& key) {
+    erase_node(find_node(root, key));
+  }
+
+  iterator find(const Key& key) {
+    Node* n = find_node(root, key);
+    return iterator(n);
+  }
+
+  template <typename K>
+    requires transparent
+  iterator find(const K& key) {
+    return iterator(find_node(root, key));
+  }
+
+  const_iterator find(const Key& key) const {
+    Node* n = find_node(root, key);
+    return const_iterator(n);
+  }
+
+  template <typename K>
+    requires transparent
+  const_iterator find(const K& key) const {
+    return const_iterator(find_node(root, key));
+  }
+
+  bool contains(const Key& key) const { return find_node(root, key) != nullptr; }
+
+  template <typename K>
+    requires transparent
+  bool contains(const K& key) const {
+    return find_node(root, key) != nullptr;
+  }
+
+  size_t count(const Key& key) const { return count_node(root, key); }
+
+  template <typename K>
+    requires transparent
+  size_t count(const K& key) const {
+    return count_node(root, key);
+  }
+
+  iterator lower_bound(const Key& key) { return iterator(lower_bound_node(key)); }
+  const_iterator lower_bound(const Key& key) const { return const_iterator(lower_bound_node(key)); }
+
+  template <typename K>
+    requires transparent
+  iterator lower_bound(const K& key) {
+    return iterator(lower_bound_node(key));
+  }
+
+  template <typename K>
+    requires transparent
+  const_iterator lower_bound(const K& key) const {
+    return const_iterator(lower_bound_node(key));
+  }
+
+  iterator upper_bound(const Key& key) { return iterator(upper_bound_node(key)); }
+  const_iterator upper_bound(const Key& key) const { return const_iterator(upper_bound_node(key)); }
+
+  template <typename K>
+    requires transparent
+  iterator upper_bound(const K& key) {
+    return iterator(upper_bound_node(key));
+  }
+
+  template <typename K>
+    requires transparent
+  const_iterator upper_bound(const K& key) const {
+    return const_iterator(upper_bound_node(key));
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) { return {lower_bound(key), upper_bound(key)}; }
+
+  std::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename K>
+    requires transparent
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename K>
+    requires transparent
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+ private:
+  void erase_node(Node* z) {
     if (!z) return;
 
     Node* y = z;
@@ -538,20 +671,7 @@ class rb_tree {
     --size_;
   }
 
-  iterator find(const Key& key) {
-    Node* n = find_node(root, key);
-    return iterator(n);
-  }
-
-  const_iterator find(const Key& key) const {
-    Node* n = find_node(root, key);
-    return const_iterator(n);
-  }
-
-  bool contains(const Key& key) const { return find_node(root, key) != nullptr; }
-
-  size_t count(const Key& key) const { return count_node(root, key); }
-
+ public:
   size_t size() const { return size_; }
   bool empty() const { return size_ == 0; }
 
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "mystd/concurrency.hpp"
+
+namespace my {
+
+/// @brief Lock-free bounded queue for exactly one producer thread and one consumer thread.
+///
+/// The storage is the layout of my::cyclicbufferbased::deque with a power of two capacity: a raw buffer indexed
+/// by a position masked with Capacity - 1. Head (next element to pop) and tail (next free slot) are free running
+/// counters, each one in its own cache line together with the owner's cached copy of the other counter, so that
+/// a push or a pop touches the line of the other thread only when the cached value says the ring is full/empty.
+///
+/// try_push* may only be called from the producer thread, try_pop* only from the consumer thread.
+/// size() and empty() may be called from anywhere and return a snapshot.
+/// @tparam Capacity -- number of slots, a power of two
+template <typename T, std::size_t Capacity, typename Allocator = std::allocator<T>>
+class spsc_ring {
+  static_assert(std::has_single_bit(Capacity), "spsc_ring: Capacity must be a power of two");
+
+ public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = std::size_t;
+
+ private:
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  static constexpr size_type MASK = Capacity - 1;
+
+  /// written by the producer
+  struct alignas(cache_line_size) producer_side {
+    std::atomic<size_type> tail{0};
+    size_type head_cache = 0;
+  };
+
+  /// written by the consumer
+  struct alignas(cache_line_size) consumer_side {
+    std::atomic<size_type> head{0};
+    size_type tail_cache = 0;
+  };
+
+  producer_side producer_;
+  consumer_side consumer_;
+  allocator_type alloc_;
+  T* buffer_;
+
+  /// @return number of free slots, at least wanted if possible; reloads head only if the cached one is short
+  size_type free_slots(size_type tail, size_type wanted) noexcept {
+    size_type free = Capacity - (tail - producer_.head_cache);
+    if (free < wanted) {
+      producer_.head_cache = consumer_.head.load(std::memory_order_acquire);
+      free = Capacity - (tail - producer_.head_cache);
+    }
+    return free;
+  }
+
+  /// @return number of ready elements, at least wanted if possible; reloads tail only if the cached one is short
+  size_type ready_slots(size_type head, size_type wanted) noexcept {
+    size_type ready = consumer_.tail_cache - head;
+    if (ready < wanted) {
+      consumer_.tail_cache = producer_.tail.load(std::memory_order_acquire);
+      ready = consumer_.tail_cache - head;
+    }
+    return ready;
+  }
+
+ public:
+  explicit spsc_ring(const allocator_type& alloc = allocator_type())
+      : alloc_(alloc), buffer_(alloc_traits::allocate(alloc_, Capacity)) {}
+
+  spsc_ring(const spsc_ring&) = delete;
+  spsc_ring& operator=(const spsc_ring&) = delete;
+
+  ~spsc_ring() {
+    const size_type tail = producer_.tail.load(std::memory_order_relaxed);
+    for (size_type i = consumer_.head.load(std::memory_order_relaxed); i != tail; ++i) {
+      alloc_traits::destroy(alloc_, buffer_ + (i & MASK));
+    }
+    alloc_traits::deallocate(alloc_, buffer_, Capacity);
+  }
+
+  static constexpr size_type capacity() noexcept { return Capacity; }
+
+  size_type size() const noexcept {
+    const size_type head = consumer_.head.load(std::memory_order_acquire);
+    return producer_.tail.load(std::memory_order_acquire) - head;
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  // Producer
+
+  /// @return false if the ring is full
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    const size_type tail = producer_.tail.load(std::memory_order_relaxed);
+    if (free_slots(tail, 1) == 0) return false;
+    alloc_traits::construct(alloc_, buffer_ + (tail & MASK), std::forward<Args>(args)...);
+    producer_.tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const T& value) { return try_emplace(value); }
+
+  bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  /// @brief Copies up to n elements from first and publishes them with a single store.
+  /// If a copy throws, the elements copied before it are published.
+  /// @return number of elements pushed, less than n if the ring filled up
+  template <std::input_iterator It>
+  size_type try_push_n(It first, size_type n) {
+    const size_type tail = producer_.tail.load(std::memory_order_relaxed);
+    n = std::min(n, free_slots(tail, n));
+    size_type i = 0;
+    try {
+      for (; i < n; ++i, ++first) {
+        alloc_traits::construct(alloc_, buffer_ + ((tail + i) & MASK), *first);
+      }
+    } catch (...) {
+      producer_.tail.store(tail + i, std::memory_order_release);
+      throw;
+    }
+    producer_.tail.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  // Consumer
+
+  /// @return false if the ring is empty, otherwise the front element is moved to out
+  bool try_pop(T& out) {
+    const size_type head = consumer_.head.load(std::memory_order_relaxed);
+    if (ready_slots(head, 1) == 0) return false;
+    T* slot = buffer_ + (head & MASK);
+    out = std::move(*slot);
+    alloc_traits::destroy(alloc_, slot);
+    consumer_.head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Moves up to n elements to out and frees their slots with a single store.
+  /// If a move throws, the element being moved stays in the ring as its front.
+  /// @return number of elements popped, less than n if the ring ran empty
+  template <typename OutputIt>
+  size_type try_pop_n(OutputIt out, size_type n) {
+    const size_type head = consumer_.head.load(std::memory_order_relaxed);
+    n = std::min(n, ready_slots(head, n));
+    size_type i = 0;
+    try {
+      for (; i < n; ++i, ++out) {
+        T* slot = buffer_ + ((head + i) & MASK);
+        *out = std::move(*slot);
+        alloc_traits::destroy(alloc_, slot);
+      }
+    } catch (...) {
+      consumer_.head.store(head + i, std::memory_order_release);
+      throw;
+    }
+    consumer_.head.store(head + n, std::memory_order_release);
+    return n;
+  }
+};
+
+}  // namespace my
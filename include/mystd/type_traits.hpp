@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+namespace my {
+
+/// @brief T can be moved to another address with memcpy, and the source then dropped without running its destructor.
+///
+/// True for trivially copyable types. Types that own resources through a plain pointer (std::unique_ptr-like handles)
+/// are relocatable too, user types opt in by specializing:
+///
+///     template <>
+///     struct my::is_trivially_relocatable<MyHandle> : std::true_type {};
+///
+/// Containers use it to grow, shift and compact storage with memcpy/memmove instead of per element moves.
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/// @brief The functor declares `using is_transparent = void;`: it hashes/compares any key type compatible with the
+/// stored key (std::less<>, std::equal_to<>, my::string_hash), so containers may look up a std::string_view in a
+/// container of std::string without building a std::string.
+template <typename T, typename = void>
+struct is_transparent : std::false_type {};
+
+template <typename T>
+struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_transparent_v = is_transparent<T>::value;
+
+}  // namespace my
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <initializer_list>
+#include <iterator>
+#include <tuple>
+#include <utility>
 
 #include "mystd/hashtable.hpp"
 
 namespace my {
 
+/// @tparam Table -- the hash table engine: my::hashtable (separate chaining) or my::flat_hashtable (open addressing)
 template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
-          InsertPolicy Policy = InsertPolicy::UniqueKeys, class Allocator = std::allocator<std::pair<const Key, Value>>>
+          InsertPolicy Policy = InsertPolicy::UniqueKeys, class Allocator = std::allocator<std::pair<const Key, Value>>,
+          template <class, class, class, class, class, InsertPolicy, class> class Table = hashtable>
 class unordered_map_base {
  private:
   using ValueType = std::pair<const Key, Value>;
@@ -16,9 +21,11 @@ class unordered_map_base {
     const Key& operator()(const ValueType& v) const noexcept { return v.first; }
   };
 
-  using Base = hashtable<ValueType, Key, KeyOfValue, Hash, KeyEqual, Policy, Allocator>;
+  using Base = Table<ValueType, Key, KeyOfValue, Hash, KeyEqual, Policy, Allocator>;
   Base table;
 
+  static constexpr bool transparent = is_transparent_v<Hash> && is_transparent_v<KeyEqual>;
+
  public:
   using key_type = Key;
   using value_type = Value;
@@ -35,31 +42,151 @@ class unordered_map_base {
 
   // initializer_list ctor
   unordered_map_base(const std::initializer_list<std::pair<Key, Value>>& init) : unordered_map_base() {
+    reserve(init.size());
     for (const auto& kv : init) {
       insert(kv.first, kv.second);
     }
   }
 
+  /// @brief Inserts the key-value pairs of [first, last), a forward range presizes the table for all of them.
+  template <std::input_iterator It>
+  unordered_map_base(It first, It last) : unordered_map_base() {
+    if constexpr (std::forward_iterator<It>) {
+      reserve(std::distance(first, last));
+    }
+    for (; first != last; ++first) {
+      const auto& kv = *first;
+      insert(kv.first, kv.second);
+    }
+  }
+
   // lookup
   size_type count(const key_type& k) const { return table.count(k); }
 
+  /// @brief With transparent Hash and KeyEqual (e.g. my::string_hash, std::equal_to<>) count, contains, find and
+  /// erase take any key type they accept.
+  template <class K>
+    requires transparent
+  size_type count(const K& k) const {
+    return table.count(k);
+  }
+
+  bool contains(const key_type& k) const { return table.contains(k); }
+
+  template <class K>
+    requires transparent
+  bool contains(const K& k) const {
+    return table.contains(k);
+  }
+
   // observers
+  /// @brief Value-initializes the mapped value only if k is missing.
   reference operator[](const key_type& k) {
-    auto [it, inserted] = table.insert({k, value_type{}});
-    return (*it).second;
+    return table.try_emplace(k, std::piecewise_construct, std::forward_as_tuple(k), std::tuple<>()).first->second;
+  }
+
+  reference operator[](key_type&& k) {
+    return table.try_emplace(k, std::piecewise_construct, std::forward_as_tuple(std::move(k)), std::tuple<>())
+        .first->second;
   }
 
   // modifiers
 
-  iterator insert(const key_type& k, const_reference v) {
-    auto it_flag = table.insert({k, v});
-    return it_flag.first;
+  iterator insert(const key_type& k, const_reference v) { return table.try_emplace(k, k, v).first; }
+
+  iterator insert(const key_type& k, value_type&& v) { return table.try_emplace(k, k, std::move(v)).first; }
+
+  /// @brief Constructs the mapped value from args only if k is missing (with unique keys).
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+    return table.try_emplace(k, std::piecewise_construct, std::forward_as_tuple(k),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+    return table.try_emplace(k, std::piecewise_construct, std::forward_as_tuple(std::move(k)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  /// @brief Constructs a std::pair<const Key, Value> from args, e.g. (key, value).
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return table.emplace(std::forward<Args>(args)...);
   }
 
   iterator find(const key_type& k) { return table.find(k); }
 
+  template <class K>
+    requires transparent
+  iterator find(const K& k) {
+    return table.find(k);
+  }
+
+  const_iterator find(const key_type& k) const { return table.find(k); }
+
+  template <class K>
+    requires transparent
+  const_iterator find(const K& k) const {
+    return table.find(k);
+  }
+
   iterator erase(const key_type& k) { return table.erase(k); }
 
+  template <class K>
+    requires transparent
+  iterator erase(const K& k) {
+    return table.erase(k);
+  }
+
+  // node handles, only with an engine that has them (my::hashtable): elements change tables without being
+  // reallocated or rehashed, see my::hashtable::node_type
+
+  template <class B = Base>
+  typename B::node_type extract(const key_type& k) {
+    return table.extract(k);
+  }
+
+  template <class K, class B = Base>
+    requires transparent
+  typename B::node_type extract(const K& k) {
+    return table.extract(k);
+  }
+
+  template <class B = Base>
+  typename B::insert_return_type insert(typename B::node_type&& nh) {
+    return table.insert(std::move(nh));
+  }
+
+  /// @brief Moves over the elements of other whose key is missing here (all of them with repeated keys).
+  template <class B = Base>
+    requires requires(B& t) { t.merge(t); }
+  void merge(unordered_map_base& other) {
+    table.merge(other.table);
+  }
+
+  // batches: the keys of a batch are hashed and their buckets prefetched together, which overlaps the cache
+  // misses of lookups into a table bigger than the cache (see my::hashtable::find_batch)
+
+  /// @brief out[i] = find(first[i])
+  template <std::random_access_iterator It, class OutputIt>
+  OutputIt find_batch(It first, It last, OutputIt out) {
+    return table.find_batch(first, last, out);
+  }
+
+  /// @brief out[i] = contains(first[i])
+  template <std::random_access_iterator It, class OutputIt>
+  OutputIt contains_batch(It first, It last, OutputIt out) const {
+    return table.contains_batch(first, last, out);
+  }
+
+  /// @brief Inserts the (key, value) pairs of [first, last).
+  /// @return number of elements inserted
+  template <std::random_access_iterator It>
+  size_type insert_batch(It first, It last) {
+    return table.insert_batch(first, last);
+  }
+
   // capacity
   size_type size() const { return table.size(); }
 
@@ -67,6 +194,36 @@ class unordered_map_base {
 
   size_type bucket_count() const { return table.bucket_count(); }
 
+  float load_factor() const { return table.load_factor(); }
+
+  /// @brief A Swiss table engine (my::flat_hashtable) has a fixed one.
+  float max_load_factor() const {
+    if constexpr (requires { table.max_load_factor(); }) {
+      return table.max_load_factor();
+    } else {
+      return Base::max_load_factor;
+    }
+  }
+
+  /// @brief Only for an engine with a settable max load factor (my::hashtable).
+  void max_load_factor(float ml)
+    requires requires(Base& t) { t.max_load_factor(ml); }
+  {
+    table.max_load_factor(ml);
+  }
+
+  /// @brief Room for n elements: inserting up to n elements does not rehash.
+  void reserve(size_type n) { table.reserve(n); }
+
+  void shrink_to_fit() { table.shrink_to_fit(); }
+
+  /// @brief The counters of the table, if it collects them (my::hashtable with MYSTD_HASHTABLE_STATS).
+  auto stats() const
+    requires requires(const Base& t) { t.stats(); }
+  {
+    return table.stats();
+  }
+
   // iterators
 
   iterator begin() { return table.begin(); }
@@ -2,6 +2,7 @@
 
 #include <initializer_list>
 
+#include "mystd/flat_hashtable.hpp"
 #include "mystd/unordered_map_base.hpp"
 
 namespace my {
@@ -10,4 +11,10 @@ template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual =
           class Allocator = std::allocator<std::pair<const Key, Value>>>
 using unordered_multimap = unordered_map_base<Key, Value, Hash, KeyEqual, InsertPolicy::AllowDuplicates, Allocator>;
 
+/// @brief Same interface on the open addressing engine, see my::flat_hashtable.
+template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          class Allocator = std::allocator<std::pair<const Key, Value>>>
+using flat_unordered_multimap = unordered_map_base<Key, Value, Hash, KeyEqual, InsertPolicy::AllowDuplicates,
+                                                   Allocator, flat_hashtable>;
+
 }  // namespace my
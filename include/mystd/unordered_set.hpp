@@ -2,6 +2,7 @@
 
 #include <initializer_list>
 
+#include "mystd/flat_hashtable.hpp"
 #include "mystd/unordered_set_base.hpp"
 
 namespace my {
@@ -10,4 +11,10 @@ template <class Value, class Hash = std::hash<Value>, class KeyEqual = std::equa
           class Allocator = std::allocator<Value> >
 using unordered_set = unordered_set_base<Value, Hash, KeyEqual, InsertPolicy::UniqueKeys, Allocator>;
 
+/// @brief Same interface on the open addressing engine, see my::flat_hashtable.
+template <class Value, class Hash = std::hash<Value>, class KeyEqual = std::equal_to<Value>,
+          class Allocator = std::allocator<Value> >
+using flat_unordered_set = unordered_set_base<Value, Hash, KeyEqual, InsertPolicy::UniqueKeys, Allocator,
+                                              flat_hashtable>;
+
 }  // namespace my
@@ -1,22 +1,28 @@
 #pragma once
 
 #include <initializer_list>
+#include <iterator>
+#include <utility>
 
 #include "mystd/hashtable.hpp"
 
 namespace my {
 
+/// @tparam Table -- the hash table engine: my::hashtable (separate chaining) or my::flat_hashtable (open addressing)
 template <class Value, class Hash = std::hash<Value>, class KeyEqual = std::equal_to<Value>,
-          InsertPolicy Policy = InsertPolicy::UniqueKeys, class Allocator = std::allocator<Value>>
+          InsertPolicy Policy = InsertPolicy::UniqueKeys, class Allocator = std::allocator<Value>,
+          template <class, class, class, class, class, InsertPolicy, class> class Table = hashtable>
 class unordered_set_base {
  private:
   struct Identity {
     const Value& operator()(const Value& v) const noexcept { return v; }
   };
 
-  using Base = hashtable<Value, Value, Identity, Hash, KeyEqual, Policy, Allocator>;
+  using Base = Table<Value, Value, Identity, Hash, KeyEqual, Policy, Allocator>;
   Base table;
 
+  static constexpr bool transparent = is_transparent_v<Hash> && is_transparent_v<KeyEqual>;
+
  public:
   using value_type = Value;
   using reference = Value&;
@@ -30,14 +36,42 @@ class unordered_set_base {
 
   // initializer_list ctor
   unordered_set_base(const std::initializer_list<Value>& init) : unordered_set_base() {
+    reserve(init.size());
     for (const auto& v : init) {
       insert(v);
     }
   }
 
+  /// @brief Inserts the values of [first, last), a forward range presizes the table for all of them.
+  template <std::input_iterator It>
+  unordered_set_base(It first, It last) : unordered_set_base() {
+    if constexpr (std::forward_iterator<It>) {
+      reserve(std::distance(first, last));
+    }
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
   // lookup
   size_type count(const value_type& v) const { return table.count(v); }
 
+  /// @brief With transparent Hash and KeyEqual (e.g. my::string_hash, std::equal_to<>) count, contains, find and
+  /// erase take any key type they accept.
+  template <class K>
+    requires transparent
+  size_type count(const K& k) const {
+    return table.count(k);
+  }
+
+  bool contains(const value_type& v) const { return table.contains(v); }
+
+  template <class K>
+    requires transparent
+  bool contains(const K& k) const {
+    return table.contains(k);
+  }
+
   // modifiers
 
   iterator insert(const value_type& v) {
@@ -45,10 +79,84 @@ class unordered_set_base {
     return it_flag.first;
   }
 
+  iterator insert(value_type&& v) { return table.insert(std::move(v)).first; }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return table.emplace(std::forward<Args>(args)...);
+  }
+
   iterator find(const value_type& v) { return table.find(v); }
 
+  template <class K>
+    requires transparent
+  iterator find(const K& k) {
+    return table.find(k);
+  }
+
+  const_iterator find(const value_type& v) const { return table.find(v); }
+
+  template <class K>
+    requires transparent
+  const_iterator find(const K& k) const {
+    return table.find(k);
+  }
+
   iterator erase(const value_type& v) { return table.erase(v); }
 
+  template <class K>
+    requires transparent
+  iterator erase(const K& k) {
+    return table.erase(k);
+  }
+
+  // node handles, only with an engine that has them (my::hashtable): elements change tables without being
+  // reallocated or rehashed, see my::hashtable::node_type
+
+  template <class B = Base>
+  typename B::node_type extract(const value_type& k) {
+    return table.extract(k);
+  }
+
+  template <class K, class B = Base>
+    requires transparent
+  typename B::node_type extract(const K& k) {
+    return table.extract(k);
+  }
+
+  template <class B = Base>
+  typename B::insert_return_type insert(typename B::node_type&& nh) {
+    return table.insert(std::move(nh));
+  }
+
+  /// @brief Moves over the elements of other whose key is missing here (all of them with repeated keys).
+  template <class B = Base>
+    requires requires(B& t) { t.merge(t); }
+  void merge(unordered_set_base& other) {
+    table.merge(other.table);
+  }
+
+  // batches: the keys of a batch are hashed and their buckets prefetched together, which overlaps the cache
+  // misses of lookups into a table bigger than the cache (see my::hashtable::find_batch)
+
+  /// @brief out[i] = find(first[i])
+  template <std::random_access_iterator It, class OutputIt>
+  OutputIt find_batch(It first, It last, OutputIt out) {
+    return table.find_batch(first, last, out);
+  }
+
+  /// @brief out[i] = contains(first[i])
+  template <std::random_access_iterator It, class OutputIt>
+  OutputIt contains_batch(It first, It last, OutputIt out) const {
+    return table.contains_batch(first, last, out);
+  }
+
+  /// @return number of elements inserted
+  template <std::random_access_iterator It>
+  size_type insert_batch(It first, It last) {
+    return table.insert_batch(first, last);
+  }
+
   // capacity
   size_type size() const { return table.size(); }
 
@@ -56,6 +164,36 @@ class unordered_set_base {
 
   size_type bucket_count() const { return table.bucket_count(); }
 
+  float load_factor() const { return table.load_factor(); }
+
+  /// @brief A Swiss table engine (my::flat_hashtable) has a fixed one.
+  float max_load_factor() const {
+    if constexpr (requires { table.max_load_factor(); }) {
+      return table.max_load_factor();
+    } else {
+      return Base::max_load_factor;
+    }
+  }
+
+  /// @brief Only for an engine with a settable max load factor (my::hashtable).
+  void max_load_factor(float ml)
+    requires requires(Base& t) { t.max_load_factor(ml); }
+  {
+    table.max_load_factor(ml);
+  }
+
+  /// @brief Room for n elements: inserting up to n elements does not rehash.
+  void reserve(size_type n) { table.reserve(n); }
+
+  void shrink_to_fit() { table.shrink_to_fit(); }
+
+  /// @brief The counters of the table, if it collects them (my::hashtable with MYSTD_HASHTABLE_STATS).
+  auto stats() const
+    requires requires(const Base& t) { t.stats(); }
+  {
+    return table.stats();
+  }
+
   // iterators
 
   iterator begin() { return table.begin(); }
@@ -1,21 +1,34 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <initializer_list>
+#include <memory>
 #include <ostream>
 #include <stdexcept>
 #include <type_traits>
 
+#include "mystd/growth_policy.hpp"
+#include "mystd/simd.hpp"
+#include "mystd/type_traits.hpp"
+
 namespace my {
 
 const size_t CAPACITY = 25;
-const float REALLOCATION_FACTOR = 2.0;
 
-template <typename T, size_t Capacity = CAPACITY>
+/// @brief Dynamic array.
+///
+/// Storage is raw (uninitialized) memory, only the live range [0, size) holds constructed objects,
+/// so T does not have to be default constructible.
+/// @tparam Capacity -- initial capacity
+/// @tparam Growth -- growth policy, see growth_policy.hpp
+/// @tparam Allocator -- raw storage comes from it, see allocator.hpp for arena and pool allocators
+template <typename T, size_t Capacity = CAPACITY, typename Growth = growth::doubling,
+          typename Allocator = std::allocator<T>>
 class vector {
-  static_assert(std::is_default_constructible<T>(), "Type must be default-constructoble");
-
  public:
   using value_type = T;
+  using allocator_type = Allocator;
   using size_type = size_t;
   using reference = T&;
   using const_reference = const T&;
@@ -25,63 +38,231 @@ class vector {
   using const_iterator = const T*;
 
  private:
-  pointer data_;
+  using alloc_traits = std::allocator_traits<allocator_type>;
+
+  allocator_type alloc_;
+  pointer data_ = nullptr;
   size_type size_ = 0;
   size_type capacity_ = Capacity;
-  float reallocation_factor_ = REALLOCATION_FACTOR;
+
+  /// elements are moved around with memcpy/memmove, see is_trivially_relocatable
+  static constexpr bool relocatable = is_trivially_relocatable_v<T>;
+
+  /// large buffers of relocatable T are owned by the policy and resized without element copies,
+  /// a user supplied allocator always keeps ownership of the storage
+  static constexpr bool remappable = Growth::remaps && relocatable && std::is_same_v<Allocator, std::allocator<T>>;
+
+  static constexpr bool is_mapped(size_type n) noexcept {
+    if constexpr (remappable) {
+      return Growth::is_mapped(n * sizeof(T));
+    } else {
+      return false;
+    }
+  }
+
+  pointer allocate(size_type n) {
+    if (n == 0) return nullptr;
+    if constexpr (remappable) {
+      if (is_mapped(n)) return static_cast<pointer>(Growth::map(n * sizeof(T)));
+    }
+    return alloc_traits::allocate(alloc_, n);
+  }
+
+  void deallocate(pointer p, size_type n) {
+    if (!p) return;
+    if constexpr (remappable) {
+      if (is_mapped(n)) return Growth::unmap(p, n * sizeof(T));
+    }
+    alloc_traits::deallocate(alloc_, p, n);
+  }
+
+  void destroy(pointer first, pointer last) noexcept {
+    for (; first != last; ++first) {
+      alloc_traits::destroy(alloc_, first);
+    }
+  }
+
+  /// @brief Constructs [first, last) in raw memory through the allocator from args (value-initialized without
+  /// args). On exception the elements built so far are destroyed.
+  template <typename... Args>
+  void construct_range(pointer first, pointer last, const Args&... args) {
+    pointer cur = first;
+    try {
+      for (; cur != last; ++cur) {
+        alloc_traits::construct(alloc_, cur, args...);
+      }
+    } catch (...) {
+      destroy(first, cur);
+      throw;
+    }
+  }
+
+  /// @brief Constructs copies of [first, last) in raw memory at dst through the allocator. With std::allocator this
+  /// is uninitialized_copy. On exception nothing is left constructed at dst.
+  template <typename It>
+  void construct_from(It first, It last, pointer dst) {
+    if constexpr (std::is_same_v<Allocator, std::allocator<T>>) {
+      std::uninitialized_copy(first, last, dst);
+    } else {
+      pointer cur = dst;
+      try {
+        for (; first != last; ++first, ++cur) {
+          alloc_traits::construct(alloc_, cur, *first);
+        }
+      } catch (...) {
+        destroy(dst, cur);
+        throw;
+      }
+    }
+  }
+
+  /// @brief Moves [first, last) to raw memory at dst if T has noexcept move ctor (or can not be copied),
+  /// otherwise copies it. On exception nothing is left constructed at dst.
+  void transfer(pointer first, pointer last, pointer dst) {
+    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+      construct_from(std::make_move_iterator(first), std::make_move_iterator(last), dst);
+    } else {
+      construct_from(first, last, dst);
+    }
+  }
+
+  /// @brief Relocates n elements from src to dst, the ranges may overlap. Only for relocatable T.
+  static void move_bytes(pointer dst, const_pointer src, size_type n) noexcept {
+    if (n) std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+  }
+
+  size_type next_capacity() const { return Growth::next_capacity(capacity_, size_ + 1, sizeof(T)); }
+
+  /// @brief Room for count elements, at least the next geometric step if it has to reallocate.
+  void grow_to(size_type count) {
+    if (count > capacity_) {
+      reallocate(std::max(count, next_capacity()));
+    }
+  }
 
   void reallocate(size_type new_capacity) {
-    value_type* new_data = new value_type[new_capacity];
-    std::move(data_, data_ + size_, new_data);
-    delete[] data_;
+    if constexpr (remappable) {
+      if (data_ && is_mapped(capacity_) && is_mapped(new_capacity)) {
+        data_ = static_cast<pointer>(Growth::remap(data_, capacity_ * sizeof(T), new_capacity * sizeof(T)));
+        capacity_ = new_capacity;
+        return;
+      }
+    }
+    pointer new_data = allocate(new_capacity);
+    if constexpr (relocatable) {
+      move_bytes(new_data, data_, size_);
+    } else {
+      try {
+        transfer(data_, data_ + size_, new_data);
+      } catch (...) {
+        deallocate(new_data, new_capacity);
+        throw;
+      }
+      destroy(data_, data_ + size_);
+    }
+    deallocate(data_, capacity_);
     data_ = new_data;
     capacity_ = new_capacity;
   }
 
+  /// @brief Grows storage and constructs a new element at position pos, shifting the tail by one (size_ itself is
+  /// not changed). The element is built before the old buffer is released, because args may refer to an element of
+  /// this vector.
+  template <typename... Args>
+  pointer realloc_insert(size_type pos, Args&&... args) {
+    const size_type new_capacity = next_capacity();
+    if constexpr (remappable) {
+      if (data_ && is_mapped(capacity_) && is_mapped(new_capacity)) {
+        value_type tmp(std::forward<Args>(args)...);  // args may point into the mapping that is about to move
+        reallocate(new_capacity);
+        move_bytes(data_ + pos + 1, data_ + pos, size_ - pos);
+        alloc_traits::construct(alloc_, data_ + pos, std::move(tmp));
+        return data_ + pos;
+      }
+    }
+    pointer new_data = allocate(new_capacity);
+    try {
+      alloc_traits::construct(alloc_, new_data + pos, std::forward<Args>(args)...);
+    } catch (...) {
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    if constexpr (relocatable) {
+      move_bytes(new_data, data_, pos);
+      move_bytes(new_data + pos + 1, data_ + pos, size_ - pos);
+    } else {
+      try {
+        transfer(data_, data_ + pos, new_data);
+        try {
+          transfer(data_ + pos, data_ + size_, new_data + pos + 1);
+        } catch (...) {
+          destroy(new_data, new_data + pos);
+          throw;
+        }
+      } catch (...) {
+        alloc_traits::destroy(alloc_, new_data + pos);
+        deallocate(new_data, new_capacity);
+        throw;
+      }
+      destroy(data_, data_ + size_);
+    }
+    deallocate(data_, capacity_);
+    data_ = new_data;
+    capacity_ = new_capacity;
+    return data_ + pos;
+  }
+
  public:
   // contruction and assignment
 
-  vector() : data_(new value_type[Capacity]), size_(0), capacity_(Capacity) {}
+  vector() : data_(allocate(Capacity)), size_(0), capacity_(Capacity) {}
+
+  explicit vector(const allocator_type& alloc)
+      : alloc_(alloc), data_(allocate(Capacity)), size_(0), capacity_(Capacity) {}
 
   // initializer list
-  vector(std::initializer_list<value_type> init)
-      : data_(new T[init.size()]), size_(init.size()), capacity_(init.size()) {
-    std::copy(init.begin(), init.end(), data_);
+  vector(std::initializer_list<value_type> init, const allocator_type& alloc = allocator_type())
+      : alloc_(alloc), data_(allocate(init.size())), size_(init.size()), capacity_(init.size()) {
+    try {
+      construct_from(init.begin(), init.end(), data_);
+    } catch (...) {
+      deallocate(data_, capacity_);
+      throw;
+    }
   }
 
-  ~vector() { delete[] data_; }
+  ~vector() {
+    destroy(data_, data_ + size_);
+    deallocate(data_, capacity_);
+  }
 
   // copy and copy assigment
-  vector(const vector& other) {
-    const size_t other_size = other.size();
-    const size_t other_capacity = other.capacity();
-
-    data_ = new T[other_capacity];
-    for (size_t i = 0; i < other_size; ++i) {
-      data_[i] = other.data_[i];
+  vector(const vector& other)
+      : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)),
+        data_(allocate(other.capacity_)),
+        size_(0),
+        capacity_(other.capacity_) {
+    try {
+      construct_from(other.data_, other.data_ + other.size_, data_);
+    } catch (...) {
+      deallocate(data_, capacity_);
+      throw;
     }
-    size_ = other_size;
-    capacity_ = other_capacity;
+    size_ = other.size_;
   }
 
   vector& operator=(const vector& other) {
     if (this != &other) {
-      const size_t other_size = other.size();
-      const size_t other_capacity = other.capacity();
-
-      delete[] data_;
-      data_ = new T[other_capacity];
-      for (size_t i = 0; i < other_size; ++i) {
-        data_[i] = other.data_[i];
-      }
-      size_ = other_size;
-      capacity_ = other_capacity;
+      vector tmp(other);
+      swap(tmp);
     }
     return *this;
   }
 
-  // move and move assignment
-  vector(vector&& other) noexcept : data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+  // move and move assignment, the allocator is copied along with the buffer it owns,
+  // so the moved-from vector can still allocate
+  vector(vector&& other) noexcept
+      : alloc_(other.alloc_), data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
     other.data_ = nullptr;
     other.size_ = 0;
     other.capacity_ = 0;
@@ -89,7 +270,9 @@ class vector {
 
   vector& operator=(vector&& other) noexcept {
     if (this != &other) {
-      delete[] data_;
+      destroy(data_, data_ + size_);
+      deallocate(data_, capacity_);
+      alloc_ = other.alloc_;
       data_ = other.data_;
       size_ = other.size_;
       capacity_ = other.capacity_;
@@ -100,6 +283,8 @@ class vector {
     return *this;
   }
 
+  allocator_type get_allocator() const noexcept { return alloc_; }
+
   // capacity
 
   [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
@@ -128,23 +313,133 @@ class vector {
     return data_[index];
   }
 
+  reference front() { return at(0); }
+
+  const_reference front() const { return at(0); }
+
   reference back() { return at(size_ - 1); }
 
   const_reference back() const { return at(size_ - 1); }
 
   // modifiers
 
-  void push_back(const_reference value) {
+  void push_back(const_reference value) { emplace_back(value); }
+
+  void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    pointer slot = data_ + size_;
     if (capacity_ < size_ + 1) {
-      reallocate(capacity_ * reallocation_factor_);
+      slot = realloc_insert(size_, std::forward<Args>(args)...);
+    } else {
+      alloc_traits::construct(alloc_, slot, std::forward<Args>(args)...);
     }
-    data_[size_] = value;
     ++size_;
+    return *slot;
+  }
+
+  void pop_back() {
+    --size_;
+    alloc_traits::destroy(alloc_, data_ + size_);
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    const size_type idx = pos - data_;
+    if (capacity_ < size_ + 1) {
+      pointer slot = realloc_insert(idx, std::forward<Args>(args)...);
+      ++size_;
+      return slot;
+    }
+    if (idx == size_) {
+      alloc_traits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+      ++size_;
+      return data_ + idx;
+    }
+    // args may refer to an element that is about to be shifted
+    value_type tmp(std::forward<Args>(args)...);
+    if constexpr (relocatable) {
+      move_bytes(data_ + idx + 1, data_ + idx, size_ - idx);
+      try {
+        alloc_traits::construct(alloc_, data_ + idx, std::move(tmp));
+      } catch (...) {
+        move_bytes(data_ + idx, data_ + idx + 1, size_ - idx);
+        throw;
+      }
+      ++size_;
+    } else {
+      alloc_traits::construct(alloc_, data_ + size_, std::move(data_[size_ - 1]));
+      ++size_;  // the new last element is owned from here on, even if a move below throws
+      std::move_backward(data_ + idx, data_ + size_ - 2, data_ + size_ - 1);
+      data_[idx] = std::move(tmp);
+    }
+    return data_ + idx;
+  }
+
+  iterator insert(const_iterator pos, const_reference value) { return emplace(pos, value); }
+
+  iterator insert(const_iterator pos, value_type&& value) { return emplace(pos, std::move(value)); }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    pointer f = data_ + (first - data_);
+    pointer l = data_ + (last - data_);
+    if (f == l) return f;
+    if constexpr (relocatable) {
+      destroy(f, l);
+      move_bytes(f, l, data_ + size_ - l);
+      size_ -= l - f;
+    } else {
+      pointer new_end = std::move(l, data_ + size_, f);
+      destroy(new_end, data_ + size_);
+      size_ = new_end - data_;
+    }
+    return f;
+  }
+
+  void clear() noexcept {
+    destroy(data_, data_ + size_);
+    size_ = 0;
+  }
+
+  void reserve(size_type new_capacity) {
+    if (new_capacity > capacity_) {
+      reallocate(new_capacity);
+    }
   }
 
-  void pop_back() { --size_; }
+  void shrink_to_fit() {
+    if (capacity_ > size_) {
+      reallocate(size_);
+    }
+  }
 
-  void insert(const_reference value) { assert("TODO Implement me, please"); }
+  /// @brief Grows geometrically like push_back when count exceeds the capacity, so that a loop of
+  /// resize(size() + 1) reallocates O(log n) times. reserve stays exact.
+  void resize(size_type count) {
+    if (count < size_) {
+      destroy(data_ + count, data_ + size_);
+    } else {
+      grow_to(count);
+      construct_range(data_ + size_, data_ + count);
+    }
+    size_ = count;
+  }
+
+  void resize(size_type count, const_reference value) {
+    if (count < size_) {
+      destroy(data_ + count, data_ + size_);
+    } else if (count > capacity_) {
+      value_type tmp(value);  // value may live in the buffer being released
+      grow_to(count);
+      construct_range(data_ + size_, data_ + count, tmp);
+    } else {
+      construct_range(data_ + size_, data_ + count, value);
+    }
+    size_ = count;
+  }
 
   // iterators
 
@@ -157,6 +452,7 @@ class vector {
   const_iterator end() const { return data_ + size_; }
 
   void swap(vector& other) noexcept {
+    std::swap(alloc_, other.alloc_);
     std::swap(data_, other.data_);
     std::swap(size_, other.size_);
     std::swap(capacity_, other.capacity_);
@@ -165,48 +461,43 @@ class vector {
 
 // non-member methods
 
-template <typename T, size_t Capacity = CAPACITY>
-bool operator==(const vector<T>& lhs, const vector<T>& rhs) {
-  return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+template <typename T, size_t Capacity, typename Growth, typename Alloc>
+bool operator==(const vector<T, Capacity, Growth, Alloc>& lhs, const vector<T, Capacity, Growth, Alloc>& rhs) {
+  return lhs.size() == rhs.size() && simd::equal(lhs.data(), rhs.data(), lhs.size());
 }
 
-template <typename T, size_t Capacity = CAPACITY>
-bool operator!=(const vector<T>& lhs, const vector<T> rhs) {
+template <typename T, size_t Capacity, typename Growth, typename Alloc>
+bool operator!=(const vector<T, Capacity, Growth, Alloc>& lhs, const vector<T, Capacity, Growth, Alloc>& rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T, size_t Capacity = CAPACITY>
-bool operator<(const vector<T>& lhs, const vector<T> rhs) {
-  for (size_t i = 0; i < lhs.size(); ++i) {
-    if (lhs[i] >= rhs[i]) {
-      return false;
-    }
-  }
-  return true;
+template <typename T, size_t Capacity, typename Growth, typename Alloc>
+bool operator<(const vector<T, Capacity, Growth, Alloc>& lhs, const vector<T, Capacity, Growth, Alloc>& rhs) {
+  return simd::compare(lhs.data(), lhs.size(), rhs.data(), rhs.size()) < 0;
 }
 
-template <typename T, size_t Capacity = CAPACITY>
-bool operator>=(const vector<T>& lhs, const vector<T> rhs) {
+template <typename T, size_t Capacity, typename Growth, typename Alloc>
+bool operator>=(const vector<T, Capacity, Growth, Alloc>& lhs, const vector<T, Capacity, Growth, Alloc>& rhs) {
   return !(lhs < rhs);
 }
 
-template <typename T, size_t Capacity = CAPACITY>
-bool operator>(const vector<T>& lhs, const vector<T> rhs) {
+template <typename T, size_t Capacity, typename Growth, typename Alloc>
+bool operator>(const vector<T, Capacity, Growth, Alloc>& lhs, const vector<T, Capacity, Growth, Alloc>& rhs) {
   return rhs < lhs;
 }
 
-template <typename T, size_t Capacity = CAPACITY>
-bool operator<=(const vector<T>& lhs, const vector<T> rhs) {
+template <typename T, size_t Capacity, typename Growth, typename Alloc>
+bool operator<=(const vector<T, Capacity, Growth, Alloc>& lhs, const vector<T, Capacity, Growth, Alloc>& rhs) {
   return !(lhs > rhs);
 }
 
-template <typename T, size_t Capacity = CAPACITY>
-void swap(vector<T>& lhs, vector<T>& rhs) {
+template <typename T, size_t Capacity, typename Growth, typename Alloc>
+void swap(vector<T, Capacity, Growth, Alloc>& lhs, vector<T, Capacity, Growth, Alloc>& rhs) {
   lhs.swap(rhs);
 }
 
-template <typename T, size_t Capacity = CAPACITY>
-std::ostream& operator<<(std::ostream& os, const vector<T>& arr) {
+template <typename T, size_t Capacity, typename Growth, typename Alloc>
+std::ostream& operator<<(std::ostream& os, const vector<T, Capacity, Growth, Alloc>& arr) {
   const size_t N = arr.size();
   for (size_t i = 0; i < N; ++i) {
     os << arr[i];
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "mystd/allocator.hpp"
+#include "mystd/deque_blocks_based.hpp"
+#include "mystd/deque_cyclicbuffer_based.hpp"
+#include "mystd/list_linked_nodes.hpp"
+#include "mystd/vector.hpp"
+
+// Per request workload: every iteration builds a few short lived containers, reads them and throws them away.
+// With std::allocator each node/buffer is a malloc/free pair, with the arena the whole request is one release().
+
+constexpr size_t ELEMENTS = 256;
+
+template <typename Alloc>
+using vector_t = my::vector<uint64_t, 4, my::growth::doubling, Alloc>;
+
+template <typename Alloc>
+using list_t = my::heapbased::list<uint64_t, Alloc>;
+
+template <typename Alloc>
+using blocks_deque_t = my::blocksbased::deque<uint64_t, 16, Alloc>;
+
+template <typename Alloc>
+using ring_deque_t = my::cyclicbufferbased::deque<uint64_t, 4, Alloc>;
+
+/// @brief One request: fills every container and sums its contents.
+template <typename Alloc>
+uint64_t handle_request(const Alloc& alloc) {
+  vector_t<Alloc> v(alloc);
+  list_t<Alloc> l(alloc);
+  blocks_deque_t<Alloc> bd(alloc);
+  ring_deque_t<Alloc> rd(alloc);
+  for (uint64_t i = 0; i < ELEMENTS; ++i) {
+    v.push_back(i);
+    l.push_back(i);
+    bd.push_back(i);
+    rd.push_back(i);
+  }
+  uint64_t sum = 0;
+  for (auto x : v) sum += x;
+  for (auto x : l) sum += x;
+  for (size_t i = 0; i < bd.size(); ++i) sum += bd[i];
+  for (size_t i = 0; i < rd.size(); ++i) sum += rd[i];
+  return sum;
+}
+
+static void BM_RequestStdAllocator(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(handle_request(std::allocator<uint64_t>()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RequestStdAllocator);
+
+static void BM_RequestArena(benchmark::State& state) {
+  my::monotonic_arena arena(64 * 1024);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(handle_request(my::arena_allocator<uint64_t>(arena)));
+    arena.release();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RequestArena);
+
+// arena on a stack buffer: a request that fits does not touch the heap at all
+static void BM_RequestArenaOnStack(benchmark::State& state) {
+  alignas(std::max_align_t) static std::byte buffer[64 * 1024];
+  my::monotonic_arena arena(buffer, sizeof(buffer));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(handle_request(my::arena_allocator<uint64_t>(arena)));
+    arena.release();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RequestArenaOnStack);
+
+// node churn: the list keeps a steady size while nodes are erased and inserted
+template <typename Alloc>
+static void BM_ListChurn(benchmark::State& state) {
+  list_t<Alloc> l;
+  for (uint64_t i = 0; i < ELEMENTS; ++i) {
+    l.push_back(i);
+  }
+  uint64_t i = 0;
+  for (auto _ : state) {
+    l.pop_front();
+    l.push_back(++i);
+  }
+  benchmark::DoNotOptimize(l.back());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ListChurn<std::allocator<uint64_t>>);
+BENCHMARK(BM_ListChurn<my::pool_allocator<uint64_t>>);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include "mystd/concurrent_unordered_map.hpp"
+#include "mystd/unordered_map.hpp"
+
+// Scaling with the number of threads on one shared map of KEYS preloaded keys. Every thread draws random keys
+// and either looks one up or writes it: a read-heavy mix (95% finds, 5% insert_or_assign) and a write-heavy mix
+// (50% finds, 25% insert_or_assign, 25% erase). The baseline is my::unordered_map under a single mutex.
+
+constexpr uint64_t KEYS = 1 << 16;
+
+/// @brief my::unordered_map under a mutex, with the interface of my::concurrent_unordered_map.
+class mutex_map {
+  mutable std::mutex m_;
+  my::unordered_map<uint64_t, uint64_t> map_;
+
+ public:
+  std::optional<uint64_t> find(uint64_t k) const {
+    std::lock_guard lock(m_);
+    auto it = map_.find(k);
+    if (it == map_.end()) return std::nullopt;
+    return it->second;
+  }
+
+  bool insert_or_assign(uint64_t k, uint64_t v) {
+    std::lock_guard lock(m_);
+    auto [it, inserted] = map_.try_emplace(k, v);
+    if (!inserted) it->second = v;
+    return inserted;
+  }
+
+  bool erase(uint64_t k) {
+    std::lock_guard lock(m_);
+    const size_t before = map_.size();
+    map_.erase(k);
+    return map_.size() != before;
+  }
+};
+
+using sharded_map = my::concurrent_unordered_map<uint64_t, uint64_t>;
+
+/// @tparam WritePercent -- the share of operations that write, half of them erase when EraseWrites
+template <typename Map, unsigned WritePercent, bool EraseWrites>
+static void BM_Mix(benchmark::State& state) {
+  static Map map;
+  if (state.thread_index() == 0) {
+    for (uint64_t k = 0; k < KEYS; ++k) {
+      map.insert_or_assign(k, k);
+    }
+  }
+  uint64_t x = 0x9E3779B97F4A7C15ull * (state.thread_index() + 1);  // xorshift, a stream per thread
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    const uint64_t k = x % KEYS;
+    if (x / KEYS % 100 >= WritePercent) {
+      sum += map.find(k).value_or(0);
+    } else if (EraseWrites && ((x >> 40) & 1)) {  // not a bit of k: both hit every key
+      sum += map.erase(k);
+    } else {
+      sum += map.insert_or_assign(k, x);
+    }
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Mix<mutex_map, 5, false>)->Name("BM_ReadHeavy<mutex_map>")->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_Mix<sharded_map, 5, false>)->Name("BM_ReadHeavy<sharded_map>")->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_Mix<mutex_map, 50, true>)->Name("BM_WriteHeavy<mutex_map>")->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_Mix<sharded_map, 50, true>)->Name("BM_WriteHeavy<sharded_map>")->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
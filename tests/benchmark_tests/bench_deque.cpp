@@ -0,0 +1,202 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <vector>
+
+#include "mystd/deque_blocks_based.hpp"
+#include "mystd/deque_cyclicbuffer_based.hpp"
+
+// Indexed and iterator scans: both deques are O(1) per access, std::deque is the reference.
+
+using blocks_deque = my::blocksbased::deque<uint64_t, 64>;
+using ring_deque = my::cyclicbufferbased::deque<uint64_t>;
+
+template <typename Deque>
+Deque make_deque(size_t n) {
+  Deque d;
+  for (size_t i = 0; i < n; ++i) {
+    if (i % 2) {
+      d.push_back(i);
+    } else {
+      d.push_front(i);
+    }
+  }
+  return d;
+}
+
+template <typename Deque>
+static void BM_IndexedScan(benchmark::State& state) {
+  const size_t n = state.range(0);
+  const Deque d = make_deque<Deque>(n);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+      sum += d[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_IndexedScan<std::deque<uint64_t>>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_IndexedScan<blocks_deque>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_IndexedScan<ring_deque>)->Range(1 << 10, 1 << 20);
+
+template <typename Deque>
+static void BM_IteratorScan(benchmark::State& state) {
+  const size_t n = state.range(0);
+  Deque d = make_deque<Deque>(n);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (auto x : d) {
+      sum += x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_IteratorScan<std::deque<uint64_t>>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_IteratorScan<blocks_deque>)->Range(1 << 10, 1 << 20);
+
+// random access pattern: no help from the prefetcher
+template <typename Deque>
+static void BM_RandomAccess(benchmark::State& state) {
+  const size_t n = state.range(0);
+  const Deque d = make_deque<Deque>(n);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    uint64_t i = 0;
+    for (size_t k = 0; k < n; ++k) {
+      i = (i * 6364136223846793005ULL + 1442695040888963407ULL);
+      sum += d[(i >> 17) % n];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_RandomAccess<std::deque<uint64_t>>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_RandomAccess<blocks_deque>)->Range(1 << 10, 1 << 20);
+
+template <typename Deque>
+static void BM_PushBothEnds(benchmark::State& state) {
+  const size_t n = state.range(0);
+  for (auto _ : state) {
+    Deque d = make_deque<Deque>(n);
+    benchmark::DoNotOptimize(d.size());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_PushBothEnds<std::deque<uint64_t>>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_PushBothEnds<blocks_deque>)->Range(1 << 10, 1 << 20);
+
+// FIFO ping-pong: a queue of a few elements slides through the blocks, every BlockCapacity operations
+// a block empties at the front and a new one is needed at the back
+template <typename Deque>
+static void BM_FifoPingPong(benchmark::State& state) {
+  const size_t depth = state.range(0);
+  Deque d;
+  for (size_t i = 0; i < depth; ++i) {
+    d.push_back(i);
+  }
+  uint64_t i = 0;
+  for (auto _ : state) {
+    d.push_back(++i);
+    benchmark::DoNotOptimize(d.front());
+    d.pop_front();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FifoPingPong<std::deque<uint64_t>>)->Arg(1)->Arg(100);
+BENCHMARK(BM_FifoPingPong<my::blocksbased::deque<uint64_t, 64, std::allocator<uint64_t>, 0>>)->Arg(1)->Arg(100);
+BENCHMARK(BM_FifoPingPong<blocks_deque>)->Arg(1)->Arg(100);
+
+// push/pop on the same end right at a block boundary: without spare blocks every push allocates
+template <typename Deque>
+static void BM_BoundaryPingPong(benchmark::State& state) {
+  Deque d;
+  for (size_t i = 0; i < 64 / 2; ++i) {
+    d.push_back(0);  // the first element starts in the middle of a block, now the block is full
+  }
+  for (auto _ : state) {
+    d.push_back(1);
+    d.pop_back();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoundaryPingPong<my::blocksbased::deque<uint64_t, 64, std::allocator<uint64_t>, 0>>);
+BENCHMARK(BM_BoundaryPingPong<blocks_deque>);
+
+// batch ingest: a network batch is appended and then consumed from the front
+template <typename Deque, bool Bulk>
+static void BM_BatchIngest(benchmark::State& state) {
+  std::vector<uint64_t> batch(state.range(0));
+  std::iota(batch.begin(), batch.end(), 0);
+  Deque d;
+  for (auto _ : state) {
+    if constexpr (Bulk) {
+      d.append_range(batch);
+    } else {
+      for (auto x : batch) {
+        d.push_back(x);
+      }
+    }
+    benchmark::DoNotOptimize(d.back());
+    d.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_BatchIngest<blocks_deque, false>)->Arg(4096);
+BENCHMARK(BM_BatchIngest<blocks_deque, true>)->Arg(4096);
+BENCHMARK(BM_BatchIngest<ring_deque, false>)->Arg(4096);
+BENCHMARK(BM_BatchIngest<ring_deque, true>)->Arg(4096);
+
+// the consumer side: sum over the spans of segments() lets the compiler vectorize the inner loop
+template <typename Deque>
+static void BM_SegmentsScan(benchmark::State& state) {
+  const size_t n = state.range(0);
+  const Deque d = make_deque<Deque>(n);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (auto segment : d.segments()) {
+      for (auto x : segment) {
+        sum += x;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_SegmentsScan<blocks_deque>)->Arg(1 << 16);
+BENCHMARK(BM_SegmentsScan<ring_deque>)->Arg(1 << 16);
+BENCHMARK(BM_IteratorScan<blocks_deque>)->Arg(1 << 16);
+
+// sliding window over a stream: keep the last N samples and read the window after every sample.
+// The growing deque needs a pop_front per push, the overwrite ring replaces the oldest slot in place;
+// with N a power of two the ring masks positions, with N = 1000 it divides.
+template <typename Deque, bool Ring>
+static void BM_SlidingWindow(benchmark::State& state) {
+  constexpr size_t window = 1000;
+  Deque d;
+  uint64_t sample = 0;
+  for (auto _ : state) {
+    if constexpr (Ring) {
+      d.push_back(++sample);
+    } else {
+      if (d.size() == window) d.pop_front();
+      d.push_back(++sample);
+    }
+    benchmark::DoNotOptimize(d[d.size() / 2]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SlidingWindow<std::deque<uint64_t>, false>);
+BENCHMARK(BM_SlidingWindow<ring_deque, false>);
+BENCHMARK(BM_SlidingWindow<my::cyclicbufferbased::deque<uint64_t, 1000, std::allocator<uint64_t>,
+                                                        my::cyclicbufferbased::on_full::overwrite>,
+                           true>);
+BENCHMARK(BM_SlidingWindow<my::cyclicbufferbased::deque<uint64_t, 1024, std::allocator<uint64_t>,
+                                                        my::cyclicbufferbased::on_full::overwrite>,
+                           true>);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mystd/array.hpp"
+#include "mystd/frozen_map.hpp"
+#include "mystd/map.hpp"
+#include "mystd/unordered_map.hpp"
+
+// Lookups in static tables that never change after startup, all hits in a shuffled order: a small one of HTTP
+// header names (32 std::string_view keys) and a medium one of sparse opcodes (1024 integer keys).
+// frozen: my::frozen_map, a perfect hash built at compile time (one hash, one comparison); hashed: the chained
+// my::unordered_map; tree: my::map.
+
+using Value = std::uint32_t;
+
+constexpr my::array<std::pair<std::string_view, Value>, 32> headers = {
+    {"accept", 0}, {"accept-encoding", 1}, {"accept-language", 2}, {"authorization", 3}, {"cache-control", 4},
+    {"connection", 5}, {"content-encoding", 6}, {"content-length", 7}, {"content-type", 8}, {"cookie", 9}, {"date", 10},
+    {"etag", 11}, {"expect", 12}, {"expires", 13}, {"forwarded", 14}, {"host", 15}, {"if-match", 16},
+    {"if-modified-since", 17}, {"if-none-match", 18}, {"last-modified", 19}, {"location", 20}, {"origin", 21},
+    {"pragma", 22}, {"range", 23}, {"referer", 24}, {"retry-after", 25}, {"server", 26}, {"set-cookie", 27},
+    {"transfer-encoding", 28}, {"upgrade", 29}, {"user-agent", 30}, {"vary", 31}};
+
+constexpr std::size_t OPCODES = 1024;
+
+/// sparse 32 bit opcodes, the value of an opcode is its index
+constexpr my::frozen_map<Value, Value, OPCODES> make_opcodes() {
+  my::array<std::pair<Value, Value>, OPCODES> values;
+  for (Value i = 0; i < OPCODES; ++i) {
+    values[i] = {i * 2654435761u, i};
+  }
+  return my::frozen_map<Value, Value, OPCODES>(values);
+}
+
+constexpr auto frozen_headers = my::frozen_map(headers);
+constexpr auto frozen_opcodes = make_opcodes();
+
+template <class Key>
+using hashed = my::unordered_map<Key, Value>;
+
+template <class Key>
+using tree = my::map<Key, Value>;
+
+/// @return a runtime map with the contents of the frozen one
+template <class Map, class Frozen>
+Map load(const Frozen& frozen) {
+  Map m;
+  for (const auto& [k, v] : frozen) {
+    m[k] = v;
+  }
+  return m;
+}
+
+/// @brief Looks up every key of the table 16 times, shuffled.
+template <class Map, class Frozen>
+void find_all(benchmark::State& state, Map& m, const Frozen& frozen) {
+  std::vector<typename Frozen::key_type> keys;
+  for (int round = 0; round < 16; ++round) {
+    for (const auto& kv : frozen) {
+      keys.push_back(kv.first);
+    }
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m.find(keys[i])->second);
+    if (++i == keys.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_HeadersFrozen(benchmark::State& state) { find_all(state, frozen_headers, frozen_headers); }
+BENCHMARK(BM_HeadersFrozen);
+
+template <class Map>
+static void BM_Headers(benchmark::State& state) {
+  Map m = load<Map>(frozen_headers);
+  find_all(state, m, frozen_headers);
+}
+BENCHMARK(BM_Headers<hashed<std::string_view>>);
+BENCHMARK(BM_Headers<tree<std::string_view>>);
+
+static void BM_OpcodesFrozen(benchmark::State& state) { find_all(state, frozen_opcodes, frozen_opcodes); }
+BENCHMARK(BM_OpcodesFrozen);
+
+template <class Map>
+static void BM_Opcodes(benchmark::State& state) {
+  Map m = load<Map>(frozen_opcodes);
+  find_all(state, m, frozen_opcodes);
+}
+BENCHMARK(BM_Opcodes<hashed<Value>>);
+BENCHMARK(BM_Opcodes<tree<Value>>);
+
+BENCHMARK_MAIN();
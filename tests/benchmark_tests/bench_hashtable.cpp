@@ -0,0 +1,351 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "mystd/allocator.hpp"
+#include "mystd/unordered_map.hpp"
+
+// Hit, miss, insert and erase on random 64 bit keys: the chained my::unordered_map (a node per element),
+// the open addressing my::flat_unordered_map (flat slots + SIMD control bytes) and std::unordered_map.
+// pooled_map is the chained map with its nodes in a my::pool_allocator.
+
+using std_map = std::unordered_map<uint64_t, uint64_t>;
+using chained_map = my::unordered_map<uint64_t, uint64_t>;
+using flat_map = my::flat_unordered_map<uint64_t, uint64_t>;
+using pooled_map = my::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                     my::pool_allocator<std::pair<const uint64_t, uint64_t>>>;
+
+/// @return n distinct random keys, all with the top bit clear (keys with it set are never inserted: misses)
+std::vector<uint64_t> make_keys(size_t n, uint64_t seed = 42) {
+  std::mt19937_64 gen(seed);
+  std::vector<uint64_t> keys(n);
+  for (auto& k : keys) {
+    k = gen() >> 1;
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  std::shuffle(keys.begin(), keys.end(), gen);
+  return keys;
+}
+
+template <typename Map>
+void put(Map& m, uint64_t k, uint64_t v) {
+  m.insert(k, v);
+}
+
+void put(std_map& m, uint64_t k, uint64_t v) { m.emplace(k, v); }
+
+template <typename Map>
+Map make_map(const std::vector<uint64_t>& keys) {
+  Map m;
+  for (auto k : keys) {
+    put(m, k, k);
+  }
+  return m;
+}
+
+template <typename Map>
+static void BM_FindHit(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  Map m = make_map<Map>(keys);
+  auto lookups = keys;
+  std::shuffle(lookups.begin(), lookups.end(), std::mt19937_64(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m.find(lookups[i])->second);
+    if (++i == lookups.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindHit<std_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_FindHit<chained_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_FindHit<flat_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+template <typename Map>
+static void BM_FindMiss(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  Map m = make_map<Map>(keys);
+  auto misses = make_keys(state.range(0), 7);
+  for (auto& k : misses) {
+    k |= uint64_t{1} << 63;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m.find(misses[i]) == m.end());
+    if (++i == misses.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindMiss<std_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_FindMiss<chained_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_FindMiss<flat_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// builds the whole table from empty, growth included
+template <typename Map>
+static void BM_Insert(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  for (auto _ : state) {
+    Map m = make_map<Map>(keys);
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_Insert<std_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Insert<chained_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Insert<flat_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// loads a dataset of known size, with or without reserve(n) first: without it the load goes through a rehash
+// per doubling of the table (21 for 8Mi keys in the chained map, from 8 buckets)
+// The previous table is destroyed untimed, and so is the first big allocation after it: glibc merges millions of
+// freed nodes there, which would be charged to whichever bucket array comes first.
+template <typename Map, bool Reserve>
+static void BM_Load(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  for (auto _ : state) {
+    auto m = std::make_unique<Map>();
+    if constexpr (Reserve) {
+      m->reserve(keys.size());
+    }
+    for (auto k : keys) {
+      put(*m, k, k);
+    }
+    benchmark::DoNotOptimize(m->size());
+
+    state.PauseTiming();
+    m.reset();
+    benchmark::DoNotOptimize(std::make_unique<char[]>(1 << 20).get());
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_Load<std_map, false>)->Arg(1 << 20)->Arg(1 << 23)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Load<std_map, true>)->Arg(1 << 20)->Arg(1 << 23)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Load<chained_map, false>)->Arg(1 << 20)->Arg(1 << 23)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Load<chained_map, true>)->Arg(1 << 20)->Arg(1 << 23)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Load<flat_map, false>)->Arg(1 << 20)->Arg(1 << 23)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Load<flat_map, true>)->Arg(1 << 20)->Arg(1 << 23)->Unit(benchmark::kMillisecond);
+
+// erases every key of a full table, the rebuild is not timed
+template <typename Map>
+static void BM_Erase(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Map m = make_map<Map>(keys);
+    state.ResumeTiming();
+    for (auto k : keys) {
+      m.erase(k);
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_Erase<std_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Erase<chained_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Erase<flat_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// A sliding window of n live keys: every step erases the oldest key and inserts a new one, the size and the
+// bucket array stay put, so the cost is lookup + node deallocation/allocation (malloc or the pool free list).
+template <typename Map>
+static void BM_Churn(benchmark::State& state) {
+  const size_t n = state.range(0);
+  const auto keys = make_keys(2 * n);
+  Map m;
+  for (size_t i = 0; i < n; ++i) {
+    put(m, keys[i], keys[i]);
+  }
+  size_t oldest = 0;
+  for (auto _ : state) {
+    const size_t next = oldest + n < keys.size() ? oldest + n : oldest + n - keys.size();
+    m.erase(keys[oldest]);
+    put(m, keys[next], keys[next]);
+    if (++oldest == keys.size()) oldest = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Churn<std_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Churn<chained_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Churn<pooled_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Churn<flat_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// Frames of 256 hit lookups, one find at a time vs find_batch (hash + prefetch 16 keys, then resolve).
+// With 8Mi keys both tables are several times bigger than the L3 cache, nearly every bucket/node/slot is a miss.
+template <typename Map, bool Batched>
+static void BM_FindFrame(benchmark::State& state) {
+  constexpr size_t FRAME = 256;
+  const auto keys = make_keys(state.range(0));
+  Map m = make_map<Map>(keys);
+  auto lookups = keys;
+  std::shuffle(lookups.begin(), lookups.end(), std::mt19937_64(1));
+  std::vector<typename Map::iterator> found;
+  found.reserve(FRAME);
+  size_t i = 0;
+  for (auto _ : state) {
+    found.clear();
+    if constexpr (Batched) {
+      m.find_batch(lookups.begin() + i, lookups.begin() + i + FRAME, std::back_inserter(found));
+    } else {
+      for (size_t j = i; j < i + FRAME; ++j) {
+        found.push_back(m.find(lookups[j]));
+      }
+    }
+    benchmark::DoNotOptimize(found.data());
+    i += FRAME;
+    if (i + FRAME > lookups.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations() * FRAME);
+}
+BENCHMARK(BM_FindFrame<chained_map, false>)->Arg(1 << 16)->Arg(1 << 23);
+BENCHMARK(BM_FindFrame<chained_map, true>)->Arg(1 << 16)->Arg(1 << 23);
+BENCHMARK(BM_FindFrame<flat_map, false>)->Arg(1 << 16)->Arg(1 << 23);
+BENCHMARK(BM_FindFrame<flat_map, true>)->Arg(1 << 16)->Arg(1 << 23);
+
+// Bucket policies of the chained table on integer keys with std::hash (the identity).
+// Sequential keys fill the buckets evenly under every policy; strided keys (multiples of 4096) all share their
+// low bits, so a mask without a mix puts them into count / 4096 buckets, and so does modulo, whose counts grow
+// as 3 * 2^k. prime pays a division per lookup, power_of_two a multiply-xorshift and a mask.
+
+/// @brief Masking without mixing, only to show why bucket_policy::power_of_two mixes.
+struct mask_only {
+  static size_t mix(size_t h) noexcept { return h; }
+  static size_t bucket_count(size_t n) noexcept { return std::bit_ceil(std::max<size_t>(n, 1)); }
+  static size_t index(size_t h, size_t count) noexcept { return h & (count - 1); }
+};
+
+template <class BucketPolicy>
+using policy_map = my::unordered_map_base<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                          my::InsertPolicy::UniqueKeys,
+                                          std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                          my::hashtable_with_buckets<BucketPolicy>::template type>;
+
+template <class BucketPolicy, uint64_t Stride>
+static void BM_IntegerKeysFind(benchmark::State& state) {
+  const size_t n = state.range(0);
+  policy_map<BucketPolicy> m;
+  std::vector<uint64_t> lookups(n);
+  for (size_t i = 0; i < n; ++i) {
+    m.insert(i * Stride, i);
+    lookups[i] = i * Stride;
+  }
+  std::shuffle(lookups.begin(), lookups.end(), std::mt19937_64(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m.find(lookups[i])->second);
+    if (++i == n) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IntegerKeysFind<my::bucket_policy::modulo, 1>)->Arg(1 << 16);
+BENCHMARK(BM_IntegerKeysFind<my::bucket_policy::prime, 1>)->Arg(1 << 16);
+BENCHMARK(BM_IntegerKeysFind<my::bucket_policy::power_of_two, 1>)->Arg(1 << 16);
+BENCHMARK(BM_IntegerKeysFind<mask_only, 1>)->Arg(1 << 16);
+BENCHMARK(BM_IntegerKeysFind<my::bucket_policy::modulo, 4096>)->Arg(1 << 16);
+BENCHMARK(BM_IntegerKeysFind<my::bucket_policy::prime, 4096>)->Arg(1 << 16);
+BENCHMARK(BM_IntegerKeysFind<my::bucket_policy::power_of_two, 4096>)->Arg(1 << 16);
+BENCHMARK(BM_IntegerKeysFind<mask_only, 4096>)->Arg(1 << 16);
+
+// Per insert latency while a chained table grows from empty to n keys: stop-the-world rehash moves every node
+// inside one insert, incremental rehash moves a few buckets per operation. Reported as counters in ns.
+
+template <class RehashPolicy>
+using rehash_engine = my::hashtable_with_buckets<my::bucket_policy::modulo, RehashPolicy>;
+
+template <class RehashPolicy>
+using rehash_map = my::unordered_map_base<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                          my::InsertPolicy::UniqueKeys,
+                                          std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                          rehash_engine<RehashPolicy>::template type>;
+
+template <class RehashPolicy>
+static void BM_InsertLatency(benchmark::State& state) {
+  using clock = std::chrono::steady_clock;
+  const auto keys = make_keys(state.range(0));
+  std::vector<uint64_t> latency(keys.size());
+  for (auto _ : state) {
+    rehash_map<RehashPolicy> m;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const auto start = clock::now();
+      m.insert(keys[i], keys[i]);
+      latency[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  std::sort(latency.begin(), latency.end());
+  state.counters["p50_ns"] = latency[latency.size() / 2];
+  state.counters["p99.9_ns"] = latency[latency.size() * 999 / 1000];
+  state.counters["max_ns"] = latency.back();
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_InsertLatency<my::rehash_policy::stop_the_world>)->Arg(1 << 16)->Arg(1 << 21)->Iterations(1);
+BENCHMARK(BM_InsertLatency<my::rehash_policy::incremental<>>)->Arg(1 << 16)->Arg(1 << 21)->Iterations(1);
+
+// Miss-heavy lookups, 9 keys in 10 absent, up to a table far bigger than the cache. With fingerprinted buckets a
+// miss reads its bucket and no node, unless the filter bit of its hash is set by chance.
+
+template <class BucketPolicy>
+static void BM_MissHeavy(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  policy_map<BucketPolicy> m;
+  m.reserve(keys.size());
+  for (auto k : keys) {
+    m.insert(k, k);
+  }
+  std::mt19937_64 gen(7);
+  std::vector<uint64_t> lookups(1 << 20);
+  for (auto& k : lookups) {
+    k = gen() % 10 == 0 ? keys[gen() % keys.size()] : gen() | uint64_t{1} << 63;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m.find(lookups[i]) == m.end());
+    if (++i == lookups.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MissHeavy<my::bucket_policy::modulo>)->Arg(1 << 20)->Arg(1 << 25);
+BENCHMARK(BM_MissHeavy<my::bucket_policy::fingerprinted<>>)->Arg(1 << 20)->Arg(1 << 25);
+
+// Rebalancing: every element of one chained map moves to another, then back, as partitions do when they are
+// rebalanced. Copy + erase allocates a node in the destination and frees one in the source per element;
+// extract/insert and merge relink the node with its stored hash (merge also skips the lookup in the source).
+
+enum class move_by { copy_erase, extract_insert, merge };
+
+template <move_by Mode>
+static void BM_Rebalance(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  chained_map a = make_map<chained_map>(keys);
+  chained_map b;
+  b.reserve(keys.size());
+  chained_map* from = &a;
+  chained_map* to = &b;
+  for (auto _ : state) {
+    if constexpr (Mode == move_by::copy_erase) {
+      for (auto k : keys) {
+        to->insert(k, from->find(k)->second);
+        from->erase(k);
+      }
+    } else if constexpr (Mode == move_by::extract_insert) {
+      for (auto k : keys) {
+        to->insert(from->extract(k));
+      }
+    } else {
+      to->merge(*from);
+    }
+    std::swap(from, to);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_Rebalance<move_by::copy_erase>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Rebalance<move_by::extract_insert>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Rebalance<move_by::merge>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
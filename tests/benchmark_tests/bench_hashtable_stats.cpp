@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mystd/unordered_map.hpp"
+
+// The cost of the MYSTD_HASHTABLE_STATS counters: hit, miss and insert on random 64 bit keys, the same chained
+// my::unordered_map without (the default) and with the counters. Without them the hooks compile to nothing, so
+// plain_map runs as fast as my::unordered_map did before they existed (compare with BM_FindHit<chained_map> of
+// bench_hashtable). counted_map reports its average probes per lookup.
+
+template <bool Stats>
+using map = my::unordered_map_base<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                   my::InsertPolicy::UniqueKeys, std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                   my::hashtable_with_buckets<my::bucket_policy::modulo,
+                                                              my::rehash_policy::stop_the_world, Stats>::template type>;
+using plain_map = map<false>;
+using counted_map = map<true>;
+
+std::vector<uint64_t> make_keys(size_t n, uint64_t seed = 42) {
+  std::mt19937_64 gen(seed);
+  std::vector<uint64_t> keys(n);
+  for (auto& k : keys) {
+    k = gen() >> 1;  // misses have the top bit set
+  }
+  return keys;
+}
+
+template <typename Map>
+void report(benchmark::State& state, const Map& m) {
+  if constexpr (requires { m.stats(); }) {
+    state.counters["probes_per_lookup"] = m.stats().probes_per_lookup();
+  }
+}
+
+template <typename Map>
+static void BM_FindHit(benchmark::State& state) {
+  auto keys = make_keys(state.range(0));
+  Map m;
+  for (auto k : keys) {
+    m.insert(k, k);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m.find(keys[i])->second);
+    if (++i == keys.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+  report(state, m);
+}
+BENCHMARK(BM_FindHit<plain_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_FindHit<counted_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+template <typename Map>
+static void BM_FindMiss(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  Map m;
+  for (auto k : keys) {
+    m.insert(k, k);
+  }
+  const uint64_t top = uint64_t{1} << 63;
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m.find(keys[i] | top));
+    if (++i == keys.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+  report(state, m);
+}
+BENCHMARK(BM_FindMiss<plain_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_FindMiss<counted_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+template <typename Map>
+static void BM_Insert(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0));
+  for (auto _ : state) {
+    Map m;
+    for (auto k : keys) {
+      m.insert(k, k);
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_Insert<plain_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Insert<counted_map>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <mutex>
+
+#include "mystd/deque_cyclicbuffer_based.hpp"
+#include "mystd/mpmc_queue.hpp"
+#include "mystd/queue_adapter.hpp"
+
+// Scaling with the number of threads: every thread does push+pop pairs on one shared queue, so the queue never
+// runs empty or full and the time goes to contention on the queue itself. The baseline is my::queue on the
+// cyclic buffer deque under a mutex.
+
+constexpr size_t CAPACITY = 1024;
+
+/// @brief my::queue under a mutex, with the push/pop interface of my::mpmc_queue.
+class mutex_queue {
+  std::mutex m_;
+  my::queue<uint64_t, my::cyclicbufferbased::deque<uint64_t>> q_;
+
+ public:
+  explicit mutex_queue(size_t) {}
+
+  void push(uint64_t value) {
+    std::lock_guard lock(m_);
+    q_.enqueue(value);
+  }
+
+  uint64_t pop() {
+    std::lock_guard lock(m_);
+    uint64_t value = q_.front();
+    q_.dequeue();
+    return value;
+  }
+};
+
+template <typename Queue>
+static void BM_PushPopPairs(benchmark::State& state) {
+  static Queue q(CAPACITY);
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    q.push(state.thread_index());
+    sum += q.pop();
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_PushPopPairs<mutex_queue>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_PushPopPairs<my::mpmc_queue<uint64_t>>)->ThreadRange(1, 8)->UseRealTime();
+
+// half of the threads produce, half consume through a small queue, so pushes and pops block;
+// spin yields the CPU while waiting, futex sleeps in the kernel
+template <typename Wait>
+static void BM_ProducersConsumers(benchmark::State& state) {
+  static my::mpmc_queue<uint64_t, Wait> q(64);
+  const bool producer = state.thread_index() % 2 == 0;
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    if (producer) {
+      q.push(1);
+    } else {
+      sum += q.pop();
+    }
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProducersConsumers<my::queue_wait::spin>)->ThreadRange(2, 8)->Iterations(200000)->UseRealTime();
+BENCHMARK(BM_ProducersConsumers<my::queue_wait::futex>)->ThreadRange(2, 8)->Iterations(200000)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+#include "mystd/simd.hpp"
+#include "mystd/vector.hpp"
+
+// my::simd dispatched kernels vs the scalar ones on large my::vector<uint32_t> buffers.
+
+namespace {
+
+my::vector<uint32_t> make_buffer(size_t n) {
+  std::mt19937 gen(7);
+  my::vector<uint32_t> v;
+  v.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    v.push_back(gen() % 1000);
+  }
+  return v;
+}
+
+}  // namespace
+
+static void BM_VectorEqual(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  auto b = a;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a == b);
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_VectorEqual)->Arg(1 << 10)->Arg(1 << 20);
+
+static void BM_ScalarEqual(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  auto b = a;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::scalar::mismatch(a.data(), b.data(), a.size()) == a.size());
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_ScalarEqual)->Arg(1 << 10)->Arg(1 << 20);
+
+static void BM_VectorLess(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  auto b = a;
+  b.back() += 1;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a < b);
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_VectorLess)->Arg(1 << 10)->Arg(1 << 20);
+
+static void BM_Find(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::find(a.begin(), a.end(), uint32_t{5000}));  // miss, full scan
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_Find)->Arg(1 << 10)->Arg(1 << 20);
+
+static void BM_ScalarFind(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::scalar::find(a.begin(), a.end(), uint32_t{5000}));
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_ScalarFind)->Arg(1 << 10)->Arg(1 << 20);
+
+static void BM_Count(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::count(a.begin(), a.end(), uint32_t{42}));
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_Count)->Arg(1 << 20);
+
+static void BM_ScalarCount(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::scalar::count(a.begin(), a.end(), uint32_t{42}));
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_ScalarCount)->Arg(1 << 20);
+
+static void BM_MinMax(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::min(a.begin(), a.end()));
+    benchmark::DoNotOptimize(my::simd::max(a.begin(), a.end()));
+  }
+  state.SetBytesProcessed(2 * state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_MinMax)->Arg(1 << 20);
+
+static void BM_ScalarMinMax(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::scalar::min(a.begin(), a.end()));
+    benchmark::DoNotOptimize(my::simd::scalar::max(a.begin(), a.end()));
+  }
+  state.SetBytesProcessed(2 * state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_ScalarMinMax)->Arg(1 << 20);
+
+static void BM_Sum(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::sum(a.begin(), a.end()));
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_Sum)->Arg(1 << 20);
+
+static void BM_ScalarSum(benchmark::State& state) {
+  auto a = make_buffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(my::simd::scalar::sum(a.begin(), a.end()));
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint32_t));
+}
+BENCHMARK(BM_ScalarSum)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "mystd/small_vector.hpp"
+#include "mystd/vector.hpp"
+
+// Many short vectors of 0..8 elements: the case where a heap allocation per vector dominates.
+
+constexpr size_t VECTORS = 100'000;
+constexpr size_t MAX_LEN = 8;
+
+template <typename Vector>
+static void BM_ManySmallBuild(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<Vector> all(VECTORS);
+    for (size_t i = 0; i < VECTORS; ++i) {
+      const size_t len = i % (MAX_LEN + 1);
+      for (size_t j = 0; j < len; ++j) {
+        all[i].push_back(static_cast<uint32_t>(i + j));
+      }
+    }
+    benchmark::DoNotOptimize(all.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VECTORS);
+}
+BENCHMARK(BM_ManySmallBuild<my::vector<uint32_t, MAX_LEN>>);
+BENCHMARK(BM_ManySmallBuild<my::small_vector<uint32_t, MAX_LEN>>);
+
+template <typename Vector>
+static void BM_ManySmallScan(benchmark::State& state) {
+  std::vector<Vector> all(VECTORS);
+  for (size_t i = 0; i < VECTORS; ++i) {
+    const size_t len = i % (MAX_LEN + 1);
+    for (size_t j = 0; j < len; ++j) {
+      all[i].push_back(static_cast<uint32_t>(i + j));
+    }
+  }
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (const auto& v : all) {
+      for (auto el : v) {
+        sum += el;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * VECTORS);
+}
+BENCHMARK(BM_ManySmallScan<my::vector<uint32_t, MAX_LEN>>);
+BENCHMARK(BM_ManySmallScan<my::small_vector<uint32_t, MAX_LEN>>);
+
+template <typename Vector>
+static void BM_ManySmallCopy(benchmark::State& state) {
+  std::vector<Vector> all(VECTORS);
+  for (size_t i = 0; i < VECTORS; ++i) {
+    const size_t len = i % (MAX_LEN + 1);
+    for (size_t j = 0; j < len; ++j) {
+      all[i].push_back(static_cast<uint32_t>(i + j));
+    }
+  }
+  for (auto _ : state) {
+    std::vector<Vector> copy(all);
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VECTORS);
+}
+BENCHMARK(BM_ManySmallCopy<my::vector<uint32_t, MAX_LEN>>);
+BENCHMARK(BM_ManySmallCopy<my::small_vector<uint32_t, MAX_LEN>>);
+
+// sizes cross the inline capacity: measures the spill cost
+template <typename Vector>
+static void BM_SpillPastInline(benchmark::State& state) {
+  const size_t len = state.range(0);
+  for (auto _ : state) {
+    Vector v;
+    for (size_t j = 0; j < len; ++j) {
+      v.push_back(static_cast<uint32_t>(j));
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+BENCHMARK(BM_SpillPastInline<my::vector<uint32_t, MAX_LEN>>)->Arg(4)->Arg(8)->Arg(16)->Arg(64);
+BENCHMARK(BM_SpillPastInline<my::small_vector<uint32_t, MAX_LEN>>)->Arg(4)->Arg(8)->Arg(16)->Arg(64);
+
+BENCHMARK_MAIN();
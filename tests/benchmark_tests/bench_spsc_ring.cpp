@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mystd/deque_cyclicbuffer_based.hpp"
+#include "mystd/queue_adapter.hpp"
+#include "mystd/spsc_ring.hpp"
+
+// One producer thread hands ITEMS timestamps to the consumer (the benchmark thread) through the queue.
+// Throughput is items/s, p99_ns is the 99th percentile of the time between the push and the pop of an item.
+// Both queues are bounded to the same capacity so they apply the same back pressure to the producer.
+
+constexpr size_t ITEMS = 1 << 16;
+constexpr size_t CAPACITY = 1024;
+
+uint64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// @brief The baseline: my::queue on the cyclic buffer deque under a mutex, with the try_* interface of the ring.
+class mutex_queue {
+  std::mutex m_;
+  my::queue<uint64_t, my::cyclicbufferbased::deque<uint64_t>> q_;
+
+ public:
+  size_t try_push_n(const uint64_t* first, size_t n) {
+    std::lock_guard lock(m_);
+    n = std::min(n, CAPACITY - q_.size());
+    for (size_t i = 0; i < n; ++i) {
+      q_.enqueue(first[i]);
+    }
+    return n;
+  }
+
+  size_t try_pop_n(uint64_t* out, size_t n) {
+    std::lock_guard lock(m_);
+    n = std::min(n, q_.size());
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = q_.front();
+      q_.dequeue();
+    }
+    return n;
+  }
+};
+
+using ring = my::spsc_ring<uint64_t, CAPACITY>;
+
+/// @tparam Batch -- elements per try_push_n/try_pop_n call, 1 is a plain push/pop
+template <typename Queue, size_t Batch>
+static void BM_Transfer(benchmark::State& state) {
+  std::vector<uint64_t> latencies(ITEMS);
+  double p99_sum = 0;
+
+  for (auto _ : state) {
+    Queue q;
+    std::thread producer([&q] {
+      uint64_t batch[Batch];
+      for (size_t sent = 0; sent < ITEMS;) {
+        const size_t n = std::min(Batch, ITEMS - sent);
+        const uint64_t stamp = now_ns();
+        std::fill_n(batch, n, stamp);
+        size_t pushed = 0;
+        while (pushed < n) {
+          const size_t k = q.try_push_n(batch + pushed, n - pushed);
+          if (k == 0) std::this_thread::yield();  // full
+          pushed += k;
+        }
+        sent += n;
+      }
+    });
+
+    uint64_t batch[Batch];
+    for (size_t received = 0; received < ITEMS;) {
+      const size_t n = q.try_pop_n(batch, Batch);
+      if (n == 0) {
+        std::this_thread::yield();  // empty
+        continue;
+      }
+      const uint64_t stamp = now_ns();
+      for (size_t i = 0; i < n; ++i) {
+        latencies[received++] = stamp - batch[i];
+      }
+    }
+    producer.join();
+
+    auto p99 = latencies.begin() + ITEMS * 99 / 100;
+    std::nth_element(latencies.begin(), p99, latencies.end());
+    p99_sum += static_cast<double>(*p99);
+  }
+
+  state.SetItemsProcessed(state.iterations() * ITEMS);
+  state.counters["p99_ns"] = p99_sum / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_Transfer<mutex_queue, 1>)->UseRealTime();
+BENCHMARK(BM_Transfer<ring, 1>)->UseRealTime();
+BENCHMARK(BM_Transfer<mutex_queue, 32>)->UseRealTime();
+BENCHMARK(BM_Transfer<ring, 32>)->UseRealTime();
+
+BENCHMARK_MAIN();
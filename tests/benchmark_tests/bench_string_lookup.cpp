@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mystd/map.hpp"
+#include "mystd/unordered_map.hpp"
+
+// Lookups of std::string_view keys (as parsed off a request buffer) in maps keyed by std::string.
+// "copy": the map is not transparent, every lookup builds a std::string from the view (keys are longer than the
+// small string buffer, so that is a malloc + free). "view": transparent hash/compare, the view is used as is.
+
+using hash_copy = my::unordered_map<std::string, int>;
+using hash_view = my::unordered_map<std::string, int, my::string_hash, std::equal_to<>>;
+using tree_copy = my::map<std::string, int>;
+using tree_view = my::map<std::string, int,
+                          my::rb_tree<std::pair<std::string, int>, my::KeyOfPair<std::string, int>, std::less<>>>;
+
+/// @return n distinct keys like "user:session:00000042:profile", all in one buffer
+std::string make_buffer(size_t n, std::vector<std::string_view>& views) {
+  std::string buffer;
+  std::vector<size_t> offsets;
+  for (size_t i = 0; i < n; ++i) {
+    offsets.push_back(buffer.size());
+    buffer += "user:session:" + std::to_string(10000000 + i) + ":profile";
+  }
+  offsets.push_back(buffer.size());
+  views.clear();
+  for (size_t i = 0; i < n; ++i) {
+    views.emplace_back(buffer.data() + offsets[i], offsets[i + 1] - offsets[i]);
+  }
+  std::shuffle(views.begin(), views.end(), std::mt19937_64(1));
+  return buffer;
+}
+
+template <typename Map, bool Transparent>
+static void BM_FindStringView(benchmark::State& state) {
+  std::vector<std::string_view> views;
+  const std::string buffer = make_buffer(state.range(0), views);
+  Map m;
+  for (size_t i = 0; i < views.size(); ++i) {
+    m[std::string(views[i])] = static_cast<int>(i);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    if constexpr (Transparent) {
+      benchmark::DoNotOptimize(m.find(views[i]));
+    } else {
+      benchmark::DoNotOptimize(m.find(std::string(views[i])));
+    }
+    if (++i == views.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindStringView<hash_copy, false>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_FindStringView<hash_view, true>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_FindStringView<tree_copy, false>)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_FindStringView<tree_view, true>)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
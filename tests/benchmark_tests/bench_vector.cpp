@@ -1,67 +1,155 @@
 #include <benchmark/benchmark.h>
 
-#include <array>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "mystd/vector.hpp"
 
-static void BM_ArrayFill(benchmark::State& state) {
-  my::vector<int> arr;
+constexpr int N = 100'000;
+
+template <typename Vector>
+static void BM_PushBack(benchmark::State& state) {
   for (auto _ : state) {
-    arr.fill(42);
-    benchmark::DoNotOptimize(arr.data());
+    Vector v;
+    for (int i = 0; i < N; ++i) {
+      v.push_back(i);
+    }
+    benchmark::DoNotOptimize(v.data());
   }
 }
-BENCHMARK(BM_ArrayFill);
+BENCHMARK(BM_PushBack<my::vector<int>>);
+BENCHMARK(BM_PushBack<std::vector<int>>);
 
-static void BM_STDArrayFill(benchmark::State& state) {
-  std::vector<int> arr;
+template <typename Vector>
+static void BM_EmplaceBackString(benchmark::State& state) {
   for (auto _ : state) {
-    arr.fill(42);
-    benchmark::DoNotOptimize(arr.data());
+    Vector v;
+    for (int i = 0; i < N; ++i) {
+      v.emplace_back(32, 'x');
+    }
+    benchmark::DoNotOptimize(v.data());
   }
 }
-BENCHMARK(BM_STDArrayFill);
+BENCHMARK(BM_EmplaceBackString<my::vector<std::string>>);
+BENCHMARK(BM_EmplaceBackString<std::vector<std::string>>);
 
-static void BM_ArrayAccess(benchmark::State& state) {
-  my::vector<int> arr;
-  arr.fill(1);
-  volatile int sum = 0;
+template <typename Vector>
+static void BM_PushBackUniquePtr(benchmark::State& state) {
   for (auto _ : state) {
-    for (size_t i = 0; i < arr.size(); ++i) {
-      sum += arr[i];
+    Vector v;
+    for (int i = 0; i < N; ++i) {
+      v.push_back(std::make_unique<int>(i));
     }
+    benchmark::DoNotOptimize(v.data());
   }
 }
-BENCHMARK(BM_ArrayAccess);
+BENCHMARK(BM_PushBackUniquePtr<my::vector<std::unique_ptr<int>>>);
+BENCHMARK(BM_PushBackUniquePtr<std::vector<std::unique_ptr<int>>>);
 
-static void BM_STDArrayAccess(benchmark::State& state) {
-  std::vector<int> arr;
-  arr.fill(1);
-  volatile int sum = 0;
+template <typename Vector>
+static void BM_ReserveThenPushBack(benchmark::State& state) {
   for (auto _ : state) {
-    for (size_t i = 0; i < arr.size(); ++i) {
-      sum += arr[i];
+    Vector v;
+    v.reserve(N);
+    for (int i = 0; i < N; ++i) {
+      v.push_back(i);
     }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+BENCHMARK(BM_ReserveThenPushBack<my::vector<int>>);
+BENCHMARK(BM_ReserveThenPushBack<std::vector<int>>);
+
+template <typename Vector>
+static void BM_Resize(benchmark::State& state) {
+  for (auto _ : state) {
+    Vector v;
+    v.resize(N);
+    v.resize(N / 2);
+    v.resize(2 * N, 42);
+    benchmark::DoNotOptimize(v.data());
   }
 }
-BENCHMARK(BM_STDArrayAccess);
+BENCHMARK(BM_Resize<my::vector<int>>);
+BENCHMARK(BM_Resize<std::vector<int>>);
 
-static void BM_ArraySwap(benchmark::State& state) {
-  my::vector<int> arr1, arr2;
+template <typename Vector>
+static void BM_ShrinkToFit(benchmark::State& state) {
   for (auto _ : state) {
-    arr1.swap(arr2);
-    benchmark::DoNotOptimize(arr1.data());
+    state.PauseTiming();
+    Vector v;
+    v.reserve(4 * N);
+    for (int i = 0; i < N; ++i) {
+      v.push_back(i);
+    }
+    state.ResumeTiming();
+    v.shrink_to_fit();
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+BENCHMARK(BM_ShrinkToFit<my::vector<int>>);
+BENCHMARK(BM_ShrinkToFit<std::vector<int>>);
+
+template <typename Vector>
+static void BM_InsertFront(benchmark::State& state) {
+  const int count = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    Vector v;
+    for (int i = 0; i < count; ++i) {
+      v.insert(v.begin(), i);
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+BENCHMARK(BM_InsertFront<my::vector<int>>)->Arg(1'000)->Arg(10'000);
+BENCHMARK(BM_InsertFront<std::vector<int>>)->Arg(1'000)->Arg(10'000);
+
+template <typename Vector>
+static void BM_EraseFront(benchmark::State& state) {
+  const int count = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Vector v;
+    for (int i = 0; i < count; ++i) {
+      v.push_back(i);
+    }
+    state.ResumeTiming();
+    while (!v.empty()) {
+      v.erase(v.begin());
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+BENCHMARK(BM_EraseFront<my::vector<int>>)->Arg(1'000)->Arg(10'000);
+BENCHMARK(BM_EraseFront<std::vector<int>>)->Arg(1'000)->Arg(10'000);
+
+template <typename Vector>
+static void BM_Access(benchmark::State& state) {
+  Vector v;
+  for (int i = 0; i < N; ++i) {
+    v.push_back(1);
+  }
+  for (auto _ : state) {
+    long long sum = 0;
+    for (size_t i = 0; i < v.size(); ++i) {
+      sum += v[i];
+    }
+    benchmark::DoNotOptimize(sum);
   }
 }
-BENCHMARK(BM_ArraySwap);
+BENCHMARK(BM_Access<my::vector<int>>);
+BENCHMARK(BM_Access<std::vector<int>>);
 
-static void BM_STDArraySwap(benchmark::State& state) {
-  std::array<int> arr1, arr2;
+template <typename Vector>
+static void BM_Swap(benchmark::State& state) {
+  Vector v1, v2;
   for (auto _ : state) {
-    arr1.swap(arr2);
-    benchmark::DoNotOptimize(arr1.data());
+    v1.swap(v2);
+    benchmark::DoNotOptimize(v1.data());
   }
 }
-BENCHMARK(BM_STDArraySwap);
+BENCHMARK(BM_Swap<my::vector<int>>);
+BENCHMARK(BM_Swap<std::vector<int>>);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "mystd/vector.hpp"
+
+// Compares growth policies: time, element copies done by reallocations and peak RSS.
+
+namespace {
+
+/// @brief Not trivially copyable, counts every relocation of an element.
+struct Counted {
+  static inline uint64_t relocations = 0;
+  uint64_t value;
+
+  Counted(uint64_t v) : value(v) {}
+  Counted(const Counted& other) : value(other.value) { ++relocations; }
+  Counted(Counted&& other) noexcept : value(other.value) { ++relocations; }
+};
+
+/// @return VmHWM (peak resident set size) in KiB, 0 if not available
+uint64_t peak_rss_kib() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::stoull(line.substr(6));
+    }
+  }
+  return 0;
+}
+
+/// @brief Resets VmHWM to the current RSS (Linux only, silently ignored elsewhere).
+void reset_peak_rss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+}
+
+}  // namespace
+
+template <typename Growth>
+static void BM_GrowthCopyVolume(benchmark::State& state) {
+  const size_t n = state.range(0);
+  uint64_t relocations = 0;
+  for (auto _ : state) {
+    Counted::relocations = 0;
+    my::vector<Counted, 16, Growth> v;
+    for (size_t i = 0; i < n; ++i) {
+      v.emplace_back(i);
+    }
+    relocations = Counted::relocations;
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.counters["copied_per_element"] = static_cast<double>(relocations) / n;
+}
+BENCHMARK(BM_GrowthCopyVolume<my::growth::doubling>)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GrowthCopyVolume<my::growth::one_and_half>)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GrowthCopyVolume<my::growth::page_granular>)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+template <typename Growth>
+static void BM_GrowthPeakRss(benchmark::State& state) {
+  const size_t n = state.range(0);
+  uint64_t before = 0;
+  uint64_t peak = 0;
+  uint64_t reallocations = 0;
+  for (auto _ : state) {
+    reset_peak_rss();
+    before = peak_rss_kib();
+    my::vector<uint32_t, 16, Growth> v;
+    reallocations = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const size_t capacity = v.capacity();
+      v.push_back(static_cast<uint32_t>(i));
+      reallocations += capacity != v.capacity();
+    }
+    benchmark::DoNotOptimize(v.data());
+    peak = peak_rss_kib();
+  }
+  state.counters["peak_rss_MiB"] = static_cast<double>(peak - before) / 1024;
+  state.counters["payload_MiB"] = static_cast<double>(n * sizeof(uint32_t)) / (1 << 20);
+  state.counters["reallocations"] = static_cast<double>(reallocations);
+}
+BENCHMARK(BM_GrowthPeakRss<my::growth::doubling>)->Arg(50'000'000)->Unit(benchmark::kMillisecond)->Iterations(3);
+BENCHMARK(BM_GrowthPeakRss<my::growth::one_and_half>)->Arg(50'000'000)->Unit(benchmark::kMillisecond)->Iterations(3);
+BENCHMARK(BM_GrowthPeakRss<my::growth::page_granular>)->Arg(50'000'000)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+BENCHMARK_MAIN();
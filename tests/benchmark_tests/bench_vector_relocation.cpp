@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mystd/type_traits.hpp"
+#include "mystd/vector.hpp"
+
+// Growth, insert shifting and erase compaction with and without the trivially relocatable fast path.
+
+namespace {
+
+/// owning handle with a non trivial move, relocated element by element
+struct Handle {
+  int* p = nullptr;
+
+  explicit Handle(int* ptr) : p(ptr) {}
+  Handle(Handle&& other) noexcept : p(std::exchange(other.p, nullptr)) {}
+  Handle& operator=(Handle&& other) noexcept {
+    std::swap(p, other.p);
+    return *this;
+  }
+  ~Handle() { delete p; }
+};
+
+/// the same handle, but opted in as trivially relocatable
+struct RelocatableHandle : Handle {
+  using Handle::Handle;
+};
+
+}  // namespace
+
+template <>
+struct my::is_trivially_relocatable<RelocatableHandle> : std::true_type {};
+
+constexpr size_t GROWTH_N = 10'000'000;
+
+template <typename Vector>
+static void BM_Growth(benchmark::State& state) {
+  for (auto _ : state) {
+    Vector v;
+    for (size_t i = 0; i < GROWTH_N; ++i) {
+      v.emplace_back(nullptr);
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * GROWTH_N);
+}
+BENCHMARK(BM_Growth<my::vector<Handle>>)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Growth<my::vector<RelocatableHandle>>)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Growth<my::vector<std::unique_ptr<int>>>)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Growth<std::vector<std::unique_ptr<int>>>)->Unit(benchmark::kMillisecond);
+
+template <typename Vector>
+static void BM_InsertFront(benchmark::State& state) {
+  const size_t n = state.range(0);
+  for (auto _ : state) {
+    Vector v;
+    for (size_t i = 0; i < n; ++i) {
+      v.emplace(v.begin(), nullptr);
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+BENCHMARK(BM_InsertFront<my::vector<Handle>>)->Arg(20'000);
+BENCHMARK(BM_InsertFront<my::vector<RelocatableHandle>>)->Arg(20'000);
+
+template <typename Vector>
+static void BM_EraseFront(benchmark::State& state) {
+  const size_t n = state.range(0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    Vector v;
+    for (size_t i = 0; i < n; ++i) {
+      v.emplace_back(nullptr);
+    }
+    state.ResumeTiming();
+    while (!v.empty()) {
+      v.erase(v.begin());
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+BENCHMARK(BM_EraseFront<my::vector<Handle>>)->Arg(20'000);
+BENCHMARK(BM_EraseFront<my::vector<RelocatableHandle>>)->Arg(20'000);
+
+BENCHMARK_MAIN();
@@ -427,4 +427,29 @@ TEST(RBTreeTest, FindIterators) {
   EXPECT_TRUE(it == t.end());
 }
 
+TEST(RBTreeTest, EqualRangeWithDuplicates) {
+  rb_tree_map<int, int> t;
+  std::mt19937 gen(3);
+  for (int i = 0; i < 300; ++i) {
+    const int k = static_cast<int>(gen() % 30) * 2;  // even keys, ~10 copies each
+    t.insert({k, i});
+  }
+  EXPECT_TRUE(t.is_rb_tree());
+
+  for (int k = -1; k <= 60; ++k) {
+    auto [first, last] = t.equal_range(k);
+    size_t n = 0;
+    for (auto it = first; it != last; ++it, ++n) {
+      EXPECT_EQ(it->first, k);
+    }
+    EXPECT_EQ(n, t.count(k));
+    if (first != t.end()) {
+      EXPECT_GE(first->first, k);
+    }
+    if (last != t.end()) {
+      EXPECT_GT(last->first, k);
+    }
+  }
+}
+
 }  // namespace my::testing
@@ -0,0 +1,393 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mystd/allocator.hpp"
+#include "mystd/deque_blocks_based.hpp"
+#include "mystd/deque_cyclicbuffer_based.hpp"
+#include "mystd/forward_list_linked_nodes.hpp"
+#include "mystd/list_linked_nodes.hpp"
+#include "mystd/small_vector.hpp"
+#include "mystd/vector.hpp"
+
+namespace my::testing {
+
+TEST(MonotonicArenaTest, AlignsAndGrows) {
+  monotonic_arena arena(64);
+  auto* c = static_cast<char*>(arena.allocate(1, 1));
+  auto* d = static_cast<double*>(arena.allocate(sizeof(double), alignof(double)));
+  EXPECT_NE(c, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0);
+
+  // bigger than a block: a dedicated block is taken
+  auto* big = static_cast<char*>(arena.allocate(1000, 16));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % 16, 0);
+  big[999] = 'x';
+  EXPECT_EQ(arena.bytes_allocated(), 1 + sizeof(double) + 1000);
+
+  arena.release();
+  EXPECT_EQ(arena.bytes_allocated(), 0);
+}
+
+TEST(MonotonicArenaTest, ServesFromBufferFirst) {
+  alignas(std::max_align_t) std::byte buffer[256];
+  monotonic_arena arena(buffer, sizeof(buffer));
+  auto* p = static_cast<std::byte*>(arena.allocate(100));
+  EXPECT_GE(p, buffer);
+  EXPECT_LT(p, buffer + sizeof(buffer));
+
+  auto* q = static_cast<std::byte*>(arena.allocate(200));  // does not fit the rest of the buffer
+  EXPECT_TRUE(q < buffer || q >= buffer + sizeof(buffer));
+
+  arena.release();
+  EXPECT_EQ(arena.allocate(1, 1), static_cast<void*>(buffer));
+}
+
+TEST(PoolAllocatorTest, ReusesChunks) {
+  pool_allocator<uint64_t, 4> alloc;
+  uint64_t* a = alloc.allocate(1);
+  uint64_t* b = alloc.allocate(1);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(alloc.chunks_in_use(), 2);
+
+  alloc.deallocate(a, 1);
+  EXPECT_EQ(alloc.allocate(1), a);  // last freed chunk is handed out first
+
+  // more than one block
+  uint64_t* more[8];
+  for (auto& p : more) {
+    p = alloc.allocate(1);
+  }
+  EXPECT_EQ(alloc.chunks_in_use(), 10);
+
+  // arrays bypass the pool
+  uint64_t* arr = alloc.allocate(16);
+  EXPECT_EQ(alloc.chunks_in_use(), 10);
+  alloc.deallocate(arr, 16);
+
+  pool_allocator<uint64_t, 4> copy = alloc;
+  EXPECT_TRUE(copy == alloc);
+  EXPECT_FALSE((pool_allocator<uint64_t, 4>() == alloc));
+}
+
+TEST(ArenaAllocatorTest, Vector) {
+  monotonic_arena arena;
+  vector<std::string, 2, growth::doubling, arena_allocator<std::string>> v{arena};
+  for (int i = 0; i < 100; ++i) {
+    v.push_back(std::to_string(i));
+  }
+  EXPECT_EQ(v.size(), 100);
+  EXPECT_EQ(v[42], "42");
+  EXPECT_GT(arena.bytes_allocated(), 100 * sizeof(std::string));
+
+  auto copy = v;
+  EXPECT_EQ(copy.get_allocator().arena(), &arena);
+  EXPECT_TRUE(copy == v);
+
+  auto moved = std::move(v);
+  EXPECT_EQ(moved.size(), 100);
+  v.push_back("after move");
+  EXPECT_EQ(v.back(), "after move");
+}
+
+TEST(ArenaAllocatorTest, NodeContainers) {
+  monotonic_arena arena;
+
+  heapbased::list<int, arena_allocator<int>> l{arena};
+  heapbased::forward_list<int, arena_allocator<int>> fl{arena};
+  for (int i = 0; i < 10; ++i) {
+    l.push_back(i);
+    fl.push_front(i);
+  }
+  EXPECT_EQ(l.front(), 0);
+  EXPECT_EQ(l.back(), 9);
+  EXPECT_EQ(fl.front(), 9);
+  const size_t used = arena.bytes_allocated();
+  EXPECT_GT(used, 0);
+
+  l.pop_front();
+  fl.pop_front();
+  EXPECT_EQ(arena.bytes_allocated(), used);  // deallocate is a no-op
+}
+
+TEST(ArenaAllocatorTest, Deques) {
+  monotonic_arena arena;
+
+  blocksbased::deque<std::string, 4, arena_allocator<std::string>> bd{arena};
+  cyclicbufferbased::deque<std::string, 4, arena_allocator<std::string>> cd{arena};
+  for (int i = 0; i < 20; ++i) {
+    bd.push_back(std::to_string(i));
+    bd.push_front(std::to_string(-i));
+    cd.push_back(std::to_string(i));
+    cd.push_front(std::to_string(-i));
+  }
+  EXPECT_EQ(bd.size(), 40);
+  EXPECT_EQ(bd.front(), "-19");
+  EXPECT_EQ(bd.back(), "19");
+  EXPECT_EQ(cd.size(), 40);
+  EXPECT_EQ(cd.front(), "-19");
+  EXPECT_EQ(cd.back(), "19");
+
+  auto bd_copy = bd;
+  auto cd_copy = cd;
+  EXPECT_EQ(bd_copy.at(20), "0");
+  EXPECT_EQ(cd_copy.at(20), "0");
+}
+
+TEST(PoolAllocatorTest, NodeContainers) {
+  heapbased::list<std::string, pool_allocator<std::string>> l;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      l.push_back(std::to_string(i));
+    }
+    while (!l.empty()) {
+      l.pop_front();
+    }
+  }
+  l.push_back("last");
+  EXPECT_EQ(l.size(), 1);
+
+  heapbased::forward_list<int, pool_allocator<int>> fl{1, 2, 3};
+  auto copy = fl;
+  EXPECT_EQ(copy.front(), 1);
+}
+
+TEST(PoolAllocatorTest, RebindsShareThePools) {
+  pool_allocator<int> a;
+  pool_allocator<double> b(a);
+  EXPECT_TRUE(b == a);
+  EXPECT_TRUE(pool_allocator<int>(b) == a);
+
+  // chunks of one size and alignment come from one pool, whatever the type
+  int* p = a.allocate(1);
+  pool_allocator<float> f(b);
+  EXPECT_EQ(f.chunks_in_use(), 1);
+  a.deallocate(p, 1);
+  EXPECT_EQ(f.chunks_in_use(), 0);
+
+  // the containers allocate rebound node allocators and hand back one equal to the original
+  heapbased::list<int, pool_allocator<int>> l(a);
+  l.push_back(1);
+  EXPECT_TRUE(l.get_allocator() == l.get_allocator());
+  EXPECT_TRUE(l.get_allocator() == a);
+
+  heapbased::forward_list<int, pool_allocator<int>> fl(a);
+  fl.push_front(1);
+  EXPECT_TRUE(fl.get_allocator() == fl.get_allocator());
+  EXPECT_TRUE(fl.get_allocator() == a);
+}
+
+TEST(PoolAllocatorTest, MovedFromStaysUsable) {
+  pool_allocator<int> a;
+  pool_allocator<int> b = std::move(a);
+  EXPECT_TRUE(a == b);
+  pool_allocator<int> c;
+  c = std::move(b);
+  EXPECT_TRUE(b == c);
+  EXPECT_TRUE(a == c);
+
+  // the moved-from list still allocates from pools the moved-to one released
+  heapbased::list<int, pool_allocator<int>> l;
+  l.push_back(1);
+  {
+    auto moved = std::move(l);
+    EXPECT_EQ(moved.size(), 1);
+  }
+  l.push_back(2);
+  l.push_back(3);
+  EXPECT_EQ(l.back(), 3);
+
+  std::list<int, pool_allocator<int>> sl;
+  sl.push_back(1);
+  { auto moved = std::move(sl); }
+  sl.push_back(2);
+  EXPECT_EQ(sl.back(), 2);
+}
+
+struct Alive {
+  static inline int alive = 0;
+  Alive() { ++alive; }
+  Alive(const Alive&) { ++alive; }
+  ~Alive() { --alive; }
+};
+
+TEST(PoolAllocatorTest, BlocksDequeDestroysLiveRange) {
+  {
+    blocksbased::deque<Alive, 4, pool_allocator<Alive>> d;
+    Alive t;
+    for (int i = 0; i < 10; ++i) {
+      d.push_back(t);
+      d.push_front(t);
+    }
+    EXPECT_EQ(Alive::alive, 21);
+    d.pop_back();
+    d.pop_front();
+    EXPECT_EQ(Alive::alive, 19);
+  }
+  EXPECT_EQ(Alive::alive, 0);
+}
+
+/// std::allocator that counts the elements constructed and destroyed through it: a container that bypasses its
+/// allocator for some elements leaves the count off
+template <class T>
+struct counting_allocator {
+  using value_type = T;
+  static inline int live = 0;
+
+  counting_allocator() = default;
+  template <class U>
+  counting_allocator(const counting_allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) { return std::allocator<T>().allocate(n); }
+  void deallocate(T* p, std::size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+
+  template <class U, class... Args>
+  void construct(U* p, Args&&... args) {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    ++counting_allocator<U>::live;
+  }
+
+  template <class U>
+  void destroy(U* p) noexcept {
+    p->~U();
+    --counting_allocator<U>::live;
+  }
+
+  friend bool operator==(const counting_allocator&, const counting_allocator&) noexcept { return true; }
+};
+
+/// throws from its constructor once budget constructions are used up
+struct Budgeted {
+  static inline int budget = 0;
+  int value;
+
+  Budgeted(int v = 0) : value(v) {
+    if (--budget < 0) throw std::runtime_error("out of budget");
+  }
+  Budgeted(const Budgeted& other) : Budgeted(other.value) {}
+};
+
+TEST(CountingAllocatorTest, VectorResizeConstructsThroughAllocator) {
+  using counted = counting_allocator<std::string>;
+  {
+    vector<std::string, 2, growth::doubling, counted> v;
+    v.reserve(32);
+    v.resize(10);
+    EXPECT_EQ(counted::live, 10);
+    v.resize(20, "twenty");
+    EXPECT_EQ(counted::live, 20);
+    v.resize(3);
+    EXPECT_EQ(counted::live, 3);
+  }
+  EXPECT_EQ(counted::live, 0);
+
+  // a throwing constructor: the elements built so far are destroyed again, the size is unchanged
+  vector<Budgeted, 2, growth::doubling, counting_allocator<Budgeted>> b;
+  b.reserve(16);
+  Budgeted::budget = 6;
+  b.resize(2);
+  EXPECT_THROW(b.resize(10), std::runtime_error);
+  EXPECT_EQ(b.size(), 2);
+  EXPECT_EQ(counting_allocator<Budgeted>::live, 2);
+  Budgeted::budget = 1;
+  const Budgeted seven(7);
+  EXPECT_THROW(b.resize(5, seven), std::runtime_error);
+  EXPECT_EQ(counting_allocator<Budgeted>::live, 2);
+}
+
+TEST(CountingAllocatorTest, VectorCopiesAndGrowthConstructThroughAllocator) {
+  using counted = counting_allocator<std::string>;
+  {
+    vector<std::string, 2, growth::doubling, counted> v{"a", "b", "c"};
+    EXPECT_EQ(counted::live, 3);
+    for (int i = 0; i < 20; ++i) {
+      v.push_back(std::to_string(i));  // the old elements are moved over on every growth
+    }
+    EXPECT_EQ(counted::live, 23);
+    v.insert(v.begin(), "front");
+    v.shrink_to_fit();
+    EXPECT_EQ(counted::live, 24);
+
+    auto copy = v;
+    EXPECT_EQ(counted::live, 48);
+    copy = v;
+    EXPECT_EQ(counted::live, 48);
+  }
+  EXPECT_EQ(counted::live, 0);
+
+  {
+    small_vector<std::string, 2, growth::doubling, counted> s{"a"};
+    EXPECT_EQ(counted::live, 1);
+    auto inline_copy = s;
+    auto inline_moved = std::move(inline_copy);  // inline elements are moved one by one
+    EXPECT_EQ(counted::live, 2);
+    for (int i = 0; i < 10; ++i) {
+      s.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(counted::live, 12);
+    s.resize(2);
+    s.shrink_to_fit();  // back inline
+    EXPECT_TRUE(s.is_small());
+    small_vector<std::string, 2, growth::doubling, counted> big{"x", "y", "z"};
+    auto big_copy = big;
+    EXPECT_EQ(counted::live, 9);
+  }
+  EXPECT_EQ(counted::live, 0);
+
+  // a throwing copy: the elements copied so far are destroyed through the allocator
+  using budgeted = counting_allocator<Budgeted>;
+  Budgeted::budget = 5;  // three elements and two copies when the first buffer is outgrown
+  vector<Budgeted, 2, growth::doubling, budgeted> b(budgeted{});
+  b.emplace_back(1);
+  b.emplace_back(2);
+  b.emplace_back(3);
+  Budgeted::budget = 1;
+  EXPECT_THROW(auto copy = b, std::runtime_error);
+  EXPECT_EQ(budgeted::live, 3);
+}
+
+TEST(CountingAllocatorTest, DequeRangesConstructThroughAllocator) {
+  using counted = counting_allocator<std::string>;
+  const std::vector<std::string> words{"one", "two", "three", "four", "five", "six"};
+  {
+    cyclicbufferbased::deque<std::string, 4, counted> cd;
+    blocksbased::deque<std::string, 4, counted> bd;
+    cd.push_back("middle");
+    bd.push_back("middle");
+    cd.append_range(words);
+    cd.prepend_range(words);  // wraps around: two pieces
+    bd.append_range(words);
+    bd.prepend_range(words);  // over two blocks
+    EXPECT_EQ(counted::live, 26);
+    EXPECT_EQ(cd.front(), "one");
+    EXPECT_EQ(bd.back(), "six");
+  }
+  EXPECT_EQ(counted::live, 0);
+
+  // a throwing constructor in a later piece: the earlier ones are destroyed through the allocator too
+  using budgeted = counting_allocator<Budgeted>;
+  Budgeted::budget = 8;
+  const std::vector<int> values{1, 2, 3, 4, 5, 6, 7, 8};
+  cyclicbufferbased::deque<Budgeted, 8, budgeted> cb;
+  cb.push_back(0);
+  cb.pop_front();  // the head moves: prepending 8 wraps around after 7
+  Budgeted::budget = 7;
+  EXPECT_THROW(cb.prepend_range(values), std::runtime_error);
+  EXPECT_TRUE(cb.empty());
+  EXPECT_EQ(budgeted::live, 0);
+
+  blocksbased::deque<Budgeted, 4, budgeted> bb;
+  Budgeted::budget = 5;
+  EXPECT_THROW(bb.prepend_range(values), std::runtime_error);
+  EXPECT_TRUE(bb.empty());
+  EXPECT_EQ(budgeted::live, 0);
+}
+
+}  // namespace my::testing
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <mystd/concurrent_unordered_map.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace my::testing {
+
+TEST(ConcurrentUnorderedMapTest, SingleThread) {
+  concurrent_unordered_map<std::string, int> m(5);
+  EXPECT_EQ(m.shard_count(), 8);
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.find("a"), std::nullopt);
+
+  EXPECT_TRUE(m.insert_or_assign("a", 1));
+  EXPECT_FALSE(m.insert_or_assign("a", 2));
+  EXPECT_EQ(m.find("a"), 2);
+  EXPECT_FALSE(m.try_emplace("a", 3));
+  EXPECT_TRUE(m.try_emplace("b", 3));
+  EXPECT_TRUE(m.contains("b"));
+  EXPECT_EQ(m.size(), 2);
+
+  EXPECT_TRUE(m.visit("a", [](auto& v) { v.second += 40; }));
+  EXPECT_FALSE(m.visit("c", [](auto&) { FAIL(); }));
+  int seen = 0;
+  EXPECT_TRUE(m.cvisit("a", [&seen](const auto& v) { seen = v.second; }));
+  EXPECT_EQ(seen, 42);
+
+  int sum = 0;
+  m.cvisit_all([&sum](const auto& v) { sum += v.second; });
+  EXPECT_EQ(sum, 45);
+  m.visit_all([](auto& v) { v.second = 0; });
+  EXPECT_EQ(m.find("b"), 0);
+
+  EXPECT_TRUE(m.erase("a"));
+  EXPECT_FALSE(m.erase("a"));
+  EXPECT_EQ(m.size(), 1);
+  m.clear();
+  EXPECT_TRUE(m.empty());
+}
+
+TEST(ConcurrentUnorderedMapTest, ManyThreads) {
+  constexpr int THREADS = 4;
+  constexpr int KEYS = 2000;
+  static constexpr int COUNTER = -KEYS;  // below every key read back
+  concurrent_unordered_map<int, int> m;
+  m.insert_or_assign(COUNTER, 0);
+
+  // every writer owns a range of keys and bumps the shared counter; readers only ever see whole values
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&m, t] {
+      for (int i = t * KEYS; i < (t + 1) * KEYS; ++i) {
+        m.insert_or_assign(i, i);
+        m.visit(COUNTER, [](auto& v) { ++v.second; });
+        if (auto v = m.find(i - KEYS / 2); v) {
+          EXPECT_EQ(*v, i - KEYS / 2);
+        }
+        if (i % 64 == 0) std::this_thread::yield();
+      }
+      for (int i = t * KEYS; i < (t + 1) * KEYS; i += 2) {
+        EXPECT_TRUE(m.erase(i));
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  EXPECT_EQ(m.find(COUNTER), THREADS * KEYS);
+  EXPECT_EQ(m.size(), THREADS * KEYS / 2 + 1);
+  for (int i = 0; i < THREADS * KEYS; ++i) {
+    EXPECT_EQ(m.contains(i), i % 2 == 1);
+  }
+}
+
+}  // namespace my::testing
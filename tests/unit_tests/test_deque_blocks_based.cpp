@@ -1,5 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <array>
+#include <deque>
+#include <numeric>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "mystd/allocator.hpp"
 #include "mystd/deque_blocks_based.hpp"
 
 namespace my::blocksbased::testing {
@@ -157,4 +166,239 @@ TEST(DequeBlocksTest, Iterators) {
   }
 }
 
+TEST(DequeBlocksTest, IndexingMatchesStdDeque) {
+  deque<int, 4> d;
+  std::deque<int> expected;
+  for (int i = 0; i < 1000; ++i) {
+    if (i % 3 == 0) {
+      d.push_front(i);
+      expected.push_front(i);
+    } else {
+      d.push_back(i);
+      expected.push_back(i);
+    }
+    if (i % 7 == 0) {
+      d.pop_back();
+      expected.pop_back();
+    }
+  }
+  ASSERT_EQ(d.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(d[i], expected[i]);
+  }
+  EXPECT_TRUE(std::equal(d.begin(), d.end(), expected.begin()));
+}
+
+TEST(DequeBlocksTest, FifoKeepsWorkingWhileDrifting) {
+  // the used part of the map drifts to the back and has to be recentered again and again
+  deque<int, 2> d;
+  for (int i = 0; i < 10; ++i) {
+    d.push_back(i);
+  }
+  for (int i = 10; i < 10000; ++i) {
+    d.push_back(i);
+    EXPECT_EQ(d.front(), i - 10);
+    d.pop_front();
+  }
+  EXPECT_EQ(d.size(), 10);
+  EXPECT_EQ(d[0], 9990);
+  EXPECT_EQ(d[9], 9999);
+
+  d.clear();
+  EXPECT_TRUE(d.empty());
+  d.push_front(1);
+  d.push_back(2);
+  EXPECT_EQ(d.front(), 1);
+  EXPECT_EQ(d.back(), 2);
+}
+
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+  static inline int allocations = 0;
+
+  CountingAllocator() = default;
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    ++allocations;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+  friend bool operator==(const CountingAllocator&, const CountingAllocator&) { return true; }
+};
+
+template <size_t MaxSpareBlocks>
+int allocations_on_boundary_ping_pong() {
+  deque<int, 4, CountingAllocator<int>, MaxSpareBlocks> d;
+  for (int i = 0; i < 6; ++i) {
+    d.push_back(i);  // the first element goes to the middle of a block: after 2 + 4 the last block is full
+  }
+  CountingAllocator<int>::allocations = 0;
+  for (int i = 0; i < 100; ++i) {
+    d.push_back(i);  // crosses into a new block
+    d.pop_back();    // which becomes empty again
+  }
+  return CountingAllocator<int>::allocations;
+}
+
+TEST(DequeBlocksTest, SpareBlocksAvoidAllocations) {
+  EXPECT_EQ(allocations_on_boundary_ping_pong<0>(), 100);
+  EXPECT_LE(allocations_on_boundary_ping_pong<2>(), 1);
+
+  deque<int, 2> d;
+  for (int i = 0; i < 20; ++i) {
+    d.push_back(i);
+  }
+  d.clear();
+  EXPECT_EQ(d.spare_blocks(), 2);
+  d.shrink_to_fit();
+  EXPECT_EQ(d.spare_blocks(), 0);
+}
+
+TEST(DequeBlocksTest, IteratorArithmeticAcrossBlocks) {
+  deque<int, 3> d;
+  for (int i = 0; i < 10; ++i) {
+    d.push_back(i);
+  }
+  for (int i = 1; i <= 5; ++i) {
+    d.push_front(-i);
+  }
+  // -5 -4 -3 -2 -1 0 1 ... 9
+
+  auto b = d.begin();
+  auto e = d.end();
+  EXPECT_EQ(e - b, 15);
+  EXPECT_EQ(*(b + 7), 2);
+  EXPECT_EQ(*(e - 1), 9);
+  EXPECT_EQ(b[4], -1);
+
+  auto it = b + 13;
+  it -= 11;
+  EXPECT_EQ(*it, -3);
+  it += 0;
+  EXPECT_EQ(*it, -3);
+  EXPECT_TRUE(b < it && it < e);
+
+  int expected = 9;
+  for (auto rit = d.rbegin(); rit != d.rend(); ++rit) {
+    EXPECT_EQ(*rit, expected--);
+  }
+
+  const auto& cd = d;
+  EXPECT_EQ(std::distance(cd.begin(), cd.end()), 15);
+  EXPECT_EQ(*cd.begin(), -5);
+
+  deque<int> empty;
+  EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(DequeBlocksTest, AppendPrependRange) {
+  deque<int, 4> d;
+  std::vector<int> back(10);
+  std::iota(back.begin(), back.end(), 0);
+  d.append_range(back);
+  d.prepend_range(std::list<int>{-3, -2, -1});
+  std::istringstream input("10 11");
+  d.append_range(std::ranges::istream_view<int>(input));
+  std::istringstream front_input("-5 -4");
+  d.prepend_range(std::ranges::istream_view<int>(front_input));
+
+  std::vector<int> expected(17);
+  std::iota(expected.begin(), expected.end(), -5);
+  ASSERT_EQ(d.size(), expected.size());
+  EXPECT_TRUE(std::equal(d.begin(), d.end(), expected.begin()));
+
+  // a large prepend needs several new blocks (and map growth) at once
+  std::vector<int> many(1000, 7);
+  d.prepend_range(many);
+  EXPECT_EQ(d.size(), 1017);
+  EXPECT_EQ(d[999], 7);
+  EXPECT_EQ(d[1000], -5);
+  EXPECT_EQ(d.back(), 11);
+}
+
+TEST(DequeBlocksTest, Segments) {
+  deque<int, 4> d;
+  EXPECT_EQ(d.segments().size(), 0);
+  EXPECT_EQ(d.segments().begin(), d.segments().end());
+
+  for (int i = 0; i < 9; ++i) {
+    d.push_back(i);  // starts in the middle of a block: 2 + 4 + 3
+  }
+  const auto& cd = d;
+  auto segments = cd.segments();
+  EXPECT_EQ(segments.size(), 3);
+  std::vector<size_t> sizes;
+  std::vector<int> all;
+  for (std::span<const int> segment : segments) {
+    sizes.push_back(segment.size());
+    all.insert(all.end(), segment.begin(), segment.end());
+  }
+  EXPECT_EQ(sizes, (std::vector<size_t>{2, 4, 3}));
+  EXPECT_EQ(all, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8}));
+
+  for (auto segment : d.segments()) {
+    for (auto& x : segment) x *= 2;
+  }
+  EXPECT_EQ(d[8], 16);
+}
+
+TEST(DequeBlocksTest, SegmentsMergeAdjacentBlocks) {
+  // consecutive blocks from an arena are adjacent in memory: one span
+  monotonic_arena arena;
+  deque<int, 4, arena_allocator<int>, 0> d{arena};
+  for (int i = 0; i < 9; ++i) {
+    d.push_back(i);
+  }
+  auto segments = d.segments();
+  ASSERT_EQ(segments.size(), 1);
+  std::span<int> all = *segments.begin();
+  EXPECT_EQ(all.size(), 9);
+  EXPECT_EQ(all[8], 8);
+
+  // the default block is 512 bytes: a 4096 byte batch fits in a handful of spans
+  static_assert(default_block_capacity<char> == 512);
+  static_assert(default_block_capacity<int> == 128);
+  static_assert(default_block_capacity<std::array<char, 1000>> == 8);
+  deque<char> bytes;
+  bytes.append_range(std::vector<char>(4096, 'x'));
+  EXPECT_LE(bytes.segments().size(), 9);
+}
+
+struct ThrowOnCopy {
+  static inline int countdown = 0;
+  int value = 0;
+
+  ThrowOnCopy(int v) : value(v) {}
+  ThrowOnCopy(const ThrowOnCopy& other) : value(other.value) {
+    if (--countdown == 0) throw std::runtime_error("copy");
+  }
+};
+
+TEST(DequeBlocksTest, PrependRangeThrowLeavesDequeUnchanged) {
+  deque<ThrowOnCopy, 2> d;
+  ThrowOnCopy::countdown = 1000;
+  d.push_back(ThrowOnCopy(1));
+  d.push_back(ThrowOnCopy(2));
+
+  std::vector<ThrowOnCopy> batch(7, ThrowOnCopy(0));
+  ThrowOnCopy::countdown = 5;
+  EXPECT_THROW(d.prepend_range(batch), std::runtime_error);
+  ASSERT_EQ(d.size(), 2);
+  EXPECT_EQ(d.front().value, 1);
+  EXPECT_EQ(d.back().value, 2);
+
+  ThrowOnCopy::countdown = 5;
+  EXPECT_THROW(d.append_range(batch), std::runtime_error);
+  // basic guarantee: blocks copied before the throw stay, the deque stays consistent
+  EXPECT_GE(d.size(), 2);
+  EXPECT_LE(d.size(), 6);
+  EXPECT_EQ(d[1].value, 2);
+  d.push_back(ThrowOnCopy(3));
+  EXPECT_EQ(d.back().value, 3);
+}
+
 }  // namespace my::blocksbased::testing
@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include "mystd/deque_cyclicbuffer_based.hpp"
 
 namespace my::cyclicbufferbased {
@@ -129,6 +136,31 @@ TEST(DequeTest, ReallocateKeepsOrderWithWrap) {
   EXPECT_TRUE(std::equal(d.begin(), d.end(), expected.begin()));
 }
 
+TEST(DequeTest, PushOwnElementWhileReallocating) {
+  deque<std::string, 4> d;
+  for (int i = 0; i < 4; ++i) d.push_back(std::string(32, static_cast<char>('a' + i)));  // not in the SSO buffer
+  d.push_back(d.front());  // full: reallocates and frees the buffer front() lives in
+  EXPECT_EQ(d.back(), std::string(32, 'a'));
+  for (int i = 0; i < 3; ++i) d.pop_front();
+  while (d.size() < d.capacity()) d.push_back("x");
+  d.push_front(d.back());
+  EXPECT_EQ(d.front(), "x");
+  EXPECT_EQ(d[1], std::string(32, 'd'));
+}
+
+TEST(DequeTest, ZeroInitialCapacityGrows) {
+  deque<int, 0> front;
+  front.push_front(1);
+  front.push_front(0);
+  deque<int, 0> back;
+  for (int i = 0; i < 5; ++i) back.push_back(i);
+  EXPECT_EQ(front.size(), 2);
+  EXPECT_EQ(front[0], 0);
+  EXPECT_EQ(front[1], 1);
+  EXPECT_EQ(back.size(), 5);
+  EXPECT_EQ(back.back(), 4);
+}
+
 TEST(DequeTest, IteratorValidityAfterCopy) {
   deque<int> d1;
   for (int i = 0; i < 5; ++i) d1.push_back(i);
@@ -146,4 +178,174 @@ TEST(DequeTest, EmptyOperationsThrow) {
   EXPECT_THROW(d.pop_back(), std::out_of_range);
 }
 
+template <typename Deque>
+std::vector<int> flatten_segments(const Deque& d) {
+  std::vector<int> out;
+  for (auto segment : d.segments()) {
+    out.insert(out.end(), segment.begin(), segment.end());
+  }
+  return out;
+}
+
+TEST(DequeTest, AppendPrependRange) {
+  deque<int, 4> d;
+  d.push_back(100);
+  d.append_range(std::vector<int>{1, 2, 3, 4, 5});
+  d.prepend_range(std::list<int>{-3, -2, -1});
+  std::istringstream input("7 8 9");
+  d.append_range(std::ranges::istream_view<int>(input));
+  std::istringstream front_input("-5 -4");
+  d.prepend_range(std::ranges::istream_view<int>(front_input));
+
+  const std::vector<int> expected{-5, -4, -3, -2, -1, 100, 1, 2, 3, 4, 5, 7, 8, 9};
+  ASSERT_EQ(d.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(d[i], expected[i]);
+  }
+  EXPECT_EQ(flatten_segments(d), expected);
+}
+
+TEST(DequeTest, SegmentsWrapAround) {
+  deque<int, 8> d;
+  EXPECT_TRUE(d.segments()[0].empty());
+
+  for (int i = 0; i < 6; ++i) {
+    d.push_back(i);
+  }
+  d.pop_front();
+  d.pop_front();
+  d.append_range(std::vector<int>{6, 7, 8});  // wraps around the end of the buffer
+  EXPECT_EQ(d.capacity(), 8);
+
+  auto segments = d.segments();
+  EXPECT_EQ(segments[0].size(), 6);
+  EXPECT_EQ(segments[1].size(), 1);
+  EXPECT_EQ(flatten_segments(d), (std::vector<int>{2, 3, 4, 5, 6, 7, 8}));
+
+  d.prepend_range(std::vector<int>{1});  // fills the last free slot before head
+  EXPECT_EQ(d.capacity(), 8);
+  EXPECT_EQ(flatten_segments(d), (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8}));
+
+  d.prepend_range(std::vector<int>{-1, 0});  // grows
+  EXPECT_EQ(d.capacity(), 16);
+  EXPECT_EQ(flatten_segments(d), (std::vector<int>{-1, 0, 1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+TEST(DequeTest, PowerOfTwoCapacityIsKept) {
+  deque<int, 8> d(10, 1);  // rounded up so that positions can be masked
+  EXPECT_EQ(d.capacity(), 16);
+  d.append_range(std::vector<int>(10, 2));
+  EXPECT_EQ(d.capacity(), 32);
+  EXPECT_EQ(d.size(), 20);
+  EXPECT_EQ(d[9], 1);
+  EXPECT_EQ(d[10], 2);
+}
+
+TEST(DequeTest, OtherCapacityWrapsWithModulo) {
+  deque<int, 6> d;
+  for (int i = 0; i < 6; ++i) {
+    d.push_back(i);
+  }
+  d.pop_front();
+  d.push_back(6);  // wraps around
+  EXPECT_EQ(d.capacity(), 6);
+  d.push_front(0);  // grows to 12
+  EXPECT_EQ(d.capacity(), 12);
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(d[i], i);
+  }
+}
+
+TEST(DequeTest, GrowingDequeIsNeverFull) {
+  deque<int, 4> d;
+  for (int i = 0; i < 4; ++i) {
+    d.push_back(i);
+  }
+  EXPECT_FALSE(d.full());  // the next push reallocates instead
+
+  deque<int, 4> moved(std::move(d));
+  EXPECT_EQ(d.capacity(), 0);
+  EXPECT_FALSE(d.full());
+  moved.clear();
+  EXPECT_FALSE(moved.full());
+
+  // pushes of a growing deque look like those of blocksbased::deque
+  static_assert(std::is_void_v<decltype(d.push_back(1))>);
+  static_assert(std::is_void_v<decltype(d.push_front(1))>);
+  static_assert(std::is_void_v<decltype(d.append_range(std::vector<int>{}))>);
+  static_assert(std::is_void_v<decltype(d.prepend_range(std::vector<int>{}))>);
+  deque<int, 4, std::allocator<int>, on_full::reject> ring;
+  static_assert(std::is_same_v<decltype(ring.push_back(1)), bool>);
+}
+
+TEST(DequeTest, OverwriteRingKeepsLastElements) {
+  deque<int, 4, std::allocator<int>, on_full::overwrite> window;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(window.push_back(i));
+  }
+  EXPECT_TRUE(window.full());
+  EXPECT_EQ(window.capacity(), 4);
+  EXPECT_EQ(flatten_segments(window), (std::vector<int>{6, 7, 8, 9}));
+
+  window.push_front(5);  // drops the back
+  EXPECT_EQ(flatten_segments(window), (std::vector<int>{5, 6, 7, 8}));
+
+  window.append_range(std::vector<int>{20, 21, 22, 23, 24, 25});
+  EXPECT_EQ(flatten_segments(window), (std::vector<int>{22, 23, 24, 25}));
+
+  window.pop_front();
+  window.prepend_range(std::vector<int>{10, 11});
+  EXPECT_EQ(flatten_segments(window), (std::vector<int>{10, 11, 23, 24}));
+
+  window.clear();  // keeps the buffer
+  EXPECT_EQ(window.capacity(), 4);
+  window.push_back(1);
+  EXPECT_EQ(window.front(), 1);
+}
+
+TEST(DequeTest, OverwriteRingWithOtherCapacity) {
+  deque<int, 3, std::allocator<int>, on_full::overwrite> window;
+  for (int i = 0; i < 8; ++i) {
+    window.push_back(i);
+  }
+  EXPECT_EQ(window.capacity(), 3);
+  EXPECT_EQ(flatten_segments(window), (std::vector<int>{5, 6, 7}));
+}
+
+TEST(DequeTest, RejectRingRefusesWhenFull) {
+  deque<int, 4, std::allocator<int>, on_full::reject> ring;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(ring.push_back(i));
+  }
+  EXPECT_FALSE(ring.push_back(4));
+  EXPECT_FALSE(ring.push_front(-1));
+  EXPECT_FALSE(ring.append_range(std::vector<int>{4}));
+  EXPECT_EQ(flatten_segments(ring), (std::vector<int>{0, 1, 2, 3}));
+
+  ring.pop_front();
+  ring.pop_front();
+  EXPECT_FALSE(ring.prepend_range(std::vector<int>{-2, -1, 0}));  // all or nothing
+  EXPECT_TRUE(ring.prepend_range(std::vector<int>{0, 1}));
+  EXPECT_EQ(flatten_segments(ring), (std::vector<int>{0, 1, 2, 3}));
+
+  EXPECT_THROW((deque<int, 4, std::allocator<int>, on_full::reject>(5)), std::length_error);
+}
+
+TEST(DequeTest, MovedFromRingIsUsable) {
+  deque<std::string, 2, std::allocator<std::string>, on_full::overwrite> a;
+  a.push_back("a");
+  a.push_back("b");
+  a.push_back("c");
+  auto b = std::move(a);
+  EXPECT_EQ(b.front(), "b");
+  EXPECT_TRUE(a.empty());
+
+  a.push_back("x");  // allocates a new buffer
+  a.push_back("y");
+  a.push_back("z");
+  EXPECT_EQ(a.capacity(), 2);
+  EXPECT_EQ(a.front(), "y");
+  EXPECT_EQ(a.back(), "z");
+}
+
 }  // namespace my::cyclicbufferbased
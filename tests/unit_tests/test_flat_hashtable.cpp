@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+
+#include <mystd/flat_hashtable.hpp>
+#include <mystd/unordered_map.hpp>
+#include <mystd/unordered_multimap.hpp>
+#include <mystd/unordered_multiset.hpp>
+#include <mystd/unordered_set.hpp>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace my::testing {
+
+namespace {
+
+template <class Key>
+struct Identity {
+  const Key& operator()(const Key& k) const noexcept { return k; }
+};
+
+template <class Key, class Value>
+struct KeyOfValue {
+  const Key& operator()(const std::pair<const Key, Value>& v) const noexcept { return v.first; }
+};
+
+struct ZeroHash {
+  size_t operator()(int) const { return 0; }
+};
+
+}  // namespace
+
+TEST(FlatHashTableTest, InsertFindErase) {
+  flat_hashtable<int, int, Identity<int>> hset;
+  EXPECT_TRUE(hset.empty());
+  EXPECT_EQ(hset.find(42), hset.end());
+  EXPECT_EQ(hset.begin(), hset.end());
+
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(hset.insert(i).second);
+  }
+  EXPECT_FALSE(hset.insert(7).second);
+  EXPECT_EQ(hset.size(), 1000);
+  EXPECT_LE(hset.load_factor(), hset.max_load_factor);
+
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_NE(hset.find(i), hset.end());
+    EXPECT_EQ(*hset.find(i), i);
+  }
+  EXPECT_EQ(hset.find(1000), hset.end());
+
+  for (int i = 0; i < 1000; i += 2) {
+    hset.erase(i);
+  }
+  EXPECT_EQ(hset.size(), 500);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(hset.count(i), i % 2);
+  }
+  EXPECT_EQ(hset.erase(0), hset.end());
+}
+
+TEST(FlatHashTableTest, MatchesStdUnorderedMap) {
+  using Pair = std::pair<const int, int>;
+  flat_hashtable<Pair, int, KeyOfValue<int, int>> table;
+  std::unordered_map<int, int> expected;
+
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> key(0, 2000);
+  for (int step = 0; step < 20000; ++step) {
+    const int k = key(gen);
+    if (gen() % 3 == 0) {
+      table.erase(k);
+      expected.erase(k);
+    } else {
+      EXPECT_EQ(table.insert({k, step}).second, expected.insert({k, step}).second);
+    }
+  }
+
+  EXPECT_EQ(table.size(), expected.size());
+  size_t visited = 0;
+  for (const auto& [k, v] : table) {
+    ASSERT_TRUE(expected.contains(k));
+    EXPECT_EQ(expected[k], v);
+    ++visited;
+  }
+  EXPECT_EQ(visited, expected.size());
+}
+
+TEST(FlatHashTableTest, ChurnReusesTombstones) {
+  flat_hashtable<int, int, Identity<int>> hset;
+  for (int i = 0; i < 100; ++i) {
+    hset.insert(i);
+  }
+  const size_t buckets = hset.bucket_count();
+
+  // a sliding window of 100 keys: tombstones are reused or cleaned up in place, the table grows at most once
+  for (int i = 100; i < 100000; ++i) {
+    hset.erase(i - 100);
+    hset.insert(i);
+  }
+  EXPECT_EQ(hset.size(), 100);
+  EXPECT_LE(hset.bucket_count(), 2 * buckets + 1);
+  for (int i = 99900; i < 100000; ++i) {
+    EXPECT_EQ(hset.count(i), 1);
+  }
+}
+
+TEST(FlatHashTableTest, EraseWhileIterating) {
+  flat_hashtable<int, int, Identity<int>> hset;
+  for (int i = 0; i < 200; ++i) {
+    hset.insert(i);
+  }
+  // erase returns the next element, nothing is moved so nothing is skipped or seen twice
+  size_t visited = 0;
+  for (auto it = hset.begin(); it != hset.end(); ++visited) {
+    it = (*it % 3 == 0) ? hset.erase(*it) : std::next(it);
+  }
+  EXPECT_EQ(visited, 200);
+  EXPECT_EQ(hset.size(), 133);
+}
+
+TEST(FlatHashTableTest, AllKeysCollide) {
+  flat_hashtable<int, int, Identity<int>, ZeroHash> hset;
+  for (int i = 0; i < 100; ++i) {
+    hset.insert(i);
+  }
+  hset.erase(50);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(hset.count(i), i != 50);
+  }
+}
+
+TEST(FlatHashTableTest, CopyMoveRehash) {
+  using Pair = std::pair<const std::string, int>;
+  using table = flat_hashtable<Pair, std::string, KeyOfValue<std::string, int>>;
+  table t1;
+  for (int i = 0; i < 100; ++i) {
+    t1.insert({std::to_string(i), i});
+  }
+
+  table t2(t1);
+  t1.find("5")->second = -5;
+  EXPECT_EQ(t2.find("5")->second, 5);
+
+  table t3(std::move(t1));
+  EXPECT_TRUE(t1.empty());
+  EXPECT_EQ(t1.find("5"), t1.end());
+  EXPECT_EQ(t3.find("5")->second, -5);
+  t1.insert({"after move", 1});  // the moved-from table allocates again
+  EXPECT_EQ(t1.size(), 1);
+
+  t3.rehash(1000);
+  EXPECT_GE(t3.bucket_count(), 1000);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(t3.count(std::to_string(i)), 1);
+  }
+
+  t2 = t3;
+  EXPECT_EQ(t2.find("5")->second, -5);
+  t2.clear();
+  EXPECT_TRUE(t2.empty());
+  EXPECT_EQ(t2.begin(), t2.end());
+}
+
+TEST(FlatHashTableTest, ReserveAndShrink) {
+  flat_hashtable<int, int, Identity<int>> hset(0);
+  EXPECT_EQ(hset.bucket_count(), 0);
+  hset.reserve(1000);
+  const size_t capacity = hset.bucket_count();
+  for (int i = 0; i < 1000; ++i) {
+    hset.insert(i);
+  }
+  EXPECT_EQ(hset.bucket_count(), capacity);
+
+  for (int i = 0; i < 1000; i += 2) {
+    hset.erase(i);
+  }
+  hset.shrink_to_fit();
+  EXPECT_LT(hset.bucket_count(), capacity);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(hset.count(i), i % 2);
+  }
+
+  hset.clear();
+  hset.shrink_to_fit();
+  EXPECT_EQ(hset.bucket_count(), 0);
+  EXPECT_EQ(hset.begin(), hset.end());
+  hset.insert(1);
+  EXPECT_EQ(hset.count(1), 1);
+}
+
+TEST(FlatHashTableTest, Wrappers) {
+  flat_unordered_map<std::string, int> m = {{"a", 1}, {"b", 2}};
+  m["c"] = 3;
+  m["a"] += 41;
+  EXPECT_EQ(m["a"], 42);
+  EXPECT_EQ(m.size(), 3);
+  m.erase("b");
+  EXPECT_EQ(m.find("b"), m.end());
+
+  flat_unordered_set<int> s = {1, 2, 3, 3};
+  EXPECT_EQ(s.size(), 3);
+
+  flat_unordered_multimap<char, int> mm = {{'a', 1}, {'a', 2}, {'b', 3}};
+  EXPECT_EQ(mm.count('a'), 2);
+
+  flat_unordered_multiset<int> ms;
+  for (int i = 0; i < 100; ++i) {
+    ms.insert(i % 10);
+  }
+  EXPECT_EQ(ms.count(3), 10);
+  ms.erase(3);
+  EXPECT_EQ(ms.count(3), 9);
+  EXPECT_EQ(ms.size(), 99);
+}
+
+TEST(FlatHashTableTest, InsertValueFromTableAcrossGrowth) {
+  flat_unordered_map<int, std::string> m;
+  m.insert(0, std::string(64, 'x'));  // long enough to live on the heap
+  for (int k = 1; k < 100; ++k) {
+    m.insert(k, m.find(0)->second);
+  }
+  EXPECT_EQ(m.size(), 100);
+  EXPECT_EQ(m.find(99)->second, std::string(64, 'x'));
+
+  flat_unordered_multimap<int, std::string> mm;
+  mm.insert(7, std::string(64, 'y'));
+  for (int i = 0; i < 100; ++i) {
+    auto it = mm.find(7);
+    mm.insert(it->first, it->second);  // key and value both live in the table
+  }
+  EXPECT_EQ(mm.count(7), 101);
+}
+
+}  // namespace my::testing
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <mystd/array.hpp>
+#include <mystd/frozen_map.hpp>
+#include <mystd/frozen_set.hpp>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace my::testing {
+
+namespace {
+
+using namespace std::string_view_literals;
+
+constexpr my::array<std::pair<std::string_view, int>, 8> methods = {
+    {"GET", 1}, {"HEAD", 2}, {"POST", 3}, {"PUT", 4}, {"DELETE", 5}, {"CONNECT", 6}, {"OPTIONS", 7}, {"TRACE", 8}};
+
+constexpr my::frozen_map method_codes(methods);
+
+// built by the compiler: the lookups below are constant expressions
+static_assert(method_codes.size() == 8);
+static_assert(method_codes.at("PUT") == 4);
+static_assert(method_codes.contains("TRACE"));
+static_assert(!method_codes.contains("PATCH"));
+static_assert(method_codes.find("get") == method_codes.end());
+
+enum class opcode : std::uint8_t { nop, load, store, jump, call, ret };
+
+constexpr my::array<opcode, 4> memory_ops = {opcode::load, opcode::store, opcode::call, opcode::ret};
+
+static_assert(my::frozen_set(memory_ops).contains(opcode::call));
+static_assert(!my::frozen_set(memory_ops).contains(opcode::jump));
+
+constexpr std::size_t MEDIUM = 1000;
+
+/// sparse keys: i * 7919 + 13, the value of a key is its index
+constexpr my::frozen_map<std::uint32_t, std::uint32_t, MEDIUM> make_medium() {
+  my::array<std::pair<std::uint32_t, std::uint32_t>, MEDIUM> values;
+  for (std::uint32_t i = 0; i < MEDIUM; ++i) {
+    values[i] = {i * 7919 + 13, i};
+  }
+  return my::frozen_map<std::uint32_t, std::uint32_t, MEDIUM>(values);
+}
+
+constexpr auto medium = make_medium();
+
+}  // namespace
+
+TEST(FrozenMapTest, Lookup) {
+  for (const auto& [name, code] : methods) {
+    ASSERT_NE(method_codes.find(name), method_codes.end()) << name;
+    EXPECT_EQ(method_codes.find(name)->second, code);
+    EXPECT_EQ(method_codes.count(name), 1);
+  }
+  EXPECT_EQ(method_codes.count("PATCH"sv), 0);
+  EXPECT_EQ(method_codes.at("DELETE"), 5);
+  EXPECT_THROW(method_codes.at("PATCH"), std::out_of_range);
+
+  int sum = 0;
+  for (const auto& [name, code] : method_codes) {
+    sum += code;
+  }
+  EXPECT_EQ(sum, 36);
+}
+
+TEST(FrozenMapTest, EveryKeyHasItsOwnSlot) {
+  EXPECT_EQ(medium.size(), MEDIUM);
+  for (std::uint32_t i = 0; i < MEDIUM; ++i) {
+    const auto it = medium.find(i * 7919 + 13);
+    ASSERT_NE(it, medium.end()) << i;
+    EXPECT_EQ(it->second, i);
+    EXPECT_FALSE(medium.contains(i * 7919 + 14));
+  }
+}
+
+TEST(FrozenMapTest, BuiltAtRunTime) {
+  my::array<std::pair<int, int>, 3> values = {{-1, 1}, {0, 2}, {1 << 30, 3}};
+  const my::frozen_map map(values);
+  EXPECT_EQ(map.at(-1), 1);
+  EXPECT_EQ(map.at(1 << 30), 3);
+  EXPECT_FALSE(map.contains(1));
+
+  my::array<std::pair<int, int>, 3> twice = {{7, 1}, {8, 2}, {7, 3}};
+  EXPECT_THROW(my::frozen_map{twice}, std::invalid_argument);
+
+  struct ConstantHash {
+    constexpr std::size_t operator()(int) const noexcept { return 42; }
+  };
+  my::array<std::pair<int, int>, 2> colliding = {{1, 1}, {2, 2}};
+  EXPECT_THROW((my::frozen_map<int, int, 2, ConstantHash>(colliding)), std::invalid_argument);
+}
+
+TEST(FrozenMapTest, TransparentSet) {
+  constexpr my::array<std::string_view, 5> headers = {"host", "accept", "content-type", "content-length", "cookie"};
+  constexpr my::frozen_set<std::string_view, 5, my::frozen_hash, std::equal_to<>> set(headers);
+  const char* cookie = "cookie";
+  EXPECT_TRUE(set.contains(cookie));
+  EXPECT_EQ(*set.find(cookie), "cookie");
+  EXPECT_EQ(set.count("referer"), 0);
+  EXPECT_EQ(set.size(), 5);
+
+  const my::frozen_set one(my::array<int, 1>{5});
+  EXPECT_TRUE(one.contains(5));
+  EXPECT_FALSE(one.contains(6));
+}
+
+}  // namespace my::testing
@@ -1,7 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <mystd/hashtable.hpp>
+#include <mystd/unordered_map.hpp>
+#include <random>
+#include <sstream>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace my::testing {
 
@@ -163,4 +171,289 @@ TEST(HashTableTest, Count) {
   EXPECT_EQ(multi_hmap.size(), 2);
 }
 
+TEST(HashTableTest, PowerOfTwoBuckets) {
+  using table = my::hashtable<int, int, Identity<int>, std::hash<int>, std::equal_to<int>, InsertPolicy::UniqueKeys,
+                              std::allocator<int>, bucket_policy::power_of_two>;
+  table hset(3);
+  EXPECT_EQ(hset.bucket_count(), 4);
+
+  for (int i = 0; i < 1000; ++i) {
+    hset.insert(i);
+  }
+  EXPECT_EQ(hset.bucket_count(), 2048);  // 4 8 ... 2048, rehashed above 0.75
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(hset.count(i), 1);
+  }
+  hset.erase(500);
+  EXPECT_EQ(hset.find(500), hset.end());
+
+  // sequential keys are spread by the mix: no bucket is much longer than the load factor
+  hset.rehash(1024);
+  EXPECT_EQ(hset.bucket_count(), 1024);
+  std::vector<int> chain(1024, 0);
+  for (int k : hset) {
+    ++chain[bucket_policy::power_of_two::index(bucket_policy::power_of_two::mix(std::hash<int>()(k)), 1024)];
+  }
+  EXPECT_LE(*std::max_element(chain.begin(), chain.end()), 8);
+}
+
+TEST(HashTableTest, PrimeBuckets) {
+  using table = my::hashtable<int, int, Identity<int>, std::hash<int>, std::equal_to<int>, InsertPolicy::UniqueKeys,
+                              std::allocator<int>, bucket_policy::prime>;
+  table hset(8);
+  EXPECT_EQ(hset.bucket_count(), 11);
+
+  for (int i = 0; i < 100; ++i) {
+    hset.insert(i * 8);  // a poor hash: only multiples of 8
+  }
+  EXPECT_EQ(hset.bucket_count(), 197);  // 11 23 47 97 197
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(hset.count(i * 8), 1);
+    EXPECT_EQ(hset.count(i * 8 + 1), 0);
+  }
+}
+
+TEST(HashTableTest, BucketPolicyThroughWrapper) {
+  my::unordered_map_base<int, int, std::hash<int>, std::equal_to<int>, InsertPolicy::UniqueKeys,
+                         std::allocator<std::pair<const int, int>>,
+                         hashtable_with_buckets<bucket_policy::power_of_two>::type>
+      m(5);
+  EXPECT_EQ(m.bucket_count(), 8);
+  for (int i = 0; i < 100; ++i) {
+    m[i] = i * 10;
+  }
+  EXPECT_EQ(m.bucket_count(), 256);
+  EXPECT_EQ(m[42], 420);
+}
+
+TEST(HashTableTest, FingerprintedBuckets) {
+  using table = my::hashtable<std::pair<const int, int>, int, KeyOfValue<int, int>, std::hash<int>, std::equal_to<int>,
+                              InsertPolicy::AllowDuplicates, std::allocator<std::pair<const int, int>>,
+                              bucket_policy::fingerprinted<>, rehash_policy::incremental<1>>;
+  table hmap(4);
+  std::unordered_multimap<int, int> expected;
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int> key(0, 300);
+  for (int step = 0; step < 20000; ++step) {
+    const int k = key(gen);
+    if (gen() % 3 == 0) {
+      hmap.erase(k);  // refilters the bucket of k
+      if (auto it = expected.find(k); it != expected.end()) expected.erase(it);
+    } else {
+      hmap.insert({k, step});
+      expected.insert({k, step});
+    }
+    if (step % 1000 == 0) hmap.rehash(hmap.bucket_count() / 2);
+  }
+  EXPECT_EQ(hmap.size(), expected.size());
+  for (int k = -10; k < 310; ++k) {
+    ASSERT_EQ(hmap.count(k), expected.count(k)) << k;
+    EXPECT_EQ(hmap.find(k) == hmap.end(), !expected.contains(k));
+  }
+  EXPECT_EQ(static_cast<size_t>(std::distance(hmap.begin(), hmap.end())), expected.size());
+
+  table copy(hmap);  // the filters are copied with the chains
+  std::vector<int> keys(320);
+  std::iota(keys.begin(), keys.end(), -10);
+  std::vector<bool> found;
+  copy.contains_batch(keys.begin(), keys.end(), std::back_inserter(found));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(found[i], expected.contains(keys[i]));
+  }
+}
+
+TEST(HashTableTest, IterationVisitsEveryBucket) {
+  my::hashtable<int, int, Identity<int>> hset;
+  for (int i = 0; i < 10; ++i) {
+    hset.insert(i);  // 0 hashes to bucket 0
+  }
+  EXPECT_EQ(std::distance(hset.begin(), hset.end()), 10);
+}
+
+TEST(HashTableTest, IncrementalRehash) {
+  using table = my::hashtable<int, int, Identity<int>, std::hash<int>, std::equal_to<int>, InsertPolicy::UniqueKeys,
+                              std::allocator<int>, bucket_policy::modulo, rehash_policy::incremental<1>>;
+  table hset(64);
+  for (int i = 0; i < 48; ++i) {
+    hset.insert(i);
+  }
+  EXPECT_FALSE(hset.rehashing());
+
+  // crossing the load factor only swaps in a bigger array, the nodes move a bucket per operation
+  auto [it, inserted] = hset.insert(48);
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(*it, 48);
+  EXPECT_TRUE(hset.rehashing());
+  EXPECT_EQ(hset.bucket_count(), 128);
+
+  // while both arrays are live: lookups, duplicates, erase and iteration see every element once
+  EXPECT_FALSE(hset.insert(3).second);
+  for (int i = 0; i < 49; ++i) {
+    EXPECT_EQ(hset.count(i), 1);
+  }
+  hset.erase(20);
+  EXPECT_EQ(hset.find(20), hset.end());
+  EXPECT_TRUE(hset.rehashing());
+  EXPECT_EQ(std::distance(hset.begin(), hset.end()), 48);
+
+  table copy(hset);
+  EXPECT_EQ(std::distance(copy.begin(), copy.end()), 48);
+  EXPECT_EQ(copy.count(47), 1);
+
+  for (int i = 0; hset.rehashing(); i = (i + 1) % 20) {
+    ASSERT_NE(hset.find(i), hset.end());  // every find drains a bucket
+  }
+  EXPECT_EQ(hset.size(), 48);
+  for (int i = 0; i < 49; ++i) {
+    EXPECT_EQ(hset.count(i), i != 20);
+  }
+  EXPECT_EQ(std::distance(hset.begin(), hset.end()), 48);
+}
+
+TEST(HashTableTest, IncrementalRehashGrowsWhileDraining) {
+  using table = my::hashtable<std::pair<const int, int>, int, KeyOfValue<int, int>, std::hash<int>,
+                              std::equal_to<int>, InsertPolicy::AllowDuplicates,
+                              std::allocator<std::pair<const int, int>>, bucket_policy::modulo,
+                              rehash_policy::incremental<>>;
+  table hmap;
+  for (int i = 0; i < 100000; ++i) {
+    hmap.insert({i % 1000, i});
+  }
+  EXPECT_EQ(hmap.size(), 100000);
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(hmap.count(i), 100);
+  }
+  hmap.rehash(10);  // finishes the migration
+  EXPECT_FALSE(hmap.rehashing());
+  EXPECT_EQ(std::distance(hmap.begin(), hmap.end()), 100000);
+  hmap.clear();
+  EXPECT_TRUE(hmap.empty());
+  EXPECT_EQ(hmap.begin(), hmap.end());
+}
+
+TEST(HashTableTest, BatchesDuringIncrementalRehash) {
+  using table = my::hashtable<int, int, Identity<int>, std::hash<int>, std::equal_to<int>, InsertPolicy::UniqueKeys,
+                              std::allocator<int>, bucket_policy::power_of_two, rehash_policy::incremental<1>>;
+  table hset(64);
+  std::vector<int> values(49);
+  std::iota(values.begin(), values.end(), 0);
+  EXPECT_EQ(hset.insert_batch(values.begin(), values.end()), 49);
+  EXPECT_TRUE(hset.rehashing());
+
+  // keys in old and new buckets alike, and a missing one
+  values.push_back(1000);
+  std::vector<table::iterator> found;
+  hset.find_batch(values.begin(), values.end(), std::back_inserter(found));
+  for (int i = 0; i < 49; ++i) {
+    ASSERT_NE(found[i], hset.end());
+    EXPECT_EQ(*found[i], i);
+  }
+  EXPECT_EQ(found.back(), hset.end());
+}
+
+template <class Table>
+concept has_stats = requires(const Table& t) { t.stats(); };
+
+TEST(HashTableTest, Stats) {
+  struct ParityHash {
+    size_t operator()(int k) const { return k % 2; }
+  };
+  using table = my::hashtable<int, int, Identity<int>, ParityHash, std::equal_to<int>, InsertPolicy::UniqueKeys,
+                              std::allocator<int>, bucket_policy::modulo, rehash_policy::stop_the_world, true>;
+  using plain = my::hashtable<int, int, Identity<int>, ParityHash, std::equal_to<int>, InsertPolicy::UniqueKeys,
+                              std::allocator<int>, bucket_policy::modulo, rehash_policy::stop_the_world, false>;
+  static_assert(has_stats<table> && !has_stats<plain>);
+
+  table hset(16);
+  for (int i = 0; i < 8; ++i) {
+    hset.insert(i);  // two chains: the evens and the odds
+  }
+  EXPECT_NE(hset.find(0), hset.end());  // the oldest of its chain
+
+  hashtable_stats s = hset.stats();
+  EXPECT_EQ(s.size, 8);
+  EXPECT_EQ(s.bucket_count, 16);
+  ASSERT_EQ(s.chain_histogram.size(), 5);
+  EXPECT_EQ(s.chain_histogram[0], 14);
+  EXPECT_EQ(s.chain_histogram[4], 2);
+  EXPECT_EQ(s.max_chain, 4);
+  EXPECT_EQ(s.lookups, 9);
+  EXPECT_EQ(s.probes, 0 + 0 + 1 + 1 + 2 + 2 + 3 + 3 + 4);
+  EXPECT_EQ(s.max_probes, 4);
+  EXPECT_EQ(s.rehashes, 0);
+  EXPECT_EQ(s.node_allocations, 8);
+  EXPECT_EQ(s.bucket_allocations, 1);
+
+  hset.rehash(64);
+  s = hset.stats();
+  EXPECT_EQ(s.rehashes, 1);
+  EXPECT_EQ(s.bucket_allocations, 2);
+  EXPECT_EQ(s.chain_histogram[4], 2);  // a bad hash stays bad with more buckets
+
+  std::ostringstream os;
+  s.dump(os);
+  EXPECT_NE(os.str().find("chains: max 4, histogram 0:62 4:2"), std::string::npos) << os.str();
+}
+
+TEST(HashTableTest, NodeHandles) {
+  using table = my::hashtable<int, int, Identity<int>, std::hash<int>, std::equal_to<int>, InsertPolicy::UniqueKeys,
+                              std::allocator<int>, bucket_policy::fingerprinted<>, rehash_policy::incremental<1>, true>;
+  table a;
+  table b;
+  for (int i = 0; i < 100; ++i) {
+    a.insert(i);
+    b.insert(i + 50);  // 50..99 are in both
+  }
+  const int* address = &*a.find(7);
+
+  auto nh = a.extract(7);
+  ASSERT_FALSE(nh.empty());
+  EXPECT_EQ(&nh.value(), address);
+  EXPECT_EQ(a.size(), 99);
+  EXPECT_FALSE(a.contains(7));
+  EXPECT_TRUE(a.extract(7).empty());
+
+  auto res = b.insert(std::move(nh));
+  EXPECT_TRUE(res.inserted);
+  EXPECT_TRUE(res.node.empty());
+  EXPECT_EQ(&*res.position, address);  // the same node, relinked
+  EXPECT_EQ(b.size(), 101);
+
+  res = b.insert(a.extract(60));  // 60 is in b already: the node comes back
+  EXPECT_FALSE(res.inserted);
+  ASSERT_FALSE(res.node.empty());
+  EXPECT_EQ(res.node.value(), 60);
+  EXPECT_EQ(*res.position, 60);
+  EXPECT_FALSE(b.insert(table::node_type()).inserted);
+
+  const std::size_t allocations = a.stats().node_allocations + b.stats().node_allocations;
+  b.merge(a);  // moves 0..49 but 7, keeps 50..99 but 60 in a
+  EXPECT_EQ(a.size(), 49);
+  EXPECT_EQ(b.size(), 150);
+  for (int i = 0; i < 150; ++i) {
+    EXPECT_EQ(b.count(i), 1) << i;
+    EXPECT_EQ(a.count(i), i >= 50 && i < 100 && i != 60) << i;
+  }
+  EXPECT_EQ(a.stats().node_allocations + b.stats().node_allocations, allocations);
+  EXPECT_EQ(std::distance(a.begin(), a.end()), 49);
+  EXPECT_EQ(std::distance(b.begin(), b.end()), 150);
+
+  b.merge(b);
+  EXPECT_EQ(b.size(), 150);
+}
+
+TEST(HashTableTest, MergeRepeatedKeys) {
+  my::hashtable<int, int, Identity<int>, std::hash<int>, std::equal_to<int>, InsertPolicy::AllowDuplicates> a;
+  my::hashtable<int, int, Identity<int>, std::hash<int>, std::equal_to<int>, InsertPolicy::AllowDuplicates> b;
+  for (int i = 0; i < 20; ++i) {
+    a.insert(i % 5);
+    b.insert(i % 5);
+  }
+  b.merge(a);
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(a.begin(), a.end());
+  EXPECT_EQ(b.size(), 40);
+  EXPECT_EQ(b.count(3), 8);
+}
+
 }  // namespace my::testing
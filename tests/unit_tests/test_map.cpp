@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 
 #include <exception>
+#include <iterator>
 #include <string>
+#include <string_view>
 
 #include "mystd/map.hpp"
 
@@ -160,4 +162,41 @@ TEST(MapTest, Highload) {
   EXPECT_EQ(m.size(), n);
 }
 
+TEST(MapTest, OrderedLookups) {
+  my::map<int, int> m;
+  for (int i = 0; i < 100; i += 10) {
+    m[i] = i;
+  }
+  EXPECT_EQ(m.lower_bound(30)->first, 30);
+  EXPECT_EQ(m.lower_bound(31)->first, 40);
+  EXPECT_EQ(m.upper_bound(30)->first, 40);
+  EXPECT_EQ(m.lower_bound(91), m.end());
+  EXPECT_EQ(m.lower_bound(-5)->first, 0);
+
+  auto [first, last] = m.equal_range(50);
+  ASSERT_NE(first, m.end());
+  EXPECT_EQ(first->first, 50);
+  EXPECT_EQ(last->first, 60);
+  auto [none, none_end] = m.equal_range(55);
+  EXPECT_EQ(none, none_end);
+}
+
+TEST(MapTest, TransparentLookup) {
+  using tree = my::rb_tree<std::pair<std::string, int>, KeyOfPair<std::string, int>, std::less<>>;
+  my::map<std::string, int, tree> m = {{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+
+  const std::string_view key = "banana";
+  EXPECT_EQ(m.find(key)->second, 2);
+  EXPECT_TRUE(m.contains(key));
+  EXPECT_EQ(m.count(std::string_view("kiwi")), 0);
+  EXPECT_EQ(m.lower_bound(std::string_view("b"))->first, "banana");
+  EXPECT_EQ(m.upper_bound(key)->first, "cherry");
+  EXPECT_EQ(std::distance(m.equal_range(key).first, m.equal_range(key).second), 1);
+  EXPECT_EQ(m.find("cherry")->second, 3);  // const char* compares directly too
+
+  m.erase(key);
+  EXPECT_FALSE(m.contains(key));
+  EXPECT_EQ(m.size(), 2);
+}
+
 }  // namespace my::testing
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mystd/mpmc_queue.hpp"
+
+namespace my::testing {
+
+TEST(MpmcQueueTest, NonBlockingSingleThread) {
+  mpmc_queue<std::string> q(3);
+  EXPECT_EQ(q.capacity(), 4);
+  EXPECT_TRUE(q.empty());
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(q.try_push(std::to_string(i)));
+  }
+  std::string rejected = "4";
+  EXPECT_FALSE(q.try_push(std::move(rejected)));
+  EXPECT_EQ(rejected, "4");  // not moved from when full
+  EXPECT_EQ(q.size(), 4);
+
+  std::string value;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(q.try_pop(value));
+    EXPECT_EQ(value, std::to_string(i));
+  }
+  EXPECT_FALSE(q.try_pop(value));
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(MpmcQueueTest, WrapsAroundManyLaps) {
+  mpmc_queue<int> q(2);
+  for (int i = 0; i < 1000; ++i) {
+    q.push(i);
+    EXPECT_EQ(q.pop(), i);
+  }
+}
+
+TEST(MpmcQueueTest, DestroysRemainingElements) {
+  auto shared = std::make_shared<int>(0);
+  {
+    mpmc_queue<std::shared_ptr<int>> q(8);
+    q.push(shared);
+    q.push(shared);
+    q.pop();
+    EXPECT_EQ(shared.use_count(), 2);
+  }
+  EXPECT_EQ(shared.use_count(), 1);
+}
+
+/// every producer pushes its own range of values, the consumers together must pop each value exactly once
+template <typename Wait>
+void many_producers_many_consumers() {
+  constexpr uint64_t per_producer = 20000;
+  constexpr int producers = 3;
+  constexpr int consumers = 3;
+  constexpr uint64_t total = per_producer * producers;
+  mpmc_queue<uint64_t, Wait> q(16);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&q, p] {
+      for (uint64_t i = 0; i < per_producer; ++i) {
+        q.push(p * per_producer + i);
+      }
+    });
+  }
+
+  std::vector<std::vector<uint64_t>> popped(consumers);
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&q, &popped, c] {
+      for (uint64_t i = 0; i < total / consumers; ++i) {
+        popped[c].push_back(q.pop());
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  std::vector<int> seen(total, 0);
+  for (const auto& values : popped) {
+    uint64_t last[producers] = {};
+    bool first[producers] = {true, true, true};
+    for (uint64_t v : values) {
+      ++seen[v];
+      // one consumer sees the values of one producer in push order
+      const auto p = v / per_producer;
+      EXPECT_TRUE(first[p] || last[p] < v);
+      first[p] = false;
+      last[p] = v;
+    }
+  }
+  for (uint64_t v = 0; v < total; ++v) {
+    ASSERT_EQ(seen[v], 1) << v;
+  }
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(MpmcQueueTest, ManyProducersManyConsumersSpin) { many_producers_many_consumers<queue_wait::spin>(); }
+
+TEST(MpmcQueueTest, ManyProducersManyConsumersFutex) { many_producers_many_consumers<queue_wait::futex>(); }
+
+TEST(MpmcQueueTest, FutexWaitWakesBlockedConsumer) {
+  mpmc_queue<int, queue_wait::futex> q(4);
+  int value = 0;
+  std::thread consumer([&] { q.pop(value); });  // sleeps on the empty queue
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  q.push(42);
+  consumer.join();
+  EXPECT_EQ(value, 42);
+}
+
+}  // namespace my::testing
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "mystd/array.hpp"
+#include "mystd/simd.hpp"
+#include "mystd/vector.hpp"
+
+namespace my::testing {
+
+template <typename T>
+std::vector<T> random_values(size_t n, int lo, int hi, unsigned seed = 42) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(lo, hi);
+  std::vector<T> out(n);
+  for (auto& el : out) {
+    el = static_cast<T>(dist(gen));
+  }
+  return out;
+}
+
+template <typename T>
+void checkKernelsAgainstScalar() {
+  // lengths around the 32 byte register boundary exercise the tails
+  for (size_t n : {1, 3, 7, 8, 15, 16, 31, 32, 33, 64, 100, 1000}) {
+    auto a = random_values<T>(n, 0, 50);
+    auto b = a;
+
+    EXPECT_EQ(simd::mismatch(a.data(), b.data(), n), n);
+    EXPECT_TRUE(simd::equal(a.data(), b.data(), n));
+    b[n - 1] = static_cast<T>(b[n - 1] + 1);
+    EXPECT_EQ(simd::mismatch(a.data(), b.data(), n), simd::scalar::mismatch(a.data(), b.data(), n));
+    EXPECT_FALSE(simd::equal(a.data(), b.data(), n));
+
+    for (T key : {T(0), T(7), T(50), T(99)}) {
+      EXPECT_EQ(simd::find(a.data(), a.data() + n, key), simd::scalar::find(a.data(), a.data() + n, key));
+      EXPECT_EQ(simd::count(a.data(), a.data() + n, key), simd::scalar::count(a.data(), a.data() + n, key));
+    }
+
+    EXPECT_EQ(simd::min(a.data(), a.data() + n), simd::scalar::min(a.data(), a.data() + n));
+    EXPECT_EQ(simd::max(a.data(), a.data() + n), simd::scalar::max(a.data(), a.data() + n));
+    EXPECT_EQ(simd::sum(a.data(), a.data() + n), simd::scalar::sum(a.data(), a.data() + n));
+  }
+}
+
+TEST(SimdTest, KernelsMatchScalar) {
+  checkKernelsAgainstScalar<int8_t>();
+  checkKernelsAgainstScalar<uint8_t>();
+  checkKernelsAgainstScalar<int16_t>();
+  checkKernelsAgainstScalar<uint16_t>();
+  checkKernelsAgainstScalar<int32_t>();
+  checkKernelsAgainstScalar<uint32_t>();
+  checkKernelsAgainstScalar<int64_t>();
+  checkKernelsAgainstScalar<uint64_t>();
+  checkKernelsAgainstScalar<double>();  // small integers, so the sum is exact
+  checkKernelsAgainstScalar<float>();
+}
+
+TEST(SimdTest, SignedMinMax) {
+  std::vector<int32_t> v = {5, -3, 7, 100, -200, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, -7};
+  EXPECT_EQ(simd::min(v.data(), v.data() + v.size()), -200);
+  EXPECT_EQ(simd::max(v.data(), v.data() + v.size()), 100);
+
+  std::vector<uint8_t> u(100, 200);
+  u[77] = 255;
+  u[13] = 1;
+  EXPECT_EQ(simd::min(u.data(), u.data() + u.size()), 1);
+  EXPECT_EQ(simd::max(u.data(), u.data() + u.size()), 255);
+}
+
+template <typename T>
+void checkNanMinMax() {
+  const T nan = std::numeric_limits<T>::quiet_NaN();
+  // a NaN first, in the vector part and in the tail
+  for (size_t pos : {0, 5, 17}) {
+    std::vector<T> v(19);
+    for (size_t i = 0; i < v.size(); ++i) {
+      v[i] = static_cast<T>(i % 7) + 2;
+    }
+    v[pos] = nan;
+    const T* first = v.data();
+    const T* last = v.data() + v.size();
+    const T min = simd::min(first, last);
+    const T max = simd::max(first, last);
+    const T scalar_min = simd::scalar::min(first, last);
+    const T scalar_max = simd::scalar::max(first, last);
+    EXPECT_EQ(std::isnan(min), std::isnan(scalar_min));
+    EXPECT_EQ(std::isnan(max), std::isnan(scalar_max));
+    if (!std::isnan(scalar_min)) {
+      EXPECT_EQ(min, scalar_min);
+    }
+    if (!std::isnan(scalar_max)) {
+      EXPECT_EQ(max, scalar_max);
+    }
+  }
+}
+
+TEST(SimdTest, NanMinMaxMatchScalar) {
+  checkNanMinMax<float>();
+  checkNanMinMax<double>();
+
+  std::vector<float> v(16, 3.0f);
+  v[0] = std::numeric_limits<float>::quiet_NaN();
+  v[9] = 2.0f;
+  EXPECT_TRUE(std::isnan(simd::min(v.data(), v.data() + v.size())));
+}
+
+TEST(SimdTest, LongDoubleTakesScalarPath) {
+  static_assert(!simd::detail::is_lane_type_v<long double>);
+  static_assert(!simd::detail::has_vector_minmax_v<long double>);
+  static_assert(!simd::detail::has_vector_sum_v<long double>);
+
+  std::vector<long double> v;
+  for (int i = 0; i < 40; ++i) {
+    v.push_back(0.5L * i);
+  }
+  v[7] = -7.0L;
+  v[33] = 21.5L;
+  const long double* first = v.data();
+  const long double* last = v.data() + v.size();
+
+  EXPECT_EQ(simd::min(first, last), -7.0L);
+  EXPECT_EQ(simd::max(first, last), 21.5L);
+  EXPECT_EQ(simd::sum(first, last), simd::scalar::sum(first, last));
+  EXPECT_EQ(simd::find(first, last, 21.5L), first + 33);
+  EXPECT_EQ(simd::count(first, last, 0.5L), 1u);
+}
+
+TEST(SimdTest, Compare) {
+  std::vector<uint32_t> a(100, 1), b(100, 1);
+  EXPECT_EQ(simd::compare(a.data(), a.size(), b.data(), b.size()), 0);
+  b[60] = 2;
+  EXPECT_LT(simd::compare(a.data(), a.size(), b.data(), b.size()), 0);
+  EXPECT_GT(simd::compare(b.data(), b.size(), a.data(), a.size()), 0);
+  // prefix is less
+  EXPECT_LT(simd::compare(a.data(), 50, a.data(), 100), 0);
+
+  // bytewise mismatch, but element order decides
+  std::vector<int32_t> s1 = {1, -1}, s2 = {1, 1};
+  EXPECT_LT(simd::compare(s1.data(), 2, s2.data(), 2), 0);
+  std::vector<uint32_t> u1 = {0x0100}, u2 = {0x00FF};
+  EXPECT_GT(simd::compare(u1.data(), 1, u2.data(), 1), 0);
+}
+
+TEST(SimdTest, VectorOperatorsAreLexicographic) {
+  vector<uint32_t> a = {1, 2, 3};
+  vector<uint32_t> b = {1, 2, 3, 0};
+  vector<uint32_t> c = {1, 3};
+
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a < b);
+  EXPECT_TRUE(b < c);
+  EXPECT_TRUE(c > a);
+  EXPECT_FALSE(b < a);  // used to read past the end of rhs
+
+  vector<std::string, 4> s1 = {"a", "b"};
+  vector<std::string, 4> s2 = {"a", "c"};
+  EXPECT_TRUE(s1 < s2);
+  EXPECT_TRUE(s1 != s2);
+}
+
+TEST(SimdTest, ArrayOperators) {
+  array<uint32_t, 40> a{}, b{};
+  EXPECT_TRUE(a == b);
+  b[39] = 1;
+  EXPECT_TRUE(a < b);
+  EXPECT_TRUE(a != b);
+
+  constexpr array<int, 3> c1 = {1, 2, 3};
+  constexpr array<int, 3> c2 = {1, 2, 4};
+  static_assert(c1 < c2);
+  static_assert(c1 != c2);
+}
+
+}  // namespace my::testing
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "mystd/allocator.hpp"
+#include "mystd/small_vector.hpp"
+
+namespace my::testing {
+
+struct Tracked {
+  static inline int alive = 0;
+  int value = 0;
+
+  Tracked(int v = 0) : value(v) { ++alive; }
+  Tracked(const Tracked& other) : value(other.value) { ++alive; }
+  Tracked(Tracked&& other) noexcept : value(other.value) { ++alive; }
+  Tracked& operator=(const Tracked&) = default;
+  Tracked& operator=(Tracked&&) = default;
+  ~Tracked() { --alive; }
+};
+
+TEST(SmallVectorTest, StaysInlineUpToN) {
+  small_vector<int, 4> v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.capacity(), 4);
+  EXPECT_TRUE(v.is_small());
+
+  for (int i = 0; i < 4; ++i) {
+    v.push_back(i);
+  }
+  EXPECT_TRUE(v.is_small());
+  EXPECT_EQ(v.capacity(), 4);
+
+  v.push_back(4);
+  EXPECT_FALSE(v.is_small());
+  EXPECT_EQ(v.capacity(), 8);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(v[i], i);
+  }
+}
+
+TEST(SmallVectorTest, ShrinkToFitReturnsInline) {
+  small_vector<int, 4> v = {1, 2, 3, 4, 5, 6};
+  EXPECT_FALSE(v.is_small());
+
+  v.resize(3);
+  v.shrink_to_fit();
+  EXPECT_TRUE(v.is_small());
+  EXPECT_EQ(v.capacity(), 4);
+  EXPECT_EQ(v.back(), 3);
+}
+
+TEST(SmallVectorTest, CopyAndMove) {
+  small_vector<std::string, 2> small = {"a", "b"};
+  small_vector<std::string, 2> big = {"a", "b", "c"};
+
+  small_vector<std::string, 2> small_copy(small);
+  small_vector<std::string, 2> big_copy(big);
+  EXPECT_TRUE(small_copy == small);
+  EXPECT_TRUE(big_copy == big);
+
+  small_vector<std::string, 2> small_moved(std::move(small_copy));
+  small_vector<std::string, 2> big_moved(std::move(big_copy));
+  EXPECT_TRUE(small_copy.empty());
+  EXPECT_TRUE(big_copy.empty());
+  EXPECT_TRUE(big_copy.is_small());
+  EXPECT_TRUE(small_moved == small);
+  EXPECT_TRUE(big_moved == big);
+
+  small_moved = big;
+  EXPECT_TRUE(small_moved == big);
+  big_moved = std::move(small_moved);
+  EXPECT_TRUE(big_moved == big);
+}
+
+TEST(SmallVectorTest, Swap) {
+  small_vector<int, 3> a = {1, 2};
+  small_vector<int, 3> b = {3, 4, 5, 6};
+  a.swap(b);
+  EXPECT_EQ(a.size(), 4);
+  EXPECT_EQ(a[3], 6);
+  EXPECT_EQ(b.size(), 2);
+  EXPECT_EQ(b[1], 2);
+  EXPECT_TRUE(b.is_small());
+
+  small_vector<int, 3> c = {7, 8, 9, 10};
+  swap(a, c);
+  EXPECT_EQ(a[0], 7);
+  EXPECT_EQ(c[0], 3);
+}
+
+TEST(SmallVectorTest, InsertEraseMoveOnly) {
+  small_vector<std::unique_ptr<int>, 2> v;
+  v.emplace_back(std::make_unique<int>(1));
+  v.push_back(std::make_unique<int>(3));
+  v.insert(v.begin() + 1, std::make_unique<int>(2));
+  EXPECT_EQ(v.size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(*v[i], i + 1);
+  }
+  v.erase(v.begin());
+  EXPECT_EQ(*v.front(), 2);
+}
+
+TEST(SmallVectorTest, NoLeaksAcrossSpill) {
+  {
+    small_vector<Tracked, 4> v;
+    for (int i = 0; i < 10; ++i) {
+      v.emplace_back(i);
+    }
+    EXPECT_EQ(Tracked::alive, 10);
+    v.erase(v.begin() + 2, v.begin() + 8);
+    EXPECT_EQ(Tracked::alive, 4);
+    v.shrink_to_fit();
+    EXPECT_EQ(Tracked::alive, 4);
+    EXPECT_EQ(v[2].value, 8);
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(SmallVectorTest, ResizeGrowsGeometrically) {
+  small_vector<std::string, 2> v;
+  int reallocations = 0;
+  for (int i = 0; i < 100000; ++i) {
+    const size_t capacity = v.capacity();
+    v.resize(v.size() + 1);
+    reallocations += v.capacity() != capacity;
+  }
+  EXPECT_EQ(v.size(), 100000);
+  EXPECT_LE(reallocations, 20);
+
+  small_vector<int, 2> exact;
+  exact.resize(100);  // past the next step: exactly what it needs
+  EXPECT_EQ(exact.capacity(), 100);
+}
+
+TEST(SmallVectorTest, GrowthPolicyAndAllocator) {
+  small_vector<int, 4, growth::one_and_half> v = {1, 2, 3, 4};
+  v.push_back(5);
+  EXPECT_EQ(v.capacity(), 6);
+
+  monotonic_arena arena;
+  small_vector<std::string, 2, growth::doubling, arena_allocator<std::string>> a{arena};
+  a.push_back("inline");
+  EXPECT_EQ(arena.bytes_allocated(), 0);
+  for (int i = 0; i < 10; ++i) {
+    a.push_back(std::to_string(i));
+  }
+  EXPECT_GT(arena.bytes_allocated(), 0);
+  EXPECT_EQ(a.get_allocator().arena(), &arena);
+
+  auto copy = a;
+  EXPECT_EQ(copy.get_allocator().arena(), &arena);
+  EXPECT_TRUE(copy == a);
+
+  // an empty allocator takes no room next to the inline buffer
+  static_assert(sizeof(small_vector<int, 8>) == 8 * sizeof(int) + sizeof(int*) + 2 * sizeof(size_t));
+}
+
+TEST(SmallVectorTest, Comparations) {
+  small_vector<int, 2> a = {1, 2};
+  small_vector<int, 2> b = {1, 2, 3};
+  EXPECT_TRUE(a < b);
+  EXPECT_TRUE(b > a);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a <= a);
+}
+
+}  // namespace my::testing
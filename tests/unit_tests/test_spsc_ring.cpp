@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mystd/spsc_ring.hpp"
+
+namespace my::testing {
+
+TEST(SpscRingTest, PushPopSingleThread) {
+  spsc_ring<int, 4> ring;
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(ring.capacity(), 4);
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(ring.try_push(i));
+  }
+  EXPECT_FALSE(ring.try_push(4));
+  EXPECT_EQ(ring.size(), 4);
+
+  int value = -1;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(ring.try_pop(value));
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, WrapsAround) {
+  spsc_ring<std::string, 4> ring;
+  std::string value;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(ring.try_emplace(std::to_string(i)));
+    EXPECT_TRUE(ring.try_push(std::to_string(-i)));
+    EXPECT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, std::to_string(i));
+    EXPECT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, std::to_string(-i));
+  }
+}
+
+TEST(SpscRingTest, BatchedPushPop) {
+  spsc_ring<int, 8> ring;
+  std::vector<int> in(20);
+  std::iota(in.begin(), in.end(), 0);
+
+  EXPECT_EQ(ring.try_push_n(in.begin(), 5), 5);
+  EXPECT_EQ(ring.try_push_n(in.begin() + 5, 15), 3);  // only 3 free slots
+
+  std::vector<int> out;
+  EXPECT_EQ(ring.try_pop_n(std::back_inserter(out), 6), 6);
+  EXPECT_EQ(ring.try_push_n(in.begin() + 8, 12), 6);  // wraps around
+  EXPECT_EQ(ring.try_pop_n(std::back_inserter(out), 100), 8);
+  EXPECT_EQ(ring.try_pop_n(std::back_inserter(out), 1), 0);
+
+  EXPECT_EQ(out, std::vector<int>(in.begin(), in.begin() + 14));
+}
+
+TEST(SpscRingTest, DestroysRemainingElements) {
+  auto shared = std::make_shared<int>(0);
+  {
+    spsc_ring<std::shared_ptr<int>, 4> ring;
+    ring.try_push(shared);
+    ring.try_push(shared);
+    ring.try_push(shared);
+    std::shared_ptr<int> out;
+    ring.try_pop(out);
+    out.reset();
+    EXPECT_EQ(shared.use_count(), 3);
+  }
+  EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(SpscRingTest, TwoThreadsKeepOrder) {
+  constexpr uint64_t count = 100000;
+  spsc_ring<uint64_t, 64> ring;
+
+  std::thread producer([&] {
+    uint64_t next = 0;
+    uint64_t batch[16];
+    while (next < count) {
+      uint64_t pushed = 0;
+      if (next % 3 == 0) {
+        pushed = ring.try_push(next) ? 1 : 0;
+      } else {
+        const uint64_t n = std::min<uint64_t>(16, count - next);
+        std::iota(batch, batch + n, next);
+        pushed = ring.try_push_n(batch, n);
+      }
+      if (pushed == 0) std::this_thread::yield();  // full
+      next += pushed;
+    }
+  });
+
+  uint64_t expected = 0;
+  bool in_order = true;
+  std::vector<uint64_t> out;
+  while (expected < count) {
+    out.clear();
+    if (ring.try_pop_n(std::back_inserter(out), 32) == 0) std::this_thread::yield();  // empty
+    for (uint64_t x : out) {
+      in_order = in_order && x == expected;
+      ++expected;
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_TRUE(ring.empty());
+}
+
+}  // namespace my::testing
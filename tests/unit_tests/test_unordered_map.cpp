@@ -1,6 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mystd/allocator.hpp"
 #include "mystd/unordered_map.hpp"
+#include "mystd/unordered_set.hpp"
 
 namespace my::testing {
 
@@ -81,6 +91,62 @@ TEST(UnorderedMapTest, Rehash) {
   }
 }
 
+TEST(UnorderedMapTest, ReserveAndLoadFactor) {
+  my::unordered_map<int, int> m;
+  EXPECT_FLOAT_EQ(m.max_load_factor(), 0.75f);
+  m.reserve(1000);
+  const size_t buckets = m.bucket_count();
+  EXPECT_GE(buckets * m.max_load_factor(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    m.insert(i, i);
+  }
+  EXPECT_EQ(m.bucket_count(), buckets);  // no rehash on the way
+
+  for (int i = 0; i < 990; ++i) {
+    m.erase(i);
+  }
+  m.shrink_to_fit();
+  EXPECT_EQ(m.bucket_count(), 14);  // ceil(10 / 0.75)
+  EXPECT_EQ(m[995], 995);
+
+  m.max_load_factor(4.0f);
+  for (int i = 0; i < 40; ++i) {  // 50 elements in 14 buckets
+    m.insert(i, i);
+  }
+  EXPECT_EQ(m.bucket_count(), 14);
+  m.max_load_factor(0.5f);  // grows at once
+  EXPECT_LE(m.load_factor(), 0.5f);
+  EXPECT_THROW(m.max_load_factor(0.0f), std::invalid_argument);
+
+  my::flat_unordered_map<int, int> flat;
+  flat.reserve(1000);
+  const size_t slots = flat.bucket_count();
+  for (int i = 0; i < 1000; ++i) {
+    flat.insert(i, i);
+  }
+  EXPECT_EQ(flat.bucket_count(), slots);
+  EXPECT_FLOAT_EQ(flat.max_load_factor(), 7.0f / 8.0f);
+}
+
+TEST(UnorderedMapTest, RangeCtorPresizes) {
+  std::vector<std::pair<int, int>> pairs;
+  for (int i = 0; i < 1000; ++i) {
+    pairs.emplace_back(i % 500, i);  // the first of a key wins
+  }
+  my::unordered_map<int, int> m(pairs.begin(), pairs.end());
+  EXPECT_EQ(m.size(), 500);
+  EXPECT_EQ(m.bucket_count(), 1334);  // ceil(1000 / 0.75), allocated once
+  EXPECT_EQ(m[7], 7);
+
+  my::flat_unordered_map<int, int> flat(pairs.begin(), pairs.end());
+  EXPECT_EQ(flat.size(), 500);
+  EXPECT_EQ(flat[7], 7);
+
+  const std::vector<int> values = {3, 1, 3, 2};
+  my::unordered_set<int> set(values.begin(), values.end());
+  EXPECT_EQ(set.size(), 3);
+}
+
 struct BadHash {
   size_t operator()(int) const { return 0; }
 };
@@ -129,4 +195,182 @@ TEST(UnorderedMapTest, Iterator) {
   }
 }
 
+namespace {
+
+/// counts the copies and moves of the mapped values
+struct Counted {
+  static inline int copies = 0;
+  static inline int moves = 0;
+
+  int value = 0;
+
+  Counted() = default;
+  explicit Counted(int v) : value(v) {}
+  Counted(const Counted& other) : value(other.value) { ++copies; }
+  Counted(Counted&& other) noexcept : value(other.value) { ++moves; }
+  Counted& operator=(const Counted&) = default;
+  Counted& operator=(Counted&&) = default;
+};
+
+}  // namespace
+
+TEST(UnorderedMapTest, EmplaceConstructsInPlace) {
+  Counted::copies = Counted::moves = 0;
+  my::unordered_map<std::string, Counted> m;
+
+  m["a"].value = 1;  // value-initialized in the node
+  m["a"].value += 1;
+  EXPECT_EQ(m["a"].value, 2);
+
+  auto [it, inserted] = m.try_emplace("b", 10);
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(it->second.value, 10);
+  EXPECT_FALSE(m.try_emplace("b", 20).second);
+  EXPECT_EQ(m["b"].value, 10);
+
+  EXPECT_TRUE(m.emplace("c", Counted(30)).second);  // one move into the node
+  EXPECT_FALSE(m.emplace("c", 40).second);
+  EXPECT_EQ(m["c"].value, 30);
+
+  m.insert("d", Counted(4));  // one move into the node
+  EXPECT_EQ(Counted::copies, 0);
+  EXPECT_EQ(Counted::moves, 2);
+
+  for (int i = 0; i < 100; ++i) {
+    m.try_emplace(std::to_string(i), i);
+  }
+  EXPECT_EQ(m.size(), 104);
+  EXPECT_EQ(m["42"].value, 42);
+  EXPECT_EQ(Counted::copies, 0);
+}
+
+TEST(UnorderedMapTest, PoolAllocatedNodes) {
+  using map = my::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                                my::pool_allocator<std::pair<const int, int>>>;
+  map m;
+  for (int i = 0; i < 1000; ++i) {
+    m[i] = i;
+  }
+  for (int i = 1000; i < 10000; ++i) {
+    m.erase(i - 1000);
+    m.insert(i, i);
+  }
+  EXPECT_EQ(m.size(), 1000);
+  for (int i = 9000; i < 10000; ++i) {
+    EXPECT_EQ(m.find(i)->second, i);
+  }
+}
+
+TEST(UnorderedMapTest, TransparentLookup) {
+  my::unordered_map<std::string, int, my::string_hash, std::equal_to<>> m;
+  for (int i = 0; i < 100; ++i) {
+    m[std::to_string(i)] = i;
+  }
+
+  const std::string_view key = "42";
+  EXPECT_EQ(m.find(key)->second, 42);
+  EXPECT_TRUE(m.contains(key));
+  EXPECT_EQ(m.count(std::string_view("100")), 0);
+  EXPECT_EQ(m.find("7")->second, 7);
+  m.erase(key);
+  EXPECT_FALSE(m.contains(key));
+  EXPECT_EQ(m.size(), 99);
+
+  my::flat_unordered_map<std::string, int, my::string_hash, std::equal_to<>> flat = {{"a", 1}, {"b", 2}};
+  EXPECT_EQ(flat.find(std::string_view("b"))->second, 2);
+  EXPECT_TRUE(flat.contains(std::string_view("a")));
+  flat.erase(std::string_view("a"));
+  EXPECT_EQ(flat.count(std::string_view("a")), 0);
+
+  my::unordered_set<std::string, my::string_hash, std::equal_to<>> s = {"x", "y"};
+  EXPECT_TRUE(s.contains(std::string_view("x")));
+  EXPECT_EQ(s.count(std::string_view("z")), 0);
+
+  auto nh = m.extract(std::string_view("7"));
+  ASSERT_FALSE(nh.empty());
+  EXPECT_EQ(nh.value().second, 7);
+  EXPECT_FALSE(m.contains(std::string_view("7")));
+  EXPECT_TRUE(m.extract(std::string_view("missing")).empty());
+  EXPECT_EQ(s.extract(std::string_view("y")).value(), "y");
+  EXPECT_EQ(s.size(), 1);
+}
+
+TEST(UnorderedMapTest, Batches) {
+  std::vector<std::pair<const int, int>> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.emplace_back(i * 2, i);
+  }
+  std::vector<int> keys;
+  for (int i = 0; i < 2000; ++i) {
+    keys.push_back(i);  // every other key is missing
+  }
+
+  my::unordered_map<int, int> m;
+  EXPECT_EQ(m.insert_batch(values.begin(), values.end()), 1000);
+  EXPECT_EQ(m.insert_batch(values.begin(), values.begin() + 10), 0);
+  EXPECT_EQ(m.size(), 1000);
+
+  std::vector<my::unordered_map<int, int>::iterator> found;
+  m.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), keys.size());
+  std::vector<bool> present(keys.size());
+  EXPECT_EQ(m.contains_batch(keys.begin(), keys.end(), present.begin()), present.end());
+  for (int k : keys) {
+    EXPECT_EQ(present[k], k % 2 == 0);
+    if (k % 2 == 0) {
+      ASSERT_NE(found[k], m.end());
+      EXPECT_EQ(found[k]->second, k / 2);
+    } else {
+      EXPECT_EQ(found[k], m.end());
+    }
+  }
+
+  my::flat_unordered_map<int, int> flat;
+  EXPECT_EQ(flat.insert_batch(values.begin(), values.end()), 1000);
+  std::vector<my::flat_unordered_map<int, int>::iterator> flat_found;
+  flat.find_batch(keys.begin(), keys.end(), std::back_inserter(flat_found));
+  flat.contains_batch(keys.begin(), keys.end(), present.begin());
+  for (int k : keys) {
+    EXPECT_EQ(present[k], k % 2 == 0);
+    EXPECT_EQ(flat_found[k] != flat.end(), k % 2 == 0);
+  }
+}
+
+template <class Map>
+concept has_node_handles = requires(Map& m) { m.extract(0); };
+
+TEST(UnorderedMapTest, NodeHandles) {
+  using map = my::unordered_map<int, std::string, std::hash<int>, std::equal_to<int>,
+                                my::pool_allocator<std::pair<const int, std::string>>>;
+  map hot;
+  for (int i = 0; i < 100; ++i) {
+    hot[i] = std::to_string(i);
+  }
+  map cold(hot);  // shares the node pool of hot: equal allocators
+  cold.erase(10);
+
+  auto nh = hot.extract(10);
+  nh.value().second = "ten";
+  EXPECT_TRUE(cold.insert(std::move(nh)).inserted);
+  EXPECT_EQ(cold.find(10)->second, "ten");
+  EXPECT_FALSE(hot.contains(10));
+
+  for (int i = 100; i < 200; ++i) {
+    hot[i] = std::to_string(i);
+  }
+  cold.merge(hot);
+  EXPECT_EQ(cold.size(), 200);
+  EXPECT_EQ(hot.size(), 99);  // the keys cold already had
+  EXPECT_EQ(cold.find(150)->second, "150");
+
+  my::unordered_set<int> s = {1, 2, 3};
+  my::unordered_set<int> t = {3, 4};
+  EXPECT_EQ(*s.insert(t.extract(4)).position, 4);
+  t.merge(s);
+  EXPECT_EQ(t.size(), 4);
+  EXPECT_EQ(s.size(), 1);
+
+  static_assert(has_node_handles<map> && !has_node_handles<my::flat_unordered_map<int, int>>);
+}
+
 }  // namespace my::testing
@@ -1,11 +1,81 @@
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
 #include "mystd/vector.hpp"
 
+namespace my::testing {
+struct Handle;
+}  // namespace my::testing
+
+template <>
+struct my::is_trivially_relocatable<my::testing::Handle> : std::true_type {};
+
 namespace my::testing {
 
 class Mock {};
 
+class NoDefault {
+ public:
+  explicit NoDefault(int v) : value(v) {}
+  int value;
+};
+
+struct Counted {
+  static inline int alive = 0;
+  int value = 0;
+
+  Counted(int v = 0) : value(v) { ++alive; }
+  Counted(const Counted& other) : value(other.value) { ++alive; }
+  Counted(Counted&& other) noexcept : value(other.value) { ++alive; }
+  ~Counted() { --alive; }
+};
+
+/// owns a heap int, opted in as trivially relocatable below
+struct Handle {
+  static inline int moves = 0;
+  int* p;
+
+  explicit Handle(int v) : p(new int(v)) {}
+  Handle(Handle&& other) noexcept : p(std::exchange(other.p, nullptr)) { ++moves; }
+  Handle& operator=(Handle&& other) noexcept {
+    std::swap(p, other.p);
+    ++moves;
+    return *this;
+  }
+  ~Handle() { delete p; }
+};
+
+struct ThrowingMove {
+  static inline int copies = 0;
+  int value = 0;
+
+  ThrowingMove(int v) : value(v) {}
+  ThrowingMove(const ThrowingMove& other) : value(other.value) { ++copies; }
+  ThrowingMove(ThrowingMove&& other) : value(other.value) {}
+};
+
+/// move assignment throws while fail is set
+struct ThrowingAssign {
+  static inline int alive = 0;
+  static inline bool fail = false;
+  int value = 0;
+
+  ThrowingAssign(int v) : value(v) { ++alive; }
+  ThrowingAssign(const ThrowingAssign& other) : value(other.value) { ++alive; }
+  ThrowingAssign(ThrowingAssign&& other) noexcept : value(other.value) { ++alive; }
+  ThrowingAssign& operator=(const ThrowingAssign&) = default;
+  ThrowingAssign& operator=(ThrowingAssign&& other) {
+    if (fail) throw std::runtime_error("move assignment");
+    value = other.value;
+    return *this;
+  }
+  ~ThrowingAssign() { --alive; }
+};
+
 TEST(VectorTest, DefaultConstructor) {
   vector<int, 3> a1;
   vector<float, 3> a2;
@@ -56,6 +126,284 @@ TEST(VectorTest, Reallocation) {
   EXPECT_EQ(v.capacity(), 100);
 }
 
+TEST(VectorTest, NonDefaultConstructible) {
+  vector<NoDefault, 2> v;
+  for (int i = 0; i < 10; ++i) {
+    v.push_back(NoDefault(i));
+  }
+  EXPECT_EQ(v.size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(v[i].value, i);
+  }
+}
+
+TEST(VectorTest, OnlyLiveRangeIsConstructed) {
+  {
+    vector<Counted, 100> v;
+    EXPECT_EQ(Counted::alive, 0);
+
+    for (int i = 0; i < 250; ++i) {
+      v.push_back(Counted(i));
+    }
+    EXPECT_EQ(Counted::alive, 250);
+
+    v.pop_back();
+    EXPECT_EQ(Counted::alive, 249);
+
+    vector<Counted, 100> copy(v);
+    EXPECT_EQ(Counted::alive, 2 * 249);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(VectorTest, GrowthCopiesWhenMoveMayThrow) {
+  ThrowingMove::copies = 0;
+  vector<ThrowingMove, 2> v;
+  v.push_back(ThrowingMove(1));
+  v.push_back(ThrowingMove(2));
+  const int copies_before = ThrowingMove::copies;
+
+  v.push_back(ThrowingMove(3));  // new element is moved in, two old elements are copied
+  EXPECT_EQ(ThrowingMove::copies - copies_before, 2);
+  EXPECT_EQ(v[0].value, 1);
+  EXPECT_EQ(v[2].value, 3);
+}
+
+TEST(VectorTest, PushBackOwnElementOnGrowth) {
+  vector<int, 2> v;
+  v.push_back(7);
+  v.push_back(8);
+  v.push_back(v[0]);
+  EXPECT_EQ(v[2], 7);
+}
+
+TEST(VectorTest, EmplaceBackAndMoveOnly) {
+  vector<std::unique_ptr<int>, 1> v;
+  for (int i = 0; i < 10; ++i) {
+    v.emplace_back(std::make_unique<int>(i));
+  }
+  auto p = std::make_unique<int>(10);
+  v.push_back(std::move(p));
+  EXPECT_EQ(p, nullptr);
+
+  EXPECT_EQ(v.size(), 11);
+  for (int i = 0; i < 11; ++i) {
+    EXPECT_EQ(*v[i], i);
+  }
+
+  vector<std::pair<int, std::string>> pairs;
+  auto& ref = pairs.emplace_back(1, "one");
+  EXPECT_EQ(ref.second, "one");
+  EXPECT_EQ(pairs.back().first, 1);
+}
+
+TEST(VectorTest, ReserveAndShrink) {
+  vector<int, 4> v;
+  v.reserve(100);
+  EXPECT_EQ(v.capacity(), 100);
+  v.reserve(10);
+  EXPECT_EQ(v.capacity(), 100);
+
+  for (int i = 0; i < 5; ++i) {
+    v.push_back(i);
+  }
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 5);
+  EXPECT_EQ(v[4], 4);
+
+  v.clear();
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 0);
+  v.push_back(42);
+  EXPECT_EQ(v.back(), 42);
+}
+
+TEST(VectorTest, Resize) {
+  vector<int, 2> v;
+  v.resize(5);
+  EXPECT_EQ(v.size(), 5);
+  for (auto el : v) {
+    EXPECT_EQ(el, 0);
+  }
+
+  v.resize(8, 7);
+  EXPECT_EQ(v.size(), 8);
+  EXPECT_EQ(v[4], 0);
+  EXPECT_EQ(v[7], 7);
+
+  v.resize(2);
+  EXPECT_EQ(v.size(), 2);
+
+  {
+    vector<Counted, 2> c;
+    c.resize(10, Counted(3));
+    EXPECT_EQ(Counted::alive, 10);
+    c.resize(4);
+    EXPECT_EQ(Counted::alive, 4);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(VectorTest, ResizeGrowsGeometrically) {
+  vector<std::string, 1> v;
+  int reallocations = 0;
+  for (int i = 0; i < 100000; ++i) {
+    const size_t capacity = v.capacity();
+    v.resize(v.size() + 1, "resized past the small string buffer");
+    reallocations += v.capacity() != capacity;
+  }
+  EXPECT_EQ(v.size(), 100000);
+  EXPECT_LE(reallocations, 20);
+  EXPECT_EQ(v.back(), "resized past the small string buffer");
+
+  const size_t jump = 4 * v.capacity();
+  v.resize(jump);  // past the next step: exactly what it needs
+  EXPECT_EQ(v.capacity(), jump);
+}
+
+TEST(VectorTest, EmplaceKeepsBasicGuaranteeWhenShiftThrows) {
+  {
+    vector<ThrowingAssign, 8> v;
+    for (int i = 0; i < 4; ++i) {
+      v.emplace_back(i);
+    }
+    ThrowingAssign::fail = true;
+    EXPECT_THROW(v.emplace(v.begin() + 1, 100), std::runtime_error);
+    ThrowingAssign::fail = false;
+    EXPECT_EQ(v.size(), 5);  // the new last element is part of the vector and gets destroyed with it
+    EXPECT_EQ(ThrowingAssign::alive, 5);
+  }
+  EXPECT_EQ(ThrowingAssign::alive, 0);
+}
+
+TEST(VectorTest, InsertAndErase) {
+  vector<int, 3> v = {1, 2, 4};
+
+  auto it = v.insert(v.begin() + 2, 3);
+  EXPECT_EQ(*it, 3);
+  EXPECT_EQ(v.size(), 4);
+
+  v.insert(v.begin(), 0);
+  v.insert(v.end(), 5);
+  v.emplace(v.begin() + 3, 100);
+  v.insert(v.begin(), v[1]);
+
+  vector<int> expected = {1, 0, 1, 2, 100, 3, 4, 5};
+  EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+  it = v.erase(v.begin() + 4);
+  EXPECT_EQ(*it, 3);
+  it = v.erase(v.begin(), v.begin() + 2);
+  EXPECT_EQ(*it, 1);
+
+  expected = {1, 2, 3, 4, 5};
+  EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+  vector<std::unique_ptr<int>> ptrs;
+  ptrs.push_back(std::make_unique<int>(2));
+  ptrs.insert(ptrs.begin(), std::make_unique<int>(1));
+  ptrs.erase(ptrs.begin());
+  EXPECT_EQ(ptrs.size(), 1);
+  EXPECT_EQ(*ptrs[0], 2);
+}
+
+TEST(VectorTest, GrowsAfterMove) {
+  vector<int> a = {1, 2, 3};
+  vector<int> b(std::move(a));
+  EXPECT_EQ(a.capacity(), 0);
+
+  a.push_back(4);
+  a.push_back(5);
+  EXPECT_EQ(a.size(), 2);
+  EXPECT_EQ(a[1], 5);
+}
+
+TEST(VectorTest, OneAndHalfGrowth) {
+  vector<int, 4, growth::one_and_half> v;
+  for (int i = 0; i < 5; ++i) {
+    v.push_back(i);
+  }
+  EXPECT_EQ(v.capacity(), 6);
+  for (int i = 5; i < 7; ++i) {
+    v.push_back(i);
+  }
+  EXPECT_EQ(v.capacity(), 9);
+
+  vector<int, 1, growth::one_and_half> tiny;
+  tiny.push_back(1);
+  tiny.push_back(2);  // 1 * 1.5 rounds down to 1, policy must still grow
+  EXPECT_EQ(tiny.capacity(), 2);
+}
+
+TEST(VectorTest, PageGranularGrowth) {
+  using policy = growth::page_granular;
+  vector<uint32_t, 16, policy> v;
+  const size_t n = 3 * policy::huge_page_size / sizeof(uint32_t);
+  for (size_t i = 0; i < n; ++i) {
+    v.push_back(static_cast<uint32_t>(i));
+  }
+  EXPECT_EQ(v.capacity() * sizeof(uint32_t) % policy::huge_page_size, 0);
+
+  v.insert(v.begin() + 1, v[5]);
+  v.insert(v.begin(), 42);
+  EXPECT_EQ(v[0], 42);
+  EXPECT_EQ(v[1], 0);
+  EXPECT_EQ(v[2], 5);
+  EXPECT_EQ(v[3], 1);
+  EXPECT_EQ(v.back(), n - 1);
+
+  v.resize(10);
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 10);
+  EXPECT_EQ(v[9], 7);
+
+  // an empty buffer is small, the first push must not round it up to a huge page
+  vector<int, 25, policy> moved_from;
+  vector<int, 25, policy> sink(std::move(moved_from));
+  moved_from.push_back(1);
+  EXPECT_EQ(moved_from.capacity(), 1);
+  vector<int, 0, policy> zero;
+  zero.push_back(1);
+  zero.push_back(2);
+  EXPECT_EQ(zero.capacity(), 2);
+
+  // non trivially copyable types take the usual allocator path
+  vector<std::string, 1, policy> strings;
+  for (int i = 0; i < 100; ++i) {
+    strings.emplace_back(std::to_string(i));
+  }
+  EXPECT_EQ(strings[99], "99");
+}
+
+TEST(VectorTest, TriviallyRelocatable) {
+  static_assert(is_trivially_relocatable_v<int>);
+  static_assert(is_trivially_relocatable_v<std::unique_ptr<int>>);
+  static_assert(!is_trivially_relocatable_v<std::string>);
+
+  Handle::moves = 0;
+  {
+    vector<Handle, 1> v;
+    for (int i = 0; i < 100; ++i) {
+      v.emplace_back(i);
+    }
+    EXPECT_EQ(Handle::moves, 0);  // growth relocates bytes
+
+    v.insert(v.begin() + 10, Handle(-1));  // only the new element is moved (through a temporary), the tail is memmoved
+    EXPECT_EQ(Handle::moves, 2);
+    v.erase(v.begin(), v.begin() + 5);
+    EXPECT_EQ(Handle::moves, 2);
+
+    EXPECT_EQ(v.size(), 96);
+    EXPECT_EQ(*v[4].p, 9);
+    EXPECT_EQ(*v[5].p, -1);
+    EXPECT_EQ(*v[6].p, 10);
+    EXPECT_EQ(*v.back().p, 99);
+
+    v.shrink_to_fit();
+    EXPECT_EQ(*v[95].p, 99);
+  }
+}
+
 TEST(VectorTest, Iterators) {
   vector<int, 3> a = {1, 2, 3};
   int i = 0;